@@ -13,6 +13,7 @@
 #include "control/jobs/SaveJob.h"
 #include "control/layer/LayerController.h"
 #include "control/pagetype/PageTypeHandler.h"
+#include "control/xojfile/SavedPageCache.h"
 #include "gui/PdfFloatingToolbox.h"
 #include "gui/TextEditor.h"
 #include "gui/XournalView.h"
@@ -82,12 +83,14 @@ Control::Control(GApplication* gtkApp, GladeSearchpath* gladeSearchPath): gtkApp
 
     this->pageTypes = new PageTypeHandler(gladeSearchPath);
     this->newPageType = std::make_unique<PageTypeMenu>(this->pageTypes, settings, true, true);
+    this->autosavePageCache = std::make_unique<SavedPageCache>();
 
     this->audioController = new AudioController(this->settings, this);
 
     this->scrollHandler = new ScrollHandler(this);
 
     this->scheduler = new XournalScheduler();
+    this->scheduler->setWorkerCount(this->settings->getSchedulerWorkerCount());
 
     this->doc = new Document(this);
 
@@ -215,6 +218,8 @@ void Control::renameLastAutosaveFile() {
 
 void Control::setLastAutosaveFile(fs::path newAutosaveFile) { this->lastAutosaveFilename = std::move(newAutosaveFile); }
 
+auto Control::getAutosavePageCache() -> SavedPageCache* { return this->autosavePageCache.get(); }
+
 void Control::deleteLastAutosaveFile(fs::path newAutosaveFile) {
     fs::remove(this->lastAutosaveFilename);
     this->lastAutosaveFilename = std::move(newAutosaveFile);
@@ -1081,9 +1086,9 @@ void Control::reorderSelection(const ActionType type) {
  * @return the page ID or size_t_npos if the page is not found
  */
 auto Control::firePageSelected(const PageRef& page) -> size_t {
-    this->doc->lock();
+    this->doc->lockShared();
     size_t pageId = this->doc->indexOf(page);
-    this->doc->unlock();
+    this->doc->unlockShared();
     if (pageId == npos) {
         return npos;
     }
@@ -1275,9 +1280,9 @@ void Control::deletePage() {
         return;
     }
 
-    this->doc->lock();
+    this->doc->lockShared();
     PageRef page = doc->getPage(pNr);
-    this->doc->unlock();
+    this->doc->unlockShared();
 
     // first send event, then delete page...
     firePageDeleted(pNr);
@@ -1320,9 +1325,9 @@ void Control::appendNewPdfPages() {
     }
     for (size_t i = 0; i != insertCount; ++i) {
 
-        doc->lock();
+        doc->lockShared();
         XojPdfPageSPtr pdf = doc->getPdfPage(currentPdfPageCount + i);
-        doc->unlock();
+        doc->unlockShared();
 
         if (pdf) {
             auto newPage = std::make_shared<XojPage>(pdf->getWidth(), pdf->getHeight());
@@ -1426,9 +1431,9 @@ void Control::paperFormat() {
 
 void Control::changePageBackgroundColor() {
     auto pNr = getCurrentPageNo();
-    this->doc->lock();
+    this->doc->lockShared();
     auto const& p = this->doc->getPage(pNr);
-    this->doc->unlock();
+    this->doc->unlockShared();
 
     if (!p) {
         return;
@@ -1676,9 +1681,9 @@ auto Control::searchTextOnPage(string text, int p, int* occures, double* top) ->
 }
 
 auto Control::getCurrentPage() -> PageRef {
-    this->doc->lock();
+    this->doc->lockShared();
     PageRef p = this->doc->getPage(getCurrentPageNo());
-    this->doc->unlock();
+    this->doc->unlockShared();
 
     return p;
 }
@@ -2041,6 +2046,8 @@ auto Control::openFile(fs::path filepath, int scrollToPage, bool forceOpen) -> b
     }
 
     LoadHandler loadHandler;
+    // Only the visible pages are built, the others when they are needed
+    loadHandler.setLazyPageLoading(true);
     Document* loadedDocument = loadHandler.loadDocument(filepath);
     if ((loadedDocument != nullptr && loadHandler.isAttachedPdfMissing()) ||
         !loadHandler.getMissingPdfFilename().empty()) {
@@ -2120,6 +2127,7 @@ auto Control::openFile(fs::path filepath, int scrollToPage, bool forceOpen) -> b
 
 auto Control::loadPdf(const fs::path& filepath, int scrollToPage) -> bool {
     LoadHandler loadHandler;
+    loadHandler.setScheduler(this->scheduler);
 
     if (settings->isAutoloadPdfXoj()) {
         Document* tmp;
@@ -2159,9 +2167,9 @@ auto Control::loadXoptTemplate(fs::path const& filepath) -> bool {
 }
 
 void Control::fileLoaded(int scrollToPage) {
-    this->doc->lock();
+    this->doc->lockShared();
     auto filepath = this->doc->getEvMetadataFilename();
-    this->doc->unlock();
+    this->doc->unlockShared();
 
     if (!filepath.empty()) {
         MetadataEntry md = MetadataManager::getForFile(filepath);
@@ -2250,15 +2258,15 @@ auto Control::annotatePdf(fs::path filepath, bool /*attachPdf*/, bool attachToDo
     if (res) {
         RecentManager::addRecentFileFilename(filepath.c_str());
 
-        this->doc->lock();
+        this->doc->lockShared();
         auto filepath = this->doc->getEvMetadataFilename();
-        this->doc->unlock();
+        this->doc->unlockShared();
         MetadataEntry md = MetadataManager::getForFile(filepath);
         loadMetadata(md);
     } else {
-        this->doc->lock();
+        this->doc->lockShared();
         string errMsg = doc->getLastErrorMsg();
-        this->doc->unlock();
+        this->doc->unlockShared();
 
         string msg = FS(_F("Error annotate PDF file \"{1}\"\n{2}") % filepath.u8string() % errMsg);
         XojMsgBox::showErrorToUser(getGtkWindow(), msg);
@@ -2273,9 +2281,12 @@ auto Control::annotatePdf(fs::path filepath, bool /*attachPdf*/, bool attachToDo
 }
 
 void Control::print() {
-    this->doc->lock();
-    PrintHandler::print(this->doc, getCurrentPageNo(), this->getGtkWindow());
-    this->doc->unlock();
+    // Print a snapshot, the document stays unlocked while the print dialog is open
+    this->doc->lockShared();
+    std::unique_ptr<Document> snapshot = this->doc->createSnapshot();
+    this->doc->unlockShared();
+
+    PrintHandler::print(snapshot.get(), getCurrentPageNo(), this->getGtkWindow());
 }
 
 void Control::block(const string& name) {
@@ -54,6 +54,7 @@ class PageTypeMenu;
 class BaseExportJob;
 class LayerController;
 class PluginController;
+class SavedPageCache;
 
 class Control:
         public ActionHandler,
@@ -231,6 +232,11 @@ public:
     void renameLastAutosaveFile();
     void setLastAutosaveFile(fs::path newAutosaveFile);
     void deleteLastAutosaveFile(fs::path newAutosaveFile);
+
+    /**
+     * The pages of the last autosave, only changed pages are serialized again
+     */
+    SavedPageCache* getAutosavePageCache();
     void setClipboardHandlerSelection(EditSelection* selection);
 
     MetadataManager* getMetadataManager();
@@ -392,6 +398,7 @@ private:
      */
     guint autosaveTimeout = 0;
     fs::path lastAutosaveFilename;
+    std::unique_ptr<SavedPageCache> autosavePageCache;
 
     XournalScheduler* scheduler;
 
@@ -1,9 +1,20 @@
 #include "PdfCache.h"
 
 #include <algorithm>
+#include <cmath>
 #include <cstdio>
+#include <iterator>
 #include <utility>
 
+#include "RenderStatistics.h"
+
+/**
+ * Count of zoom buckets per doubling of the zoom. A bucket spans about 9%,
+ * which is above the default re-render threshold, so a lookup only has to
+ * check the bucket of the zoom and its two neighbours.
+ */
+constexpr double ZOOM_BUCKETS_PER_OCTAVE = 8.0;
+
 class PdfCacheEntry {
 public:
     /**
@@ -21,8 +32,13 @@ public:
         this->popplerPage = std::move(popplerPage);
         this->rendered = img;
         this->zoom = zoom;
+        this->bytes = static_cast<size_t>(cairo_image_surface_get_stride(img)) *
+                      static_cast<size_t>(cairo_image_surface_get_height(img));
     }
 
+    PdfCacheEntry(const PdfCacheEntry&) = delete;
+    PdfCacheEntry& operator=(const PdfCacheEntry&) = delete;
+
     ~PdfCacheEntry() {
         this->popplerPage = nullptr;
         cairo_surface_destroy(this->rendered);
@@ -30,73 +46,174 @@ public:
     }
 
     double zoom;
+    size_t bytes;
     XojPdfPageSPtr popplerPage;
     cairo_surface_t* rendered;
 };
 
-PdfCache::PdfCache(int size) { this->size = size; }
-
-PdfCache::~PdfCache() {
-    clearCache();
-    this->size = 0;
-}
+PdfCache::PdfCache(int maxPages, size_t maxBytes):
+        maxPages(static_cast<size_t>(std::max(maxPages, 1))), maxBytes(maxBytes) {}
 
-void PdfCache::setZoom(double zoom) { this->zoom = zoom; }
+PdfCache::~PdfCache() { clearCache(); }
 
-void PdfCache::setRefreshThreshold(double threshold) { this->zoomRefreshThreshold = threshold; }
+void PdfCache::setRefreshThreshold(double threshold) {
+    std::lock_guard lock{this->cacheMutex};
+    this->zoomRefreshThreshold = threshold;
+}
 
-void PdfCache::setAnyZoomChangeCausesRecache(bool b) { this->zoomClearsCache = b; }
+void PdfCache::setAnyZoomChangeCausesRecache(bool b) {
+    std::lock_guard lock{this->cacheMutex};
+    this->zoomClearsCache = b;
+}
 
 void PdfCache::clearCache() {
-    for (PdfCacheEntry* e: this->data) { delete e; }
+    std::lock_guard lock{this->cacheMutex};
+    this->index.clear();
+    this->tiersPerPage.clear();
     this->data.clear();
+    this->usedBytes = 0;
+}
+
+auto PdfCache::makeKey(int pageId, int zoomBucket) -> Key {
+    return (static_cast<Key>(static_cast<uint32_t>(pageId)) << 32U) | static_cast<uint32_t>(zoomBucket);
+}
+
+auto PdfCache::zoomBucket(double zoom) -> int {
+    return static_cast<int>(std::lround(std::log2(zoom) * ZOOM_BUCKETS_PER_OCTAVE));
+}
+
+auto PdfCache::isAcceptable(double cachedZoom, double zoom) const -> bool {
+    if (this->zoomClearsCache) {
+        // Has the user requested that we **always** clear the cache on zoom?
+        return cachedZoom == zoom;
+    }
+
+    // Below 100% we always render at 100%, so there is no quality difference
+    if (zoom <= 1.0) {
+        return true;
+    }
+
+    // If we do have a cached result, is its rendering quality
+    // acceptable for our current zoom?
+    double averagedZoom = (zoom + cachedZoom) / 2.0;
+    double percentZoomChange = std::abs(cachedZoom - zoom) * 100.0 / averagedZoom;
+    return percentZoomChange <= this->zoomRefreshThreshold;
 }
 
-auto PdfCache::lookup(const XojPdfPageSPtr& popplerPage) -> PdfCacheEntry* {
-    for (PdfCacheEntry* e: this->data) {
-        if (e->popplerPage->getPageId() == popplerPage->getPageId()) {
-            return e;
+auto PdfCache::lookup(int pageId, double zoom, double& renderedZoom) -> cairo_surface_t* {
+    std::list<PdfCacheEntry>::iterator best = this->data.end();
+    double bestDifference = 0;
+
+    int bucket = zoomBucket(zoom);
+    for (int b = bucket - 1; b <= bucket + 1; b++) {
+        auto found = this->index.find(makeKey(pageId, b));
+        if (found == this->index.end()) {
+            continue;
+        }
+
+        auto it = found->second;
+        double difference = std::abs(it->zoom - zoom);
+        if (isAcceptable(it->zoom, zoom) && (best == this->data.end() || difference < bestDifference)) {
+            best = it;
+            bestDifference = difference;
         }
     }
 
-    return nullptr;
+    if (best == this->data.end()) {
+        return nullptr;
+    }
+
+    // Most recently used entries are kept at the front
+    this->data.splice(this->data.begin(), this->data, best);
+
+    renderedZoom = best->zoom;
+    return cairo_surface_reference(best->rendered);
 }
 
-PdfCacheEntry* PdfCache::cache(XojPdfPageSPtr popplerPage, cairo_surface_t* img, double zoom) {
-    while (this->data.size() > this->size) {
-        delete this->data.back();
-        this->data.pop_back();
+auto PdfCache::cache(XojPdfPageSPtr popplerPage, cairo_surface_t* img, double zoom) -> cairo_surface_t* {
+    int pageId = popplerPage->getPageId();
+    Key key = makeKey(pageId, zoomBucket(zoom));
+
+    auto found = this->index.find(key);
+    if (found != this->index.end()) {
+        // Replace the old rendering of this tier, it was not good enough for the current zoom
+        removeEntry(found->second);
     }
 
-    auto* ne = new PdfCacheEntry(std::move(popplerPage), img, zoom);
-    this->data.push_front(ne);
+    this->data.emplace_front(std::move(popplerPage), img, zoom);
+    this->index[key] = this->data.begin();
+    this->tiersPerPage[pageId]++;
+    this->usedBytes += this->data.front().bytes;
 
-    return ne;
+    cairo_surface_t* result = cairo_surface_reference(img);
+    evict();
+    return result;
 }
 
-void PdfCache::render(cairo_t* cr, const XojPdfPageSPtr& popplerPage, double zoom) {
-    this->renderMutex.lock();
+void PdfCache::removeEntry(std::list<PdfCacheEntry>::iterator it) {
+    int pageId = it->popplerPage->getPageId();
 
-    this->setZoom(zoom);
+    this->index.erase(makeKey(pageId, zoomBucket(it->zoom)));
 
-    PdfCacheEntry* cacheResult = lookup(popplerPage);
-    bool needsRefresh{cacheResult == nullptr};
+    auto tiers = this->tiersPerPage.find(pageId);
+    if (tiers != this->tiersPerPage.end() && --tiers->second <= 0) {
+        this->tiersPerPage.erase(tiers);
+    }
 
-    if (cacheResult != nullptr) {
-        double averagedZoom = (this->zoom + cacheResult->zoom) / 2.0;
-        double percentZoomChange = std::abs(cacheResult->zoom - this->zoom) * 100.0 / averagedZoom;
+    this->usedBytes -= it->bytes;
+    this->data.erase(it);
+}
 
-        // If we do have a cached result, is its rendering quality
-        // acceptable for our current zoom?
-        needsRefresh = this->zoom > 1.0 && percentZoomChange > this->zoomRefreshThreshold
+void PdfCache::evict() {
+    // The newest entry is always kept, even if it alone exceeds the budget
+    while (this->data.size() > 1 &&
+           (this->usedBytes > this->maxBytes || this->tiersPerPage.size() > this->maxPages)) {
+        removeEntry(std::prev(this->data.end()));
+    }
+}
 
-                       // Has the user requested that we **always** clear the cache on zoom?
-                       || this->zoomClearsCache && this->zoom != cacheResult->zoom;
+void PdfCache::render(cairo_t* cr, const XojPdfPageSPtr& popplerPage, double zoom) {
+    paint(cr, popplerPage, zoom, std::max(zoom, 1.0));
+}
+
+void PdfCache::renderPreview(cairo_t* cr, const XojPdfPageSPtr& popplerPage, double zoom) {
+    paint(cr, popplerPage, zoom, PREVIEW_ZOOM);
+}
+
+auto PdfCache::isRendered(const XojPdfPageSPtr& popplerPage, double zoom) -> bool {
+    double cachedZoom = 0;
+    std::lock_guard lock{this->cacheMutex};
+    cairo_surface_t* rendered = lookup(popplerPage->getPageId(), std::max(zoom, 1.0), cachedZoom);
+    bool found = rendered != nullptr;
+    cairo_surface_destroy(rendered);
+    return found;
+}
+
+void PdfCache::paint(cairo_t* cr, const XojPdfPageSPtr& popplerPage, double zoom, double renderZoom) {
+    int pageId = popplerPage->getPageId();
+    Key key = makeKey(pageId, zoomBucket(renderZoom));
+    double cachedZoom = renderZoom;
+
+    cairo_surface_t* rendered = nullptr;
+    {
+        std::unique_lock lock{this->cacheMutex};
+        rendered = lookup(pageId, renderZoom, cachedZoom);
+        // Another thread is rendering this page at this zoom, wait for it instead of rendering it again
+        while (rendered == nullptr && this->rendering.count(key)) {
+            this->renderFinished.wait(lock);
+            rendered = lookup(pageId, renderZoom, cachedZoom);
+        }
+        if (rendered == nullptr) {
+            this->rendering.insert(key);
+        }
     }
+    RenderStatistics::getInstance().countPdfCache(rendered != nullptr);
 
-    if (needsRefresh) {
-        double renderZoom = std::max(zoom, 1.0);
+    if (rendered == nullptr) {
+        RenderStatistics::Scope statistics("pdf", "PdfRender");
+        statistics.addArg("pdfPage", popplerPage->getPageId());
 
+        // Render without holding the lock, other threads may use the cache meanwhile
         auto* img = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, popplerPage->getWidth() * renderZoom,
                                                popplerPage->getHeight() * renderZoom);
         cairo_t* cr2 = cairo_create(img);
@@ -105,21 +222,27 @@ void PdfCache::render(cairo_t* cr, const XojPdfPageSPtr& popplerPage, double zoo
         popplerPage->render(cr2, false);
         cairo_destroy(cr2);
 
-        cacheResult = cache(popplerPage, img, renderZoom);
+        {
+            std::lock_guard lock{this->cacheMutex};
+            rendered = cache(popplerPage, img, renderZoom);
+            cachedZoom = renderZoom;
+            this->rendering.erase(key);
+        }
+        this->renderFinished.notify_all();
     }
 
     cairo_matrix_t mOriginal;
     cairo_matrix_t mScaled;
     cairo_get_matrix(cr, &mOriginal);
     cairo_get_matrix(cr, &mScaled);
-    mScaled.xx = this->zoom / cacheResult->zoom;
-    mScaled.yy = this->zoom / cacheResult->zoom;
+    mScaled.xx = zoom / cachedZoom;
+    mScaled.yy = zoom / cachedZoom;
     mScaled.xy = 0;
     mScaled.yx = 0;
     cairo_set_matrix(cr, &mScaled);
-    cairo_set_source_surface(cr, cacheResult->rendered, 0, 0);
+    cairo_set_source_surface(cr, rendered, 0, 0);
     cairo_paint(cr);
     cairo_set_matrix(cr, &mOriginal);
 
-    this->renderMutex.unlock();
+    cairo_surface_destroy(rendered);
 }
@@ -11,9 +11,13 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <cstdint>
 #include <list>
 #include <mutex>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include <cairo.h>
@@ -24,9 +28,26 @@
 
 class PdfCacheEntry;
 
+/**
+ * Caches rendered PDF pages.
+ *
+ * Each page may be cached at several zoom levels ("tiers"), so zooming back to a previous
+ * zoom level reuses the old rendering. Entries are found by (page id, zoom bucket) in constant
+ * time and are evicted in least recently used order as soon as the memory budget or the
+ * maximum number of pages is exceeded.
+ *
+ * The cache is only locked for lookup and insertion, pages are rasterized without holding
+ * the lock. The PDF backend serializes the rasterization of pages of the same document.
+ * A page which is being rendered is not rendered a second time: other threads which need
+ * it wait for the rendering instead.
+ */
 class PdfCache {
 public:
-    PdfCache(int size);
+    /**
+     * @param maxPages the maximum count of different pages which are cached
+     * @param maxBytes the maximum memory used by all cached renderings
+     */
+    PdfCache(int maxPages, size_t maxBytes);
     virtual ~PdfCache();
 
 private:
@@ -35,8 +56,25 @@ private:
 
 public:
     void render(cairo_t* cr, const XojPdfPageSPtr& popplerPage, double zoom);
+
+    /**
+     * Paints a low resolution rendering of the page, which is a lot cheaper to create than the
+     * rendering for the zoom. It is shown until the page is rendered with render().
+     */
+    void renderPreview(cairo_t* cr, const XojPdfPageSPtr& popplerPage, double zoom);
+
+    /**
+     * @return true if render() can paint the page at this zoom from the cache
+     */
+    bool isRendered(const XojPdfPageSPtr& popplerPage, double zoom);
+
     void clearCache();
 
+    /**
+     * The zoom of the previews, independent of the current zoom
+     */
+    static constexpr double PREVIEW_ZOOM = 0.5;
+
 public:
     /**
      * @param b true iff any change in the view's zoom as compared to when a page
@@ -54,17 +92,75 @@ public:
     void setRefreshThreshold(double percentDifference);
 
 private:
-    void setZoom(double zoom);
-    PdfCacheEntry* lookup(const XojPdfPageSPtr& popplerPage);
-    PdfCacheEntry* cache(XojPdfPageSPtr popplerPage, cairo_surface_t* img, double zoom);
+    using Key = uint64_t;
+
+    static Key makeKey(int pageId, int zoomBucket);
+    static int zoomBucket(double zoom);
+
+    /**
+     * @return true if a rendering made at cachedZoom can be used at zoom
+     */
+    bool isAcceptable(double cachedZoom, double zoom) const;
+
+    /**
+     * Finds the best rendering of the page for the given zoom, and marks it as recently used.
+     * The returned surface has to be released with cairo_surface_destroy
+     *
+     * @return The rendering and the zoom it was rendered at, or nullptr if there is none
+     */
+    cairo_surface_t* lookup(int pageId, double zoom, double& renderedZoom);
+
+    /**
+     * Adds a rendering to the cache and evicts the least recently used entries if needed.
+     * An older rendering of the same zoom tier is replaced.
+     *
+     * @return The cached surface, which has to be released with cairo_surface_destroy
+     */
+    cairo_surface_t* cache(XojPdfPageSPtr popplerPage, cairo_surface_t* img, double zoom);
+
+    void evict();
+
+    /**
+     * Paints the rendering of the page made at renderZoom, it is rendered if it is not cached
+     */
+    void paint(cairo_t* cr, const XojPdfPageSPtr& popplerPage, double zoom, double renderZoom);
+    void removeEntry(std::list<PdfCacheEntry>::iterator it);
 
 private:
-    std::mutex renderMutex;
+    /**
+     * Guards the members below, it is not held while a page is rasterized
+     */
+    std::mutex cacheMutex;
+
+    /**
+     * (page id, zoom bucket) of the pages being rendered
+     */
+    std::unordered_set<Key> rendering;
+
+    /**
+     * Notified when a page of rendering is done
+     */
+    std::condition_variable renderFinished;
+
+    /**
+     * All entries, the most recently used first
+     */
+    std::list<PdfCacheEntry> data;
+
+    /**
+     * (page id, zoom bucket) -> entry
+     */
+    std::unordered_map<Key, std::list<PdfCacheEntry>::iterator> index;
+
+    /**
+     * page id -> count of cached zoom tiers of this page
+     */
+    std::unordered_map<int, int> tiersPerPage;
 
-    std::list<PdfCacheEntry*> data;
-    std::list<PdfCacheEntry*>::size_type size = 0;
+    size_t maxPages = 0;
+    size_t maxBytes = 0;
+    size_t usedBytes = 0;
 
-    double zoom = -1;
-    double zoomRefreshThreshold;
+    double zoomRefreshThreshold = 0;
     bool zoomClearsCache = true;
 };
@@ -0,0 +1,216 @@
+#include "RenderStatistics.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+
+void RenderStatistics::Timing::add(int64_t duration) {
+    this->count++;
+    this->total += duration;
+    this->max = std::max(this->max, duration);
+    this->last = duration;
+}
+
+auto RenderStatistics::Timing::average() const -> double {
+    return this->count == 0 ? 0 : static_cast<double>(this->total) / static_cast<double>(this->count);
+}
+
+RenderStatistics::Scope::Scope(const char* category, const char* name): category(category), name(name) {
+    if (RenderStatistics::getInstance().isEnabled()) {
+        this->start = RenderStatistics::now();
+    }
+}
+
+RenderStatistics::Scope::~Scope() {
+    if (this->start >= 0) {
+        RenderStatistics::getInstance().addEvent(this->category, this->name, this->start,
+                                                 RenderStatistics::now() - this->start, this->args);
+    }
+}
+
+auto RenderStatistics::Scope::isActive() const -> bool { return this->start >= 0; }
+
+void RenderStatistics::Scope::addArg(const char* key, int64_t value) {
+    if (this->start >= 0) {
+        this->args.emplace_back(key, value);
+    }
+}
+
+auto RenderStatistics::getInstance() -> RenderStatistics& {
+    static RenderStatistics instance;
+    return instance;
+}
+
+auto RenderStatistics::now() -> int64_t {
+    using namespace std::chrono;
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+void RenderStatistics::updateEnabled() { this->enabled = this->hudVisible || this->tracing; }
+
+void RenderStatistics::setHudVisible(bool visible) {
+    this->hudVisible = visible;
+    updateEnabled();
+}
+
+auto RenderStatistics::isHudVisible() const -> bool { return this->hudVisible; }
+
+void RenderStatistics::startTrace() {
+    {
+        std::lock_guard lock{this->mutex};
+        this->trace.clear();
+        this->threads.clear();
+        this->traceStart = now();
+    }
+    this->tracing = true;
+    updateEnabled();
+}
+
+auto RenderStatistics::isTracing() const -> bool { return this->tracing; }
+
+void RenderStatistics::writeEvent(std::ostream& out, const TraceEvent& event, int64_t origin) {
+    // The names are string literals of the instrumented code, they do not need to be escaped
+    out << R"({"name":")" << event.name << R"(","cat":")" << event.category << R"(","ph":")" << event.phase
+        << R"(","ts":)" << (event.start - origin) << R"(,"pid":1,"tid":)" << event.thread;
+    if (event.phase == 'X') {
+        out << R"(,"dur":)" << event.duration;
+    }
+    if (!event.args.empty()) {
+        out << R"(,"args":{)";
+        for (size_t i = 0; i < event.args.size(); i++) {
+            out << (i == 0 ? "" : ",") << '"' << event.args[i].first << "\":" << event.args[i].second;
+        }
+        out << '}';
+    }
+    out << '}';
+}
+
+void RenderStatistics::writeTrace(std::ostream& out) {
+    this->tracing = false;
+    updateEnabled();
+
+    std::lock_guard lock{this->mutex};
+    out << "{\"traceEvents\":[\n";
+    for (size_t i = 0; i < this->trace.size(); i++) {
+        writeEvent(out, this->trace[i], this->traceStart);
+        out << (i + 1 < this->trace.size() ? ",\n" : "\n");
+    }
+    out << "],\"displayTimeUnit\":\"ms\"}\n";
+    this->trace.clear();
+}
+
+auto RenderStatistics::writeTrace(const std::string& filename) -> bool {
+    std::ofstream out(filename);
+    writeTrace(out);
+    out.close();
+    return !out.fail();
+}
+
+auto RenderStatistics::getSummary() const -> Summary {
+    Summary summary;
+    summary.pdfCacheHits = this->pdfCacheHits;
+    summary.pdfCacheMisses = this->pdfCacheMisses;
+    summary.elementsDrawn = this->elementsDrawn;
+    summary.elementsCulled = this->elementsCulled;
+
+    std::lock_guard lock{this->mutex};
+    summary.timings = this->timings;
+    summary.inputLatency = this->inputLatency;
+
+    int64_t second = now() - 1000000;
+    summary.framesPerSecond = static_cast<size_t>(std::count_if(this->recentFrames.begin(), this->recentFrames.end(),
+                                                                [second](int64_t start) { return start >= second; }));
+    return summary;
+}
+
+void RenderStatistics::reset() {
+    this->pdfCacheHits = 0;
+    this->pdfCacheMisses = 0;
+    this->elementsDrawn = 0;
+    this->elementsCulled = 0;
+    this->pendingInput = 0;
+
+    std::lock_guard lock{this->mutex};
+    this->timings.clear();
+    this->inputLatency = Timing{};
+    this->recentFrames.clear();
+}
+
+auto RenderStatistics::threadNumber(std::thread::id id) -> int {
+    auto it = this->threads.find(id);
+    if (it == this->threads.end()) {
+        it = this->threads.emplace(id, static_cast<int>(this->threads.size()) + 1).first;
+    }
+    return it->second;
+}
+
+void RenderStatistics::addTraceEvent(TraceEvent event) {
+    if (!this->tracing || this->trace.size() >= MAX_TRACE_EVENTS) {
+        return;
+    }
+    event.thread = threadNumber(std::this_thread::get_id());
+    this->trace.push_back(std::move(event));
+}
+
+void RenderStatistics::addEvent(const char* category, const char* name, int64_t start, int64_t duration,
+                                const std::vector<std::pair<const char*, int64_t>>& args) {
+    if (!isEnabled()) {
+        return;
+    }
+
+    std::lock_guard lock{this->mutex};
+    this->timings[name].add(duration);
+    addTraceEvent({category, name, 'X', start, duration, 0, args});
+}
+
+void RenderStatistics::countPdfCache(bool hit) {
+    if (isEnabled()) {
+        (hit ? this->pdfCacheHits : this->pdfCacheMisses).fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void RenderStatistics::countElements(size_t drawn, size_t culled) {
+    if (isEnabled()) {
+        this->elementsDrawn.fetch_add(drawn, std::memory_order_relaxed);
+        this->elementsCulled.fetch_add(culled, std::memory_order_relaxed);
+    }
+}
+
+void RenderStatistics::inputReceived() {
+    if (isEnabled()) {
+        int64_t none = 0;
+        this->pendingInput.compare_exchange_strong(none, now());
+    }
+}
+
+void RenderStatistics::framePainted(int64_t start, int64_t duration) {
+    if (!isEnabled()) {
+        return;
+    }
+
+    int64_t input = this->pendingInput.exchange(0);
+    int64_t end = start + duration;
+
+    std::lock_guard lock{this->mutex};
+    this->timings["Frame"].add(duration);
+    addTraceEvent({"gui", "Frame", 'X', start, duration, 0, {}});
+
+    if (input != 0 && end - input <= MAX_INPUT_LATENCY) {
+        this->inputLatency.add(end - input);
+        addTraceEvent({"gui", "InputLatency", 'X', input, end - input, 0, {}});
+    }
+
+    // The counters are shown as graphs in the trace
+    addTraceEvent({"gui", "PdfCache", 'C', end, 0, 0,
+                   {{"hits", static_cast<int64_t>(this->pdfCacheHits.load())},
+                    {"misses", static_cast<int64_t>(this->pdfCacheMisses.load())}}});
+    addTraceEvent({"gui", "Elements", 'C', end, 0, 0,
+                   {{"drawn", static_cast<int64_t>(this->elementsDrawn.load())},
+                    {"culled", static_cast<int64_t>(this->elementsCulled.load())}}});
+
+    int64_t second = end - 1000000;
+    this->recentFrames.erase(std::remove_if(this->recentFrames.begin(), this->recentFrames.end(),
+                                            [second](int64_t frame) { return frame < second; }),
+                             this->recentFrames.end());
+    this->recentFrames.push_back(start);
+}
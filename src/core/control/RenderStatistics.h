@@ -0,0 +1,223 @@
+/*
+ * Xournal++
+ *
+ * Timings and counters of the render path
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * Collects where the time of the render path goes: the jobs of the scheduler, the render jobs of the pages,
+ * the frames painted by the widget and the latency from an input event to the next frame, along with the
+ * hits and misses of the PDF cache and the count of drawn and culled elements.
+ *
+ * The statistics are shown by an overlay (see isHudVisible()) and can be recorded as a trace in the
+ * Chrome trace event format, which can be opened by chrome://tracing or https://ui.perfetto.dev.
+ *
+ * Everything is disabled by default, the instrumented code only checks isEnabled() then.
+ * All methods may be called from any thread.
+ */
+class RenderStatistics {
+public:
+    /**
+     * Durations of one kind of event, in microseconds
+     */
+    struct Timing {
+        uint64_t count = 0;
+        int64_t total = 0;
+        int64_t max = 0;
+        int64_t last = 0;
+
+        void add(int64_t duration);
+        double average() const;
+    };
+
+    /**
+     * All statistics since they were enabled or reset
+     */
+    struct Summary {
+        /**
+         * Per event name, e.g. "RenderJob" or "Frame"
+         */
+        std::map<std::string, Timing> timings;
+
+        Timing inputLatency;
+
+        /**
+         * Frames painted within the last second
+         */
+        size_t framesPerSecond = 0;
+
+        uint64_t pdfCacheHits = 0;
+        uint64_t pdfCacheMisses = 0;
+        uint64_t elementsDrawn = 0;
+        uint64_t elementsCulled = 0;
+    };
+
+    /**
+     * Measures the time until it is destroyed, and adds it as event
+     */
+    class Scope {
+    public:
+        Scope(const char* category, const char* name);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        /**
+         * @return false if the statistics are disabled, nothing is recorded then
+         */
+        bool isActive() const;
+
+        /**
+         * Adds an argument to the trace event, e.g. the page number
+         */
+        void addArg(const char* key, int64_t value);
+
+    private:
+        const char* category;
+        const char* name;
+        int64_t start = -1;
+        std::vector<std::pair<const char*, int64_t>> args;
+    };
+
+    /**
+     * More events are not recorded in a trace (about 100 MiB)
+     */
+    static constexpr size_t MAX_TRACE_EVENTS = 1000000;
+
+    /**
+     * Input which was not followed by a frame within this time (in microseconds) did not change the view,
+     * it is not counted as input latency
+     */
+    static constexpr int64_t MAX_INPUT_LATENCY = 1000000;
+
+public:
+    RenderStatistics() = default;
+    RenderStatistics(const RenderStatistics&) = delete;
+    RenderStatistics& operator=(const RenderStatistics&) = delete;
+
+    static RenderStatistics& getInstance();
+
+    /**
+     * @return A monotonic time in microseconds
+     */
+    static int64_t now();
+
+public:
+    bool isEnabled() const { return this->enabled.load(std::memory_order_relaxed); }
+
+    void setHudVisible(bool visible);
+    bool isHudVisible() const;
+
+    /**
+     * Starts recording a trace, the recorded events are dropped
+     */
+    void startTrace();
+    bool isTracing() const;
+
+    /**
+     * Stops recording and writes the trace as JSON
+     */
+    void writeTrace(std::ostream& out);
+
+    /**
+     * Stops recording and writes the trace to a file
+     *
+     * @return false if the file could not be written
+     */
+    bool writeTrace(const std::string& filename);
+
+    Summary getSummary() const;
+    void reset();
+
+public:
+    /**
+     * Adds a duration, starting at start (see now())
+     */
+    void addEvent(const char* category, const char* name, int64_t start, int64_t duration,
+                  const std::vector<std::pair<const char*, int64_t>>& args = {});
+
+    void countPdfCache(bool hit);
+    void countElements(size_t drawn, size_t culled);
+
+    /**
+     * An input event was received, the next frame measures the latency
+     */
+    void inputReceived();
+
+    /**
+     * The widget painted a frame
+     */
+    void framePainted(int64_t start, int64_t duration);
+
+private:
+    struct TraceEvent {
+        const char* category;
+        const char* name;
+        char phase;
+        int64_t start;
+        int64_t duration;
+        int thread;
+        std::vector<std::pair<const char*, int64_t>> args;
+    };
+
+    void updateEnabled();
+
+    /**
+     * @return A small number per thread, for the trace. Requires the lock.
+     */
+    int threadNumber(std::thread::id id);
+
+    void addTraceEvent(TraceEvent event);
+
+    static void writeEvent(std::ostream& out, const TraceEvent& event, int64_t origin);
+
+private:
+    std::atomic<bool> enabled{false};
+    std::atomic<bool> hudVisible{false};
+    std::atomic<bool> tracing{false};
+
+    std::atomic<uint64_t> pdfCacheHits{0};
+    std::atomic<uint64_t> pdfCacheMisses{0};
+    std::atomic<uint64_t> elementsDrawn{0};
+    std::atomic<uint64_t> elementsCulled{0};
+
+    /**
+     * The first input event which was not followed by a frame yet, 0 if there is none
+     */
+    std::atomic<int64_t> pendingInput{0};
+
+    /**
+     * Guards the members below
+     */
+    mutable std::mutex mutex;
+
+    std::map<std::string, Timing> timings;
+    Timing inputLatency;
+
+    /**
+     * The start of the frames within the last second
+     */
+    std::vector<int64_t> recentFrames;
+
+    std::vector<TraceEvent> trace;
+    int64_t traceStart = 0;
+    std::map<std::thread::id, int> threads;
+};
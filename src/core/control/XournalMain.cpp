@@ -7,6 +7,7 @@
 #include <gtk/gtk.h>
 #include <libintl.h>
 
+#include "control/jobs/Scheduler.h"
 #include "control/xojfile/LoadHandler.h"
 #include "gui/GladeSearchpath.h"
 #include "gui/MainWindow.h"
@@ -19,6 +20,7 @@
 
 #include "Control.h"
 #include "ExportHelper.h"
+#include "RenderStatistics.h"
 #include "config-dev.h"
 #include "config-git.h"
 #include "config-paths.h"
@@ -235,8 +237,13 @@ void checkForEmergencySave(Control* control) {
  */
 auto exportImg(const char* input, const char* output, const char* range, int pngDpi, int pngWidth, int pngHeight,
                ExportBackgroundType exportBackground) -> int {
-    LoadHandler loader;
+    // The pages are parsed on all cores
+    Scheduler scheduler;
+    scheduler.setWorkerCount(0);
+    scheduler.start();
 
+    LoadHandler loader;
+    loader.setScheduler(&scheduler);
     Document* doc = loader.loadDocument(input);
     if (doc == nullptr) {
         g_error("%s", loader.getLastError().c_str());
@@ -258,8 +265,13 @@ auto exportImg(const char* input, const char* output, const char* range, int png
  */
 auto exportPdf(const char* input, const char* output, const char* range, ExportBackgroundType exportBackground,
                bool progressiveMode) -> int {
-    LoadHandler loader;
+    // The pages are parsed on all cores
+    Scheduler scheduler;
+    scheduler.setWorkerCount(0);
+    scheduler.start();
 
+    LoadHandler loader;
+    loader.setScheduler(&scheduler);
     Document* doc = loader.loadDocument(input);
     if (doc == nullptr) {
         g_error("%s", loader.getLastError().c_str());
@@ -278,6 +290,7 @@ struct XournalMainPrivate {
         g_strfreev(optFilename);
         g_free(pdfFilename);
         g_free(imgFilename);
+        g_free(renderTrace);
     }
 
     gchar** optFilename{};
@@ -292,6 +305,8 @@ struct XournalMainPrivate {
     gboolean exportNoBackground = false;
     gboolean exportNoRuling = false;
     gboolean progressiveMode = false;
+    gboolean renderStatistics = false;
+    gchar* renderTrace{};
     std::unique_ptr<GladeSearchpath> gladePath;
     std::unique_ptr<Control> control;
     std::unique_ptr<MainWindow> win;
@@ -490,19 +505,34 @@ auto on_handle_local_options(GApplication*, GVariantDict*, XMPtr app_data) -> gi
         return 0;
     }
 
+    RenderStatistics::getInstance().setHudVisible(app_data->renderStatistics);
+    if (app_data->renderTrace) {
+        RenderStatistics::getInstance().startTrace();
+    }
+
+    // Exports do not start the application, the trace is written once they are done
+    auto writeTrace = [app_data](int result) {
+        if (app_data->renderTrace && !RenderStatistics::getInstance().writeTrace(app_data->renderTrace)) {
+            g_warning("Could not write the render trace to %s", app_data->renderTrace);
+        }
+        return result;
+    };
+
     if (app_data->pdfFilename && app_data->optFilename && *app_data->optFilename) {
-        return exportPdf(*app_data->optFilename, app_data->pdfFilename, app_data->exportRange,
-                         app_data->exportNoBackground ? EXPORT_BACKGROUND_NONE :
-                         app_data->exportNoRuling     ? EXPORT_BACKGROUND_UNRULED :
-                                                        EXPORT_BACKGROUND_ALL,
-                         app_data->progressiveMode);
+        int result = exportPdf(*app_data->optFilename, app_data->pdfFilename, app_data->exportRange,
+                               app_data->exportNoBackground ? EXPORT_BACKGROUND_NONE :
+                               app_data->exportNoRuling     ? EXPORT_BACKGROUND_UNRULED :
+                                                              EXPORT_BACKGROUND_ALL,
+                               app_data->progressiveMode);
+        return writeTrace(result);
     }
     if (app_data->imgFilename && app_data->optFilename && *app_data->optFilename) {
-        return exportImg(*app_data->optFilename, app_data->imgFilename, app_data->exportRange, app_data->exportPngDpi,
-                         app_data->exportPngWidth, app_data->exportPngHeight,
-                         app_data->exportNoBackground ? EXPORT_BACKGROUND_NONE :
-                         app_data->exportNoRuling     ? EXPORT_BACKGROUND_UNRULED :
-                                                        EXPORT_BACKGROUND_ALL);
+        int result = exportImg(*app_data->optFilename, app_data->imgFilename, app_data->exportRange,
+                               app_data->exportPngDpi, app_data->exportPngWidth, app_data->exportPngHeight,
+                               app_data->exportNoBackground ? EXPORT_BACKGROUND_NONE :
+                               app_data->exportNoRuling     ? EXPORT_BACKGROUND_UNRULED :
+                                                              EXPORT_BACKGROUND_ALL);
+        return writeTrace(result);
     }
     return -1;
 }
@@ -511,6 +541,10 @@ void on_shutdown(GApplication*, XMPtr app_data) {
     app_data->control->saveSettings();
     app_data->win->getXournal()->clearSelection();
     app_data->control->getScheduler()->stop();
+
+    if (app_data->renderTrace && !RenderStatistics::getInstance().writeTrace(app_data->renderTrace)) {
+        g_warning("Could not write the render trace to %s", app_data->renderTrace);
+    }
 }
 
 }  // namespace
@@ -532,6 +566,12 @@ auto XournalMain::run(int argc, char** argv) -> int {
                                        "<input>", nullptr},
                           GOptionEntry{"version", 0, 0, G_OPTION_ARG_NONE, &app_data.showVersion,
                                        _("Get version of xournalpp"), nullptr},
+                          GOptionEntry{"render-statistics", 0, 0, G_OPTION_ARG_NONE, &app_data.renderStatistics,
+                                       _("Show the render timings in an overlay"), nullptr},
+                          GOptionEntry{"render-trace", 0, 0, G_OPTION_ARG_FILENAME, &app_data.renderTrace,
+                                       _("Record the render timings and write them to FILE on exit\n"
+                                         "                                 in the Chrome trace format"),
+                                       "FILE"},
                           GOptionEntry{nullptr}};  // Must be terminated by a nullptr. See gtk doc
     g_application_add_main_option_entries(G_APPLICATION(app), options.data());
 
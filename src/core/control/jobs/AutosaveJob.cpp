@@ -19,15 +19,21 @@ void AutosaveJob::afterRun() {
 
 void AutosaveJob::run() {
     SaveHandler handler;
+    // Autosave runs often, prefer speed over file size
+    handler.setCompressionLevel(Z_BEST_SPEED);
+    // Only serialize the pages changed since the last autosave
+    handler.setPageCache(control->getAutosavePageCache());
 
     control->getUndoRedoHandler()->documentAutosaved();
 
     Document* doc = control->getDocument();
 
-    doc->lock();
-    handler.prepareSave(doc);
+    doc->lockShared();
+    // The pages which are taken from the page cache are copied without their layers
+    std::unique_ptr<Document> snapshot = handler.createSnapshot(doc);
+    handler.prepareSave(snapshot.get());
     auto filepath = doc->getFilepath();
-    doc->unlock();
+    doc->unlockShared();
 
     if (filepath.empty()) {
         filepath = Util::getAutosaveFilepath();
@@ -41,7 +47,9 @@ void AutosaveJob::run() {
 
     g_message("%s", FS(_F("Autosaving to {1}") % filepath.string()).c_str());
 
+    // The user can continue editing while the snapshot is written
     handler.saveTo(filepath);
+    snapshot.reset();
 
     this->error = handler.getErrorMessage();
     if (!this->error.empty()) {
@@ -101,7 +101,12 @@ auto CustomExportJob::showFilechooser() -> bool {
  * Create one Graphics file per page
  */
 void CustomExportJob::exportGraphics() {
-    ImageExport imgExport(control->getDocument(), filepath, format, exportBackground, exportRange);
+    Document* doc = control->getDocument();
+    doc->lockShared();
+    std::unique_ptr<Document> snapshot = doc->createSnapshot();
+    doc->unlockShared();
+
+    ImageExport imgExport(snapshot.get(), filepath, format, exportBackground, exportRange);
     if (format == EXPORT_GRAPHICS_PNG) {
         imgExport.setQualityParameter(pngQualityParameter);
     }
@@ -115,10 +120,12 @@ void CustomExportJob::run() {
         Document* doc = this->control->getDocument();
 
         XojExportHandler h;
-        doc->lock();
-        h.prepareSave(doc);
+        doc->lockShared();
+        std::unique_ptr<Document> snapshot = doc->createSnapshot();
+        h.prepareSave(snapshot.get());
+        doc->unlockShared();
+
         h.saveTo(filepath, this->control);
-        doc->unlock();
 
         if (!h.getErrorMessage().empty()) {
             this->lastError = FS(_F("Save file error: {1}") % h.getErrorMessage());
@@ -126,11 +133,13 @@ void CustomExportJob::run() {
             callAfterRun();
         }
     } else if (format == EXPORT_GRAPHICS_PDF) {
-        // don't lock the page here for the whole flow, else we get a dead lock...
-        // the ui is blocked, so there should be no changes...
+        // Export a snapshot, the document is not locked for the whole flow
         Document* doc = control->getDocument();
+        doc->lockShared();
+        std::unique_ptr<Document> snapshot = doc->createSnapshot();
+        doc->unlockShared();
 
-        std::unique_ptr<XojPdfExport> pdfe = XojPdfExportFactory::createExport(doc, control);
+        std::unique_ptr<XojPdfExport> pdfe = XojPdfExportFactory::createExport(snapshot.get(), control);
 
         pdfe->setExportBackground(exportBackground);
 
@@ -25,6 +25,10 @@ void Job::deleteJob() {
     }
 }
 
+void Job::cancel() { this->cancelled = true; }
+
+auto Job::isCancelled() const -> bool { return this->cancelled; }
+
 void Job::onDelete() {}
 
 void Job::execute() { this->run(); }
@@ -13,7 +13,7 @@
 
 #include <atomic>
 
-enum JobType { JOB_TYPE_BLOCKING, JOB_TYPE_PREVIEW, JOB_TYPE_RENDER, JOB_TYPE_AUTOSAVE };
+enum JobType { JOB_TYPE_BLOCKING, JOB_TYPE_PREVIEW, JOB_TYPE_RENDER, JOB_TYPE_AUTOSAVE, JOB_TYPE_PARSE };
 
 /**
  * A manually ref-counted class representing an asynchronous job to be used with
@@ -49,6 +49,14 @@ public:
      */
     void deleteJob();
 
+    /**
+     * Asks the job to stop, e.g. because the source is not shown anymore.
+     * Jobs which support it check isCancelled() between their steps.
+     */
+    void cancel();
+
+    bool isCancelled() const;
+
 public:
     virtual JobType getType() = 0;
 
@@ -96,4 +104,6 @@ private:
     unsigned int afterRunId = 0;
 
     std::atomic<unsigned int> refCount;
+
+    std::atomic<bool> cancelled{false};
 };
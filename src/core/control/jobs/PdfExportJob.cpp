@@ -27,9 +27,11 @@ auto PdfExportJob::testAndSetFilepath(fs::path file) -> bool {
 void PdfExportJob::run() {
     Document* doc = control->getDocument();
 
-    doc->lock();
-    std::unique_ptr<XojPdfExport> pdfe = XojPdfExportFactory::createExport(doc, control);
-    doc->unlock();
+    doc->lockShared();
+    std::unique_ptr<Document> snapshot = doc->createSnapshot();
+    doc->unlockShared();
+
+    std::unique_ptr<XojPdfExport> pdfe = XojPdfExportFactory::createExport(snapshot.get(), control);
 
     if (!pdfe->createPdf(this->filepath, false)) {
         this->errorMsg = pdfe->getLastError();
@@ -1,138 +1,442 @@
 #include "RenderJob.h"
 
+#include <algorithm>
 #include <cmath>
 
 #include "control/Control.h"
+#include "control/RenderStatistics.h"
 #include "control/ToolHandler.h"
 #include "gui/PageView.h"
 #include "gui/XournalView.h"
 #include "model/Document.h"
+#include "model/Layer.h"
+#include "model/XojPage.h"
 #include "util/Rectangle.h"
 #include "util/Util.h"
 #include "view/DocumentView.h"
 #include "view/PdfView.h"
 
+#include "XournalScheduler.h"
+
 using xoj::util::Rectangle;
 
-RenderJob::RenderJob(XojPageView* view): view(view) {}
+/**
+ * Pages which are not visible are only rendered ahead if they need at most
+ * this many tiles (16 MiB), larger pages are rendered once they are shown
+ */
+constexpr int MAX_PRELOAD_TILES = 64;
+
+/**
+ * Tiles kept per page, tiles outside of the visible area are released above this count
+ */
+constexpr size_t MAX_PAGE_TILES = 96;
+
+RenderJob::RenderJob(XojPageView* view, bool refine): view(view), refine(refine) {}
 
 auto RenderJob::getSource() -> void* { return this->view; }
 
-void RenderJob::rerenderRectangle(Rectangle<double> const& rect) {
-    double zoom = view->xournal->getZoom();
+/**
+ * Keys of the background in the layer cache
+ */
+static const char LAYER_CACHE_BACKGROUND[] = "background";
+static const char LAYER_CACHE_TRANSPARENT_BACKGROUND[] = "transparent";
+
+void RenderJob::renderArea(cairo_t* cr, Rectangle<double> const& area, double scale) {
+    if (this->useLayerCache && view->layerCache.paint(cr, area, scale)) {
+        return;
+    }
+
     Document* doc = view->xournal->getDocument();
-    doc->lock();
+
+    // Render workers only read, they can draw their pages at the same time
+    doc->lockShared();
+    view->page->lockShared();
     double pageWidth = view->page->getWidth();
     double pageHeight = view->page->getHeight();
-    doc->unlock();
-
-    auto x = int(std::lround(rect.x * zoom));
-    auto y = int(std::lround(rect.y * zoom));
-    auto width = int(std::lround(rect.width * zoom));
-    auto height = int(std::lround(rect.height * zoom));
-
-    cairo_surface_t* rectBuffer = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
-    cairo_t* crRect = cairo_create(rectBuffer);
-    cairo_translate(crRect, -x, -y);
-    cairo_scale(crRect, zoom, zoom);
+    bool backgroundVisible = view->page->isLayerVisible(0);
+    bool pdfBackground = view->page->getBackgroundType().isPdfPage();
+    XojPdfPageSPtr popplerPage;
+    if (pdfBackground) {
+        popplerPage = doc->getPdfPage(view->page->getPdfPageNr());
+    }
+    view->page->unlockShared();
+    doc->unlockShared();
 
     DocumentView v;
     Control* control = view->getXournal()->getControl();
     v.setMarkAudioStroke(control->getToolHandler()->getToolType() == TOOL_PLAY_OBJECT);
-    v.limitArea(rect.x, rect.y, rect.width, rect.height);
+    v.limitArea(area.x, area.y, area.width, area.height);
 
-    bool backgroundVisible = view->page->isLayerVisible(0);
-    if (backgroundVisible && view->page->getBackgroundType().isPdfPage()) {
-        auto pgNo = view->page->getPdfPageNr();
-        XojPdfPageSPtr popplerPage = doc->getPdfPage(pgNo);
+    // The PDF background is rendered without the document lock, so the page
+    // can be changed in the meantime
+    if (backgroundVisible && pdfBackground) {
         PdfCache* cache = view->xournal->getCache();
-        PdfView::drawPage(cache, popplerPage, crRect, zoom, pageWidth, pageHeight);
+        if (this->pdfPreview && popplerPage) {
+            cairo_set_source_rgb(cr, 1., 1., 1.);
+            cairo_paint(cr);
+            cache->renderPreview(cr, popplerPage, scale);
+        } else {
+            PdfView::drawPage(cache, popplerPage, cr, scale, pageWidth, pageHeight);
+        }
+    }
+
+    doc->lockShared();
+    view->page->lockShared();
+    v.drawPage(view->page, cr, false);
+    view->page->unlockShared();
+    doc->unlockShared();
+}
+
+bool RenderJob::updateLayerCache(double scale) {
+    size_t limit = size_t(view->settings->getLayerCacheMemory()) * 1024 * 1024;
+    if (limit == 0) {
+        view->layerCache.clear();
+        return false;
     }
 
-    doc->lock();
-    v.drawPage(view->page, crRect, false);
-    doc->unlock();
+    Document* doc = view->xournal->getDocument();
+    Control* control = view->getXournal()->getControl();
+    bool markAudioStroke = control->getToolHandler()->getToolType() == TOOL_PLAY_OBJECT;
+
+    bool pdfBackground = false;
+    double pageWidth = 0;
+    double pageHeight = 0;
+    XojPdfPageSPtr popplerPage;
+
+    auto readPage = [&]() {
+        LayerRasterCache::PageState state;
+
+        doc->lockShared();
+        view->page->lockShared();
+        state.width = pageWidth = view->page->getWidth();
+        state.height = pageHeight = view->page->getHeight();
+
+        if (view->page->isLayerVisible(0)) {
+            state.layers.push_back({LAYER_CACHE_BACKGROUND, view->page->getBackgroundRevision(), false});
+            pdfBackground = view->page->getBackgroundType().isPdfPage();
+            if (pdfBackground) {
+                popplerPage = doc->getPdfPage(view->page->getPdfPageNr());
+            }
+        } else {
+            state.layers.push_back({LAYER_CACHE_TRANSPARENT_BACKGROUND, 0, false});
+        }
+
+        // Layer IDs start with 1, 0 is the background (see XojPage::getSelectedLayer)
+        size_t selected = static_cast<size_t>(std::max(view->page->getSelectedLayerId(), 1)) - 1;
+        std::vector<Layer*>* layers = view->page->getLayers();
+        for (size_t i = 0; i < layers->size(); i++) {
+            Layer* l = (*layers)[i];
+            if (XojPage::isLayerVisible(l)) {
+                state.layers.push_back({l, l->getRevision(), i == selected});
+            }
+        }
+
+        view->page->unlockShared();
+        doc->unlockShared();
+        return state;
+    };
+
+    DocumentView v;
+    v.setMarkAudioStroke(markAudioStroke);
+
+    auto draw = [&](cairo_t* cr, const void* key, const Rectangle<double>* area) {
+        // The PDF background is rendered without the document lock, so the page can be changed in the meantime
+        if (key == LAYER_CACHE_BACKGROUND && pdfBackground) {
+            PdfView::drawPage(view->xournal->getCache(), popplerPage, cr, scale, pageWidth, pageHeight);
+            return;
+        }
+
+        doc->lockShared();
+        view->page->lockShared();
+        v.initDrawing(view->page, cr, false);
+        if (area) {
+            v.limitArea(area->x, area->y, area->width, area->height);
+        }
+
+        if (key == LAYER_CACHE_BACKGROUND) {
+            v.drawBackground();
+        } else if (key == LAYER_CACHE_TRANSPARENT_BACKGROUND) {
+            v.drawTransparentBackgroundPattern();
+        } else {
+            // The layer may have been removed since the page was read, a rerender of the page follows then
+            std::vector<Layer*>* layers = view->page->getLayers();
+            auto it = std::find(layers->begin(), layers->end(), static_cast<const Layer*>(key));
+            if (it != layers->end()) {
+                v.drawLayer(cr, *it);
+            }
+        }
+
+        v.finializeDrawing();
+        view->page->unlockShared();
+        doc->unlockShared();
+    };
+
+    return view->layerCache.update(scale, markAudioStroke ? 1 : 0, limit, readPage, draw);
+}
+
+auto RenderJob::needsPdfPreview(double scale) -> bool {
+    Document* doc = view->xournal->getDocument();
+    XojPdfPageSPtr popplerPage;
+
+    doc->lockShared();
+    view->page->lockShared();
+    if (view->page->isLayerVisible(0) && view->page->getBackgroundType().isPdfPage()) {
+        popplerPage = doc->getPdfPage(view->page->getPdfPageNr());
+    }
+    view->page->unlockShared();
+    doc->unlockShared();
+
+    return popplerPage && !view->xournal->getCache()->isRendered(popplerPage, scale);
+}
+
+void RenderJob::rerenderRectangle(Rectangle<double> const& rect, double scale) {
+    auto x = int(std::lround(rect.x * scale));
+    auto y = int(std::lround(rect.y * scale));
+    auto width = int(std::lround(rect.width * scale));
+    auto height = int(std::lround(rect.height * scale));
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+
+    cairo_surface_t* rectBuffer = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+    cairo_t* crRect = cairo_create(rectBuffer);
+    cairo_translate(crRect, -x, -y);
+    cairo_scale(crRect, scale, scale);
+
+    renderArea(crRect, rect, scale);
 
     cairo_destroy(crRect);
 
     view->drawingMutex.lock();
 
-    cairo_t* crPageBuffer = cairo_create(view->crBuffer);
-
-    cairo_set_operator(crPageBuffer, CAIRO_OPERATOR_SOURCE);
-    cairo_set_source_surface(crPageBuffer, rectBuffer, x, y);
-    cairo_rectangle(crPageBuffer, x, y, width, height);
-    cairo_fill(crPageBuffer);
+    // Tiles which are missing or dirty are rendered completely later on
+    if (view->buffer.getScale() == scale) {
+        auto draw = [&](cairo_t* crTile) {
+            cairo_set_operator(crTile, CAIRO_OPERATOR_SOURCE);
+            cairo_set_source_surface(crTile, rectBuffer, x, y);
+            cairo_rectangle(crTile, x, y, width, height);
+            cairo_fill(crTile);
+        };
+        view->buffer.drawOnTiles(rect, draw, this->pdfPreview);
+    }
 
-    cairo_destroy(crPageBuffer);
+    view->drawingMutex.unlock();
 
     cairo_surface_destroy(rectBuffer);
+}
+
+void RenderJob::renderTiles(std::vector<std::pair<int, int>> const& tiles, double scale) {
+    constexpr int size = TiledPageBuffer::TILE_SIZE;
+
+    // All tiles are rendered in one pass over the page, which is a lot faster than walking all elements per tile
+    TileRange bounds{tiles.front().first, tiles.front().second, tiles.front().first + 1, tiles.front().second + 1};
+    for (auto const& [x, y]: tiles) {
+        bounds.x1 = std::min(bounds.x1, x);
+        bounds.y1 = std::min(bounds.y1, y);
+        bounds.x2 = std::max(bounds.x2, x + 1);
+        bounds.y2 = std::max(bounds.y2, y + 1);
+    }
+
+    cairo_surface_t* area = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, (bounds.x2 - bounds.x1) * size,
+                                                       (bounds.y2 - bounds.y1) * size);
+    cairo_t* cr = cairo_create(area);
+    cairo_translate(cr, -bounds.x1 * size, -bounds.y1 * size);
+    cairo_scale(cr, scale, scale);
+
+    Rectangle<double> pageArea = TiledPageBuffer::tileArea(bounds.x1, bounds.y1, scale);
+    pageArea.unite(TiledPageBuffer::tileArea(bounds.x2 - 1, bounds.y2 - 1, scale));
+    renderArea(cr, pageArea, scale);
+
+    cairo_destroy(cr);
+
+    std::vector<cairo_surface_t*> surfaces;
+    surfaces.reserve(tiles.size());
+
+    TilePool* pool = view->xournal->getTilePool();
+    for (auto const& [x, y]: tiles) {
+        cairo_surface_t* tile = pool->acquire();
+        cairo_t* crTile = cairo_create(tile);
+        cairo_set_operator(crTile, CAIRO_OPERATOR_SOURCE);
+        cairo_set_source_surface(crTile, area, -(x - bounds.x1) * size, -(y - bounds.y1) * size);
+        cairo_paint(crTile);
+        cairo_destroy(crTile);
+        surfaces.push_back(tile);
+    }
+
+    cairo_surface_destroy(area);
+
+    view->drawingMutex.lock();
+
+    for (size_t i = 0; i < tiles.size(); i++) {
+        if (view->buffer.getScale() == scale) {
+            view->buffer.setTile(tiles[i].first, tiles[i].second, surfaces[i], this->pdfPreview);
+        } else {
+            // The zoom changed meanwhile, a new job is already scheduled
+            pool->release(surfaces[i]);
+        }
+    }
 
     view->drawingMutex.unlock();
 }
 
+void RenderJob::postpone(bool rerenderComplete, std::vector<Rectangle<double>> const& rects) {
+    std::lock_guard lock{this->view->repaintRectMutex};
+
+    if (rerenderComplete) {
+        this->view->rerenderComplete = true;
+    } else if (!this->view->rerenderComplete) {
+        this->view->rerenderRects.insert(this->view->rerenderRects.end(), rects.begin(), rects.end());
+    }
+
+    // The missing tiles are found again by the next job
+    this->view->tilesRequested = true;
+
+    // The page was shown again while this job was running, resumeRendering() did not find this work then.
+    // The lock is held, so the page is not deleted before the job is queued, see ~XojPageView.
+    if (this->view->lastVisibleTime == 0) {
+        this->view->xournal->getControl()->getScheduler()->addRerenderPage(this->view);
+    }
+}
+
 void RenderJob::run() {
-    double zoom = this->view->xournal->getZoom();
+    RenderStatistics::Scope statistics("render", "RenderPage");
+
+    double scale = this->view->xournal->getZoom() * this->view->xournal->getDpiScaleFactor();
 
     this->view->repaintRectMutex.lock();
 
-    bool rerenderComplete = this->view->rerenderComplete;
+    const bool requestedComplete = this->view->rerenderComplete;
+    bool rerenderComplete = requestedComplete;
     auto rerenderRects = std::move(this->view->rerenderRects);
+    Rectangle<double> visibleArea = this->view->visibleArea;
 
     this->view->rerenderComplete = false;
+    this->view->tilesRequested = false;
 
     this->view->repaintRectMutex.unlock();
 
-    int dpiScaleFactor = this->view->xournal->getDpiScaleFactor();
-
-    if (rerenderComplete || dpiScaleFactor > 1) {
-        Document* doc = this->view->xournal->getDocument();
+    Document* doc = this->view->xournal->getDocument();
+    doc->lockShared();
+    Rectangle<double> page(0, 0, this->view->page->getWidth(), this->view->page->getHeight());
+    if (statistics.isActive()) {
+        statistics.addArg("page", static_cast<int64_t>(doc->indexOf(this->view->page)) + 1);
+    }
+    doc->unlockShared();
+
+    // The tiles which should be up to date after this job: the last painted area and a margin of one tile
+    const TileRange shown = TiledPageBuffer::tilesFor(visibleArea, scale);
+    TileRange range = shown;
+    if (!range.isEmpty()) {
+        TileRange pageRange = TiledPageBuffer::tilesFor(page, scale);
+        range.x1 = std::max(range.x1 - 1, 0);
+        range.y1 = std::max(range.y1 - 1, 0);
+        range.x2 = std::max(range.x2, std::min(range.x2 + 1, pageRange.x2));
+        range.y2 = std::max(range.y2, std::min(range.y2 + 1, pageRange.y2));
+    } else if (rerenderComplete) {
+        TileRange pageRange = TiledPageBuffer::tilesFor(page, scale);
+        if (pageRange.count() <= MAX_PRELOAD_TILES) {
+            range = pageRange;
+        }
+    }
 
-        int dispWidth = this->view->getDisplayWidth();
-        int dispHeight = this->view->getDisplayHeight();
+    std::vector<std::pair<int, int>> missing;
 
-        dispWidth *= dpiScaleFactor;
-        dispHeight *= dpiScaleFactor;
-        zoom *= dpiScaleFactor;
+    // A PDF page which is not rendered at this zoom yet is shown with a low resolution rendering first, so
+    // scrolling does not show blank pages. The full resolution follows once no page waits for a rendering.
+    this->pdfPreview = !this->refine && needsPdfPreview(scale);
 
-        cairo_surface_t* crBuffer = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, dispWidth, dispHeight);
-        cairo_t* cr2 = cairo_create(crBuffer);
-        cairo_scale(cr2, zoom, zoom);
+    // Rasterizing all layers of the page only pays off once the page is rendered again at the same zoom
+    bool createLayerCache = rerenderComplete;
 
-        XojPdfPageSPtr popplerPage;
+    this->view->drawingMutex.lock();
 
-        doc->lock();
+    if (this->view->buffer.getScale() != scale) {
+        this->view->buffer.setScale(scale);
+        rerenderComplete = true;
+        createLayerCache = false;
+    } else if (rerenderComplete) {
+        this->view->buffer.invalidateAll();
+    }
 
-        if (this->view->page->getBackgroundType().isPdfPage()) {
-            auto pgNo = this->view->page->getPdfPageNr();
-            popplerPage = doc->getPdfPage(pgNo);
+    for (int y = range.y1; y < range.y2; y++) {
+        for (int x = range.x1; x < range.x2; x++) {
+            bool rendered = this->pdfPreview ? this->view->buffer.isPainted(x, y) : this->view->buffer.isValid(x, y);
+            if (!rendered) {
+                missing.emplace_back(x, y);
+            }
         }
+    }
+
+    this->view->drawingMutex.unlock();
+
+    statistics.addArg("tiles", static_cast<int64_t>(missing.size()));
+    statistics.addArg("rects", rerenderComplete ? 0 : static_cast<int64_t>(rerenderRects.size()));
 
-        Control* control = view->getXournal()->getControl();
-        DocumentView localView;
-        localView.setMarkAudioStroke(control->getToolHandler()->getToolType() == TOOL_PLAY_OBJECT);
-        int width = this->view->page->getWidth();
-        int height = this->view->page->getHeight();
+    // The page left the viewport while the job was waiting for the lock
+    if (isCancelled()) {
+        postpone(requestedComplete, rerenderRects);
+        return;
+    }
+
+    // The layer cache holds the full resolution PDF background, it is left alone by previews
+    if (this->pdfPreview) {
+        this->useLayerCache = false;
+    } else if (createLayerCache || this->view->layerCache.isValid(scale)) {
+        this->useLayerCache = updateLayerCache(scale);
+    } else {
+        this->view->layerCache.clear();
+    }
 
-        bool backgroundVisible = this->view->page->isLayerVisible(0);
-        if (backgroundVisible && this->view->page->getBackgroundType().isPdfPage()) {
-            PdfView::drawPage(this->view->xournal->getCache(), popplerPage, cr2, zoom, width, height);
+    if (!rerenderComplete) {
+        for (auto it = rerenderRects.begin(); it != rerenderRects.end(); ++it) {
+            if (isCancelled()) {
+                postpone(false, {it, rerenderRects.end()});
+                return;
+            }
+            rerenderRectangle(*it, scale);
         }
-        localView.drawPage(this->view->page, cr2, false);
+    }
 
-        cairo_destroy(cr2);
+    // The tiles are rendered row by row, so a cancelled job stops after the current row.
+    // The rows which were shown come first, the margin afterwards.
+    auto isShown = [&shown](std::pair<int, int> const& tile) {
+        return tile.second >= shown.y1 && tile.second < shown.y2;
+    };
+    std::stable_partition(missing.begin(), missing.end(), isShown);
+
+    for (auto begin = missing.begin(); begin != missing.end();) {
+        if (isCancelled()) {
+            postpone(false, {});
+            return;
+        }
+        auto end = std::find_if(begin, missing.end(), [row = begin->second](std::pair<int, int> const& tile) {
+            return tile.second != row;
+        });
+        renderTiles({begin, end}, scale);
+        begin = end;
+    }
 
-        this->view->drawingMutex.lock();
+    this->view->drawingMutex.lock();
 
-        if (this->view->crBuffer) {
-            cairo_surface_destroy(this->view->crBuffer);
+    if (this->view->buffer.getScale() == scale) {
+        if (rerenderComplete) {
+            // Outdated tiles outside of the visible area are rendered again once they are shown
+            this->view->buffer.releaseDirty();
+        }
+        this->view->buffer.releaseStaleIfCovered(range);
+        this->view->buffer.trim(range, MAX_PAGE_TILES);
+        if (!this->pdfPreview) {
+            // Previews outside of the rendered range are rendered in full resolution once they are shown
+            this->view->buffer.releasePreviews();
         }
-        this->view->crBuffer = crBuffer;
+    }
 
-        this->view->drawingMutex.unlock();
-        doc->unlock();
-    } else {
-        for (Rectangle<double> const& rect: rerenderRects) { rerenderRectangle(rect); }
+    bool hasPreview = this->pdfPreview && this->view->buffer.hasPreview();
+
+    this->view->drawingMutex.unlock();
+
+    if (hasPreview) {
+        this->view->xournal->getControl()->getScheduler()->addRefinePage(this->view);
     }
 
     // Schedule a repaint of the widget
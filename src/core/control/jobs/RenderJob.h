@@ -12,10 +12,12 @@
 #pragma once
 
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <gtk/gtk.h>
 
+#include "gui/TiledPageBuffer.h"
 #include "util/Rectangle.h"
 
 #include "Job.h"
@@ -25,7 +27,10 @@ class XojPageView;
 
 class RenderJob: public Job {
 public:
-    RenderJob(XojPageView* view);
+    /**
+     * @param refine Renders the previews of the page in full resolution, see XournalScheduler::addRefinePage
+     */
+    RenderJob(XojPageView* view, bool refine = false);
 
 protected:
     ~RenderJob() override = default;
@@ -43,8 +48,54 @@ private:
      */
     static void repaintWidget(GtkWidget* widget);
 
-    void rerenderRectangle(xoj::util::Rectangle<double> const& rect);
+    /**
+     * Draws the area of the page (PDF background and all layers) to cr, from the layer cache if it is used
+     */
+    void renderArea(cairo_t* cr, xoj::util::Rectangle<double> const& area, double scale);
+
+    /**
+     * Brings the rasterized layers of the page up to date
+     *
+     * @return false if the page is not cached (disabled or too large)
+     */
+    bool updateLayerCache(double scale);
+
+    /**
+     * @return true if the page has a visible PDF background which is not rendered at this scale yet
+     */
+    bool needsPdfPreview(double scale);
+
+    /**
+     * Redraws the area into all valid tiles which intersect it
+     */
+    void rerenderRectangle(xoj::util::Rectangle<double> const& rect, double scale);
+
+    /**
+     * Renders the tiles in one pass and installs them into the page buffer
+     */
+    void renderTiles(std::vector<std::pair<int, int>> const& tiles, double scale);
+
+    /**
+     * Hands the work which was not done back to the page, after the job was cancelled. Schedules the page
+     * again if it is shown.
+     *
+     * @param rerenderComplete The whole page was to be rerendered
+     * @param rects The rectangles which were not rerendered
+     */
+    void postpone(bool rerenderComplete, std::vector<xoj::util::Rectangle<double>> const& rects);
 
 private:
     XojPageView* view;
+
+    /**
+     * The page is rendered from XojPageView::layerCache
+     */
+    bool useLayerCache = false;
+
+    bool refine = false;
+
+    /**
+     * The PDF background is drawn from a low resolution rendering, the tiles are marked as previews
+     */
+    bool pdfPreview = false;
 };
@@ -85,10 +85,11 @@ auto SaveJob::save() -> bool {
     Document* doc = this->control->getDocument();
     SaveHandler h;
 
-    doc->lock();
-    h.prepareSave(doc);
+    doc->lockShared();
+    std::unique_ptr<Document> snapshot = doc->createSnapshot();
+    h.prepareSave(snapshot.get());
     fs::path filepath = doc->getFilepath();
-    doc->unlock();
+    doc->unlockShared();
 
     Util::clearExtensions(filepath, ".pdf");
     auto const target = fs::path{filepath}.concat(".xopp");
@@ -105,8 +106,11 @@ auto SaveJob::save() -> bool {
         }
     }
 
-    doc->lock();
+    // The snapshot is written without holding the lock, so the document is not blocked while saving
     h.saveTo(target, this->control);
+    snapshot.reset();
+
+    doc->lock();
     doc->setFilepath(target);
     doc->unlock();
 
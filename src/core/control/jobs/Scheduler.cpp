@@ -1,10 +1,14 @@
 #include "Scheduler.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cinttypes>
+#include <thread>
 
 #include <config-debug.h>
 
+#include "control/RenderStatistics.h"
+
 #ifdef DEBUG_SHEDULER
 #define SDEBUG g_message
 #else
@@ -39,11 +43,24 @@ Scheduler::~Scheduler() {
     }
 }
 
+void Scheduler::setWorkerCount(unsigned int count) {
+    g_return_if_fail(this->threads.empty());
+
+    if (count == 0) {
+        count = std::thread::hardware_concurrency();
+    }
+    this->workerCount = std::max(count, 1U);
+}
+
+auto Scheduler::getWorkerCount() const -> unsigned int { return this->workerCount; }
+
 void Scheduler::start() {
-    SDEBUG("Starting scheduler");
-    g_return_if_fail(this->thread == nullptr);
+    SDEBUG("Starting scheduler with %u workers", this->workerCount);
+    g_return_if_fail(this->threads.empty());
 
-    this->thread = g_thread_new(name.c_str(), reinterpret_cast<GThreadFunc>(jobThreadCallback), this);
+    for (unsigned int i = 0; i < this->workerCount; i++) {
+        this->threads.push_back(g_thread_new(name.c_str(), reinterpret_cast<GThreadFunc>(jobThreadCallback), this));
+    }
 }
 
 void Scheduler::stop() {
@@ -52,12 +69,14 @@ void Scheduler::stop() {
     if (!this->threadRunning) {
         return;
     }
-    this->threadRunning = false;
+    {
+        std::lock_guard lock{this->jobQueueMutex};
+        this->threadRunning = false;
+    }
     this->jobQueueCond.notify_all();
 
-    if (this->thread) {
-        g_thread_join(this->thread);
-    }
+    for (GThread* thread: this->threads) { g_thread_join(thread); }
+    this->threads.clear();
 }
 
 void Scheduler::addJob(Job* job, JobPriority priority) {
@@ -75,29 +94,27 @@ void Scheduler::addJob(Job* job, JobPriority priority) {
 }
 
 auto Scheduler::getNextJobUnlocked(bool onlyNotRender, bool* hasRenderJobs) -> Job* {
-    Job* job = nullptr;
-
     for (int i = JOB_PRIORITY_URGENT; i < JOB_N_PRIORITIES; i++) {
         std::deque<Job*>& queue = *this->jobQueue[i];
 
-        if (onlyNotRender) {
-            for (auto it = queue.begin(); it != queue.end(); ++it) {
-                job = *it;
-
-                if (job->getType() != JOB_TYPE_RENDER) {
-                    queue.erase(it);
-                    return job;
-                }
+        for (auto it = queue.begin(); it != queue.end(); ++it) {
+            Job* job = *it;
+            assert(job != nullptr);
 
+            if (onlyNotRender && job->getType() == JOB_TYPE_RENDER) {
                 if (hasRenderJobs != nullptr) {
                     *hasRenderJobs = true;
                 }
+                continue;
+            }
+
+            // Another worker is already busy with this source, it will be picked up afterwards
+            void* source = job->getSource();
+            if (source != nullptr && this->runningSources.count(source) != 0) {
+                continue;
             }
-        } else if (!queue.empty()) {
-            job = queue.front();
-            queue.pop_front();
-            assert(job != nullptr);
 
+            queue.erase(it);
             return job;
         }
     }
@@ -105,10 +122,39 @@ auto Scheduler::getNextJobUnlocked(bool onlyNotRender, bool* hasRenderJobs) -> J
     return nullptr;
 }
 
+/**
+ * The name of the job in the render statistics
+ */
+static auto jobTypeName(JobType type) -> const char* {
+    switch (type) {
+        case JOB_TYPE_BLOCKING:
+            return "BlockingJob";
+        case JOB_TYPE_PREVIEW:
+            return "PreviewJob";
+        case JOB_TYPE_RENDER:
+            return "RenderJob";
+        case JOB_TYPE_AUTOSAVE:
+            return "AutosaveJob";
+        case JOB_TYPE_PARSE:
+            return "ParsePagesJob";
+    }
+    return "Job";
+}
+
+auto Scheduler::isParallelJob(Job* job) -> bool {
+    JobType type = job->getType();
+    return type == JOB_TYPE_RENDER || type == JOB_TYPE_PREVIEW || type == JOB_TYPE_PARSE;
+}
+
 /**
  * Locks the complete scheduler
  */
-void Scheduler::lock() { this->schedulerMutex.lock(); }
+void Scheduler::lock() {
+    this->schedulerMutex.lock();
+
+    // Wait for the jobs which were started before we got the lock
+    std::lock_guard runningLock{this->jobRunningMutex};
+}
 
 /**
  * Unlocks the complete scheduler
@@ -206,11 +252,16 @@ auto Scheduler::jobThreadCallback(Scheduler* scheduler) -> gpointer {
         }
 
         Job* job;
+        void* source = nullptr;
 
         {
             std::unique_lock jobLock{scheduler->jobQueueMutex};
             SDEBUG("Job Thread: Locked job queue.");
 
+            if (!scheduler->threadRunning) {
+                break;
+            }
+
             bool hasOnlyRenderJobs = false;
             job = scheduler->getNextJobUnlocked(onlyNonRenderJobs, &hasOnlyRenderJobs);
             if (job != nullptr) {
@@ -234,16 +285,54 @@ auto Scheduler::jobThreadCallback(Scheduler* scheduler) -> gpointer {
                 scheduler->jobQueueCond.wait(jobLock);
                 continue;
             }
+
+            source = job->getSource();
+            if (source != nullptr) {
+                scheduler->runningSources.insert(source);
+            }
+            scheduler->runningJobs.push_back(job);
         }
 
-        // Run the job.
-        {
-            std::lock_guard lock{scheduler->jobRunningMutex};
+        // The job is removed from runningJobs before it is unreferenced, so it is not cancelled after it is freed
+        auto finishJob = [scheduler](Job* job) {
+            std::lock_guard jobLock{scheduler->jobQueueMutex};
+            auto& running = scheduler->runningJobs;
+            running.erase(std::find(running.begin(), running.end(), job));
+        };
+
+        // Run the job. The running lock is taken before the scheduler is unlocked,
+        // so Scheduler::lock() always waits for this job.
+        if (isParallelJob(job)) {
+            std::shared_lock lock{scheduler->jobRunningMutex};
+            schedulerLock.unlock();
+            SDEBUG("do parallel job: %" PRId64, (uint64_t)job);
+            {
+                RenderStatistics::Scope scope("scheduler", jobTypeName(job->getType()));
+                job->execute();
+            }
+            finishJob(job);
+            job->unref();
+        } else {
+            std::unique_lock lock{scheduler->jobRunningMutex};
+            schedulerLock.unlock();
             SDEBUG("do job: %" PRId64, (uint64_t)job);
-            job->execute();
+            {
+                RenderStatistics::Scope scope("scheduler", jobTypeName(job->getType()));
+                job->execute();
+            }
+            finishJob(job);
             job->unref();
         }
 
+        if (source != nullptr) {
+            {
+                std::lock_guard jobLock{scheduler->jobQueueMutex};
+                scheduler->runningSources.erase(source);
+            }
+            // Jobs waiting for this source may be started now
+            scheduler->jobQueueCond.notify_all();
+        }
+
         SDEBUG("next");
     }
 
@@ -14,10 +14,14 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <condition_variable>
 #include <deque>
 #include <mutex>
+#include <set>
+#include <shared_mutex>
 #include <string>
+#include <vector>
 
 #include <gtk/gtk.h>
 
@@ -79,11 +83,24 @@ public:
      */
     void addJob(Job* job, JobPriority priority);
 
+    /**
+     * Sets the number of worker threads, has to be called before start()
+     *
+     * @param count the number of workers, 0 uses one worker per CPU core
+     */
+    void setWorkerCount(unsigned int count);
+
+    /**
+     * @return the number of worker threads
+     */
+    unsigned int getWorkerCount() const;
+
     void start();
     void stop();
 
     /**
-     * Locks the complete scheduler
+     * Locks the complete scheduler: no new job is started
+     * and all running jobs are finished when this returns
      */
     void lock();
 
@@ -106,14 +123,23 @@ private:
     static gpointer jobThreadCallback(Scheduler* scheduler);
     Job* getNextJobUnlocked(bool onlyNotRender = false, bool* hasRenderJobs = nullptr);
 
+    /**
+     * Render and preview jobs only draw into their own buffer, and parse jobs only
+     * create the pages of a document which is loaded, so they may run on several
+     * workers at the same time. All other jobs run exclusively.
+     */
+    static bool isParallelJob(Job* job);
+
     static bool jobRenderThreadTimer(Scheduler* scheduler);
 
 protected:
-    bool threadRunning = true;
+    std::atomic<bool> threadRunning = true;
 
     int jobRenderThreadTimerId = 0;
 
-    GThread* thread = nullptr;
+    unsigned int workerCount = 1;
+
+    std::vector<GThread*> threads{};
 
     std::condition_variable jobQueueCond{};
     std::mutex jobQueueMutex{};
@@ -122,8 +148,21 @@ protected:
     /**
      * This is need to be sure there is no job running if we delete a page.
      * If a job is, we may access deleted memory.
+     *
+     * Parallel jobs hold it shared, all other jobs hold it exclusive.
+     */
+    std::shared_mutex jobRunningMutex{};
+
+    /**
+     * Sources of the jobs which are currently executed, a second job
+     * for the same source is not started before the first one is done
+     */
+    std::set<void*> runningSources{};
+
+    /**
+     * Jobs which are currently executed, so they can be cancelled. Guarded by jobQueueMutex
      */
-    std::mutex jobRunningMutex{};
+    std::vector<Job*> runningJobs{};
 
     /**
      * Jobs of each priority. New jobs
@@ -1,5 +1,7 @@
 #include "XournalScheduler.h"
 
+#include <algorithm>
+
 #include "PreviewJob.h"
 #include "RenderJob.h"
 
@@ -14,7 +16,19 @@ void XournalScheduler::removeSidebar(SidebarPreviewBaseEntry* preview) {
     removeSource(preview, JOB_TYPE_PREVIEW, JOB_PRIORITY_HIGH, waitForTaskCompletion);
 }
 
-void XournalScheduler::removePage(XojPageView* view) { removeSource(view, JOB_TYPE_RENDER, JOB_PRIORITY_URGENT); }
+void XournalScheduler::removePage(XojPageView* view) {
+    removeSource(view, JOB_TYPE_RENDER, JOB_PRIORITY_LOW, false);
+    removeSource(view, JOB_TYPE_RENDER, JOB_PRIORITY_URGENT);
+}
+
+void XournalScheduler::cancelPage(XojPageView* view) {
+    removeSource(view, JOB_TYPE_RENDER, JOB_PRIORITY_LOW, false);
+    removeSource(view, JOB_TYPE_RENDER, JOB_PRIORITY_URGENT, false);
+}
+
+void XournalScheduler::cancelPrefetch(XojPageView* view) {
+    removeSource(view, JOB_TYPE_RENDER, JOB_PRIORITY_LOW, false);
+}
 
 void XournalScheduler::removeAllJobs() {
     std::lock_guard lock{this->jobQueueMutex};
@@ -43,6 +57,20 @@ void XournalScheduler::removeAllJobs() {
     }
 }
 
+void XournalScheduler::prioritizePages(const std::vector<XojPageView*>& visible) {
+    std::lock_guard lock{this->jobQueueMutex};
+
+    auto isVisible = [&visible](Job* job) {
+        return job->getType() == JOB_TYPE_RENDER &&
+               std::find(visible.begin(), visible.end(), job->getSource()) != visible.end();
+    };
+
+    for (JobPriority priority: {JOB_PRIORITY_URGENT, JOB_PRIORITY_LOW}) {
+        std::deque<Job*>& queue = *this->jobQueue[priority];
+        std::stable_partition(queue.begin(), queue.end(), isVisible);
+    }
+}
+
 void XournalScheduler::finishTask() { std::lock_guard lock{this->jobRunningMutex}; }
 
 void XournalScheduler::removeSource(void* source, JobType type, JobPriority priority, bool awaitFinishTask) {
@@ -65,6 +93,13 @@ void XournalScheduler::removeSource(void* source, JobType type, JobPriority prio
                 ++it;
             }
         }
+
+        // A job which is running already stops at its next check, it keeps the work it did not do for later
+        for (Job* job: this->runningJobs) {
+            if (job->getType() == type && job->getSource() == source) {
+                job->cancel();
+            }
+        }
     }
 
     // wait until the last job is done
@@ -107,3 +142,25 @@ void XournalScheduler::addRerenderPage(XojPageView* view) {
     addJob(job, JOB_PRIORITY_URGENT);
     job->unref();
 }
+
+void XournalScheduler::addRefinePage(XojPageView* view) {
+    if (existsSource(view, JOB_TYPE_RENDER, JOB_PRIORITY_LOW)) {
+        return;
+    }
+
+    auto* job = new RenderJob(view, true);
+    addJob(job, JOB_PRIORITY_LOW);
+    job->unref();
+}
+
+void XournalScheduler::addPrefetchPage(XojPageView* view) {
+    // A queued job renders the requested area as well
+    if (existsSource(view, JOB_TYPE_RENDER, JOB_PRIORITY_URGENT) ||
+        existsSource(view, JOB_TYPE_RENDER, JOB_PRIORITY_LOW)) {
+        return;
+    }
+
+    auto* job = new RenderJob(view);
+    addJob(job, JOB_PRIORITY_LOW);
+    job->unref();
+}
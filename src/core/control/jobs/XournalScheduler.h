@@ -34,6 +34,18 @@ public:
     void removeSidebar(SidebarPreviewBaseEntry* preview);
     void removePage(XojPageView* view);
 
+    /**
+     * Drops the render jobs of a page which is not shown anymore and cancels the running one, without waiting
+     * for it. The page schedules its pending work again once it is shown.
+     */
+    void cancelPage(XojPageView* view);
+
+    /**
+     * Moves the render jobs of the visible pages in front of the other render jobs of the same priority,
+     * called when the visible pages change
+     */
+    void prioritizePages(const std::vector<XojPageView*>& visible);
+
     /**
      * Removes all PreviewJob%s / RenderJob%s scheduled to be run
      */
@@ -42,6 +54,21 @@ public:
     void addRepaintSidebar(SidebarPreviewBaseEntry* preview);
     void addRerenderPage(XojPageView* view);
 
+    /**
+     * Renders the page again in full resolution after a preview, once no page waits for its first rendering
+     */
+    void addRefinePage(XojPageView* view);
+
+    /**
+     * Renders the requested area of a page which is about to be shown, after the pages which are shown
+     */
+    void addPrefetchPage(XojPageView* view);
+
+    /**
+     * Drops the prefetch and refine jobs of a page which is not expected to be shown anymore
+     */
+    void cancelPrefetch(XojPageView* view);
+
     /**
      * Blocks until all currently running Job%s have been executed
      */
@@ -49,7 +76,8 @@ public:
 
 private:
     /**
-     * Remove source, e.g. if a page is removed they don't need to repaint
+     * Remove source, e.g. if a page is removed they don't need to repaint.
+     * A running job of the source is cancelled.
      */
     void removeSource(void* source, JobType type, JobPriority priority, bool awaitFinishTask = true);
 
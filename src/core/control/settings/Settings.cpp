@@ -151,9 +151,13 @@ void Settings::loadDefault() {
 
     this->pageRerenderThreshold = 5.0;
     this->pdfPageCacheSize = 10;
+    this->pdfPageCacheMemory = 256U;
+    this->layerCacheMemory = 256U;
+    this->prefetchMemory = 64U;
     this->preloadPagesBefore = 3U;
     this->preloadPagesAfter = 5U;
     this->eagerPageCleanup = true;
+    this->schedulerWorkerCount = 0U;
 
     this->selectionBorderColor = 0xff0000U;  // red
     this->selectionMarkerColor = 0x729fcfU;  // light blue
@@ -434,12 +438,20 @@ void Settings::parseItem(xmlDocPtr doc, xmlNodePtr cur) {
         this->pageRerenderThreshold = g_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("pdfPageCacheSize")) == 0) {
         this->pdfPageCacheSize = g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10);
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("pdfPageCacheMemory")) == 0) {
+        this->pdfPageCacheMemory = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("layerCacheMemory")) == 0) {
+        this->layerCacheMemory = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("prefetchMemory")) == 0) {
+        this->prefetchMemory = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("preloadPagesBefore")) == 0) {
         this->preloadPagesBefore = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("preloadPagesAfter")) == 0) {
         this->preloadPagesAfter = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("eagerPageCleanup")) == 0) {
         this->eagerPageCleanup = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("schedulerWorkerCount")) == 0) {
+        this->schedulerWorkerCount = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("selectionBorderColor")) == 0) {
         this->selectionBorderColor = Color(g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10));
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("selectionMarkerColor")) == 0) {
@@ -928,9 +940,17 @@ void Settings::save() {
 
     SAVE_INT_PROP(pdfPageCacheSize);
     ATTACH_COMMENT("The count of rendered PDF pages which will be cached.");
+    SAVE_UINT_PROP(pdfPageCacheMemory);
+    ATTACH_COMMENT("The memory in MiB used for rendered PDF pages, each page may be cached at several zoom levels.");
+    SAVE_UINT_PROP(layerCacheMemory);
+    ATTACH_COMMENT("The memory in MiB per page used to keep its layers rasterized, 0 to disable.");
+    SAVE_UINT_PROP(prefetchMemory);
+    ATTACH_COMMENT("The memory in MiB used to render the pages ahead in the scroll direction, 0 to disable.");
     SAVE_UINT_PROP(preloadPagesBefore);
     SAVE_UINT_PROP(preloadPagesAfter);
     SAVE_BOOL_PROP(eagerPageCleanup);
+    SAVE_UINT_PROP(schedulerWorkerCount);
+    ATTACH_COMMENT("The number of threads rendering pages in the background, 0 uses one thread per CPU core.");
 
     SAVE_STRING_PROP(pageTemplate);
     ATTACH_COMMENT("Config for new pages");
@@ -1764,6 +1784,36 @@ void Settings::setPdfPageCacheSize(int size) {
     save();
 }
 
+auto Settings::getPdfPageCacheMemory() const -> unsigned int { return this->pdfPageCacheMemory; }
+
+void Settings::setPdfPageCacheMemory(unsigned int mib) {
+    if (this->pdfPageCacheMemory == mib) {
+        return;
+    }
+    this->pdfPageCacheMemory = mib;
+    save();
+}
+
+auto Settings::getLayerCacheMemory() const -> unsigned int { return this->layerCacheMemory; }
+
+void Settings::setLayerCacheMemory(unsigned int mib) {
+    if (this->layerCacheMemory == mib) {
+        return;
+    }
+    this->layerCacheMemory = mib;
+    save();
+}
+
+auto Settings::getPrefetchMemory() const -> unsigned int { return this->prefetchMemory; }
+
+void Settings::setPrefetchMemory(unsigned int mib) {
+    if (this->prefetchMemory == mib) {
+        return;
+    }
+    this->prefetchMemory = mib;
+    save();
+}
+
 auto Settings::getPreloadPagesBefore() const -> unsigned int { return this->preloadPagesBefore; }
 
 void Settings::setPreloadPagesBefore(unsigned int n) {
@@ -1794,6 +1844,16 @@ void Settings::setEagerPageCleanup(bool b) {
     save();
 }
 
+auto Settings::getSchedulerWorkerCount() const -> unsigned int { return this->schedulerWorkerCount; }
+
+void Settings::setSchedulerWorkerCount(unsigned int n) {
+    if (this->schedulerWorkerCount == n) {
+        return;
+    }
+    this->schedulerWorkerCount = n;
+    save();
+}
+
 auto Settings::getBorderColor() const -> Color { return this->selectionBorderColor; }
 
 void Settings::setBorderColor(Color color) {
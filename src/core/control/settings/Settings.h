@@ -343,6 +343,24 @@ public:
     int getPdfPageCacheSize() const;
     [[maybe_unused]] void setPdfPageCacheSize(int size);
 
+    /**
+     * The memory budget of each PDF page cache, in MiB
+     */
+    unsigned int getPdfPageCacheMemory() const;
+    [[maybe_unused]] void setPdfPageCacheMemory(unsigned int mib);
+
+    /**
+     * The memory budget of the rasterized layers of all pages, in MiB. 0 disables the layer cache.
+     */
+    unsigned int getLayerCacheMemory() const;
+    [[maybe_unused]] void setLayerCacheMemory(unsigned int mib);
+
+    /**
+     * The memory budget of the pages which are rendered ahead while scrolling, in MiB. 0 disables it.
+     */
+    unsigned int getPrefetchMemory() const;
+    [[maybe_unused]] void setPrefetchMemory(unsigned int mib);
+
     unsigned int getPreloadPagesBefore() const;
     void setPreloadPagesBefore(unsigned int n);
 
@@ -352,6 +370,12 @@ public:
     bool isEagerPageCleanup() const;
     void setEagerPageCleanup(bool b);
 
+    /**
+     * The number of worker threads used by the scheduler, 0 means one per CPU core
+     */
+    unsigned int getSchedulerWorkerCount() const;
+    void setSchedulerWorkerCount(unsigned int n);
+
     std::string const& getPageTemplate() const;
     void setPageTemplate(const std::string& pageTemplate);
 
@@ -844,6 +868,21 @@ private:
      */
     int pdfPageCacheSize{};
 
+    /**
+     *  The memory used by the renderings of cached pages, in MiB
+     */
+    unsigned int pdfPageCacheMemory{};
+
+    /**
+     *  The memory used by the rasterized layers of all pages, in MiB
+     */
+    unsigned int layerCacheMemory{};
+
+    /**
+     *  The memory used by the pages rendered ahead in the scroll direction, in MiB
+     */
+    unsigned int prefetchMemory{};
+
     /**
      *  Percentage by which the page's zoom must change
      * for PDF pages to re-render while zooming.
@@ -1012,6 +1051,11 @@ private:
      */
     bool eagerPageCleanup{};
 
+    /**
+     * The number of threads running background jobs (0: one per CPU core)
+     */
+    unsigned int schedulerWorkerCount{};
+
     /**
      * Stabilizer related settings
      */
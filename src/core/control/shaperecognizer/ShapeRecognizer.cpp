@@ -247,10 +247,12 @@ auto ShapeRecognizer::recognizePatterns(Stroke* stroke) -> Stroke* {
     Inertia ss[4];
     int brk[5] = {0};
 
+    auto const pointVector = stroke->getPointVector();
+
     // first see if it's a polygon
-    int n = findPolygonal(stroke->getPoints(), 0, stroke->getPointCount() - 1, MAX_POLYGON_SIDES, brk, ss);
+    int n = findPolygonal(pointVector.data(), 0, stroke->getPointCount() - 1, MAX_POLYGON_SIDES, brk, ss);
     if (n > 0) {
-        optimizePolygonal(stroke->getPoints(), n, brk, ss);
+        optimizePolygonal(pointVector.data(), n, brk, ss);
 #ifdef DEBUG_RECOGNIZER
         g_message("--");
         g_message("ShapeReco:: Polygon, %d edges:", n);
@@ -276,7 +278,7 @@ auto ShapeRecognizer::recognizePatterns(Stroke* stroke) -> Stroke* {
         for (int i = 0; i < n; i++) {
             rs[i].startpt = brk[i];
             rs[i].endpt = brk[i + 1];
-            rs[i].calcSegmentGeometry(stroke->getPoints(), brk[i], brk[i + 1], ss + i);
+            rs[i].calcSegmentGeometry(pointVector.data(), brk[i], brk[i + 1], ss + i);
         }
 
         if (Stroke* result = tryRectangle(); result != nullptr) {
@@ -49,7 +49,8 @@ void EraseHandler::erase(double x, double y) {
 
     Layer* l = page->getSelectedLayer();
 
-    for (Element* e: l->getElements()) {
+    xoj::util::Rectangle<double> area(eraserRect.x - 1, eraserRect.y - 1, eraserRect.width + 2, eraserRect.height + 2);
+    for (Element* e: l->getElementsInArea(area)) {
         if (e->getType() == ELEMENT_STROKE && e->intersectsArea(&eraserRect)) {
             eraseStroke(l, dynamic_cast<Stroke*>(e), x, y, range);
         }
@@ -66,9 +67,11 @@ void EraseHandler::eraseStroke(Layer* l, Stroke* s, double x, double y, Range* r
 
     // delete complete element
     if (this->handler->getEraserType() == ERASER_TYPE_DELETE_STROKE) {
-        this->doc->lock();
+        this->doc->lockShared();
+        this->page->lock();
         int pos = l->removeElement(s, false);
-        this->doc->unlock();
+        this->page->unlock();
+        this->doc->unlockShared();
 
         if (pos == -1) {
             return;
@@ -102,16 +105,23 @@ void EraseHandler::eraseStroke(Layer* l, Stroke* s, double x, double y, Range* r
 
         ErasableStroke* eraseable = nullptr;
         if (s->getErasable() == nullptr) {
-            doc->lock();
+            doc->lockShared();
+            this->page->lock();
             eraseable = new ErasableStroke(s);
             s->setErasable(eraseable);
-            doc->unlock();
+            this->page->unlock();
+            doc->unlockShared();
             this->eraseUndoAction->addOriginal(l, s, pos);
         } else {
             eraseable = s->getErasable();
         }
 
+        // Only this page is changed, other pages can be rendered in the meantime
+        doc->lockShared();
+        this->page->lock();
         eraseable->erase(x, y, halfEraserSize, range);
+        this->page->unlock();
+        doc->unlockShared();
     }
 }
 
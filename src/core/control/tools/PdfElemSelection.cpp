@@ -14,9 +14,9 @@ PdfElemSelection::PdfElemSelection(double x, double y, XojPageView* view):
     auto xournal = view->getXournal();
     if (auto pNr = this->view->getPage()->getPdfPageNr(); pNr != npos) {
         Document* doc = xournal->getControl()->getDocument();
-        doc->lock();
+        doc->lockShared();
         this->pdf = doc->getPdfPage(pNr);
-        doc->unlock();
+        doc->unlockShared();
 
         this->selectionPageNr = pNr;
     }
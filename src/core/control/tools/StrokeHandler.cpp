@@ -149,7 +149,7 @@ void StrokeHandler::drawSegmentTo(const Point& point) {
          * Add the first point to the redraw range, so that the filling is painted.
          * Note: the actual stroke painting will only happen in this->draw() which is called less often
          */
-        const Point& firstPoint = stroke->getPointVector().front();
+        const Point firstPoint = stroke->getPoint(0);
         rg.addPoint(firstPoint.x, firstPoint.y);
     } else if (!this->fullRedraw) {
         Stroke lastSegment;
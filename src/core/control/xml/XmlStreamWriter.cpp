@@ -0,0 +1,224 @@
+#include "XmlStreamWriter.h"
+
+#include <algorithm>
+#include <charconv>
+
+#include <glib.h>
+
+#include "util/Util.h"
+
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+#define XOJ_HAS_FLOAT_TO_CHARS
+#endif
+
+/**
+ * The buffer is passed to the stream when it gets larger than this
+ */
+constexpr size_t FLUSH_SIZE = 64 * 1024;
+
+/**
+ * Digits after the decimal point, same as Util::PRECISION_FORMAT_STRING
+ */
+constexpr int PRECISION = 8;
+
+/**
+ * Input block size for Base64 encoding, a multiple of 3 so no padding is written in between
+ */
+constexpr size_t BASE64_BLOCK = 3 * 1024;
+
+XmlStreamWriter::XmlStreamWriter(OutputStream* out): out(out) { buffer.reserve(FLUSH_SIZE + 1024); }
+
+XmlStreamWriter::~XmlStreamWriter() { flush(); }
+
+void XmlStreamWriter::flush() {
+    if (!buffer.empty()) {
+        out->write(buffer.data(), static_cast<int>(buffer.size()));
+        buffer.clear();
+    }
+}
+
+void XmlStreamWriter::checkFlush() {
+    if (buffer.size() >= FLUSH_SIZE) {
+        flush();
+    }
+}
+
+void XmlStreamWriter::appendDouble(double value) {
+    char str[G_ASCII_DTOSTR_BUF_SIZE];
+#ifdef XOJ_HAS_FLOAT_TO_CHARS
+    // Same output as printf("%.8f") in the C locale
+    auto [ptr, ec] = std::to_chars(str, str + sizeof(str), value, std::chars_format::fixed, PRECISION);
+    if (ec == std::errc()) {
+        buffer.append(str, ptr);
+        return;
+    }
+#endif
+    // g_ascii_ version uses C locale always.
+    g_ascii_formatd(str, G_ASCII_DTOSTR_BUF_SIZE, Util::PRECISION_FORMAT_STRING, value);
+    buffer.append(str);
+}
+
+void XmlStreamWriter::appendEscaped(const std::string& value, bool attribute) {
+    for (char c: value) {
+        switch (c) {
+            case '&':
+                buffer.append("&amp;");
+                break;
+            case '<':
+                buffer.append("&lt;");
+                break;
+            case '>':
+                buffer.append("&gt;");
+                break;
+            case '\"':
+                if (attribute) {
+                    buffer.append("&quot;");
+                } else {
+                    buffer.push_back(c);
+                }
+                break;
+            case '\n':
+                if (attribute) {
+                    buffer.append("&#13;");
+                } else {
+                    buffer.push_back(c);
+                }
+                break;
+            default:
+                buffer.push_back(c);
+        }
+    }
+}
+
+void XmlStreamWriter::startElement(const char* tag) {
+    checkFlush();
+    buffer.push_back('<');
+    buffer.append(tag);
+}
+
+void XmlStreamWriter::attrib(const char* name, const char* value) {
+    buffer.push_back(' ');
+    buffer.append(name);
+    buffer.append("=\"");
+    if (value != nullptr) {
+        appendEscaped(value, true);
+    }
+    buffer.push_back('\"');
+}
+
+void XmlStreamWriter::attrib(const char* name, const std::string& value) {
+    buffer.push_back(' ');
+    buffer.append(name);
+    buffer.append("=\"");
+    appendEscaped(value, true);
+    buffer.push_back('\"');
+}
+
+void XmlStreamWriter::attrib(const char* name, double value) {
+    buffer.push_back(' ');
+    buffer.append(name);
+    buffer.append("=\"");
+    appendDouble(value);
+    buffer.push_back('\"');
+}
+
+void XmlStreamWriter::attrib(const char* name, int value) {
+    char str[16];
+    auto [ptr, ec] = std::to_chars(str, str + sizeof(str), value);
+
+    buffer.push_back(' ');
+    buffer.append(name);
+    buffer.append("=\"");
+    buffer.append(str, ptr);
+    buffer.push_back('\"');
+}
+
+void XmlStreamWriter::attrib(const char* name, size_t value) {
+    char str[24];
+    auto [ptr, ec] = std::to_chars(str, str + sizeof(str), value);
+
+    buffer.push_back(' ');
+    buffer.append(name);
+    buffer.append("=\"");
+    buffer.append(str, ptr);
+    buffer.push_back('\"');
+}
+
+void XmlStreamWriter::attrib(const char* name, double first, const double* values, size_t count) {
+    buffer.push_back(' ');
+    buffer.append(name);
+    buffer.append("=\"");
+    appendDouble(first);
+    for (size_t i = 0; i < count; i++) {
+        buffer.push_back(' ');
+        appendDouble(values[i]);
+        checkFlush();
+    }
+    buffer.push_back('\"');
+}
+
+void XmlStreamWriter::endEmptyElement() { buffer.append("/>\n"); }
+
+void XmlStreamWriter::startChildren() { buffer.append(">\n"); }
+
+void XmlStreamWriter::startContent() { buffer.push_back('>'); }
+
+void XmlStreamWriter::endElement(const char* tag) {
+    buffer.append("</");
+    buffer.append(tag);
+    buffer.append(">\n");
+}
+
+void XmlStreamWriter::text(const std::string& text) {
+    appendEscaped(text, false);
+    checkFlush();
+}
+
+void XmlStreamWriter::coordinates(const double* xs, const double* ys, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        if (i != 0) {
+            buffer.push_back(' ');
+        }
+        appendDouble(xs[i]);
+        buffer.push_back(' ');
+        appendDouble(ys[i]);
+        checkFlush();
+    }
+}
+
+void XmlStreamWriter::base64Step(const char* data, size_t length) {
+    // Encoded size of one block, plus the bytes kept in the encoder state
+    char encoded[BASE64_BLOCK / 3 * 4 + 8];
+
+    for (size_t offset = 0; offset < length; offset += BASE64_BLOCK) {
+        size_t len = std::min(BASE64_BLOCK, length - offset);
+        gsize written = g_base64_encode_step(reinterpret_cast<const guchar*>(data + offset), len, false, encoded,
+                                             &base64State, &base64Save);
+        buffer.append(encoded, written);
+        checkFlush();
+    }
+}
+
+void XmlStreamWriter::base64Close() {
+    char encoded[8];
+    gsize written = g_base64_encode_close(false, encoded, &base64State, &base64Save);
+    buffer.append(encoded, written);
+    base64State = 0;
+    base64Save = 0;
+}
+
+void XmlStreamWriter::base64(const char* data, size_t length) {
+    base64Step(data, length);
+    base64Close();
+}
+
+auto XmlStreamWriter::pngWriteFunction(XmlStreamWriter* writer, const unsigned char* data, unsigned int length)
+        -> cairo_status_t {
+    writer->base64Step(reinterpret_cast<const char*>(data), length);
+    return CAIRO_STATUS_SUCCESS;
+}
+
+void XmlStreamWriter::base64Png(cairo_surface_t* img) {
+    cairo_surface_write_to_png_stream(img, reinterpret_cast<cairo_write_func_t>(&pngWriteFunction), this);
+    base64Close();
+}
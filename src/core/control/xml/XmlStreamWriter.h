@@ -0,0 +1,120 @@
+/*
+ * Xournal++
+ *
+ * Writes XML directly to an output stream
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include <cairo.h>
+
+#include "util/OutputStream.h"
+
+/**
+ * Serializes elements and attributes straight into an OutputStream, without building a tree first.
+ * The output is collected in a reusable buffer, which is passed to the stream in large blocks.
+ *
+ * An element is written by calling startElement(), the attrib() methods, and then either
+ * endEmptyElement(), startChildren() or startContent(), followed by endElement().
+ */
+class XmlStreamWriter {
+public:
+    explicit XmlStreamWriter(OutputStream* out);
+    ~XmlStreamWriter();
+
+    XmlStreamWriter(const XmlStreamWriter&) = delete;
+    XmlStreamWriter& operator=(const XmlStreamWriter&) = delete;
+
+public:
+    /**
+     * Writes "<tag"
+     */
+    void startElement(const char* tag);
+
+    void attrib(const char* name, const char* value);
+    void attrib(const char* name, const std::string& value);
+    void attrib(const char* name, double value);
+    void attrib(const char* name, int value);
+    void attrib(const char* name, size_t value);
+
+    /**
+     * Writes first and the count values as space separated list
+     */
+    void attrib(const char* name, double first, const double* values, size_t count);
+
+    /**
+     * Closes an element without content: "/>\n"
+     */
+    void endEmptyElement();
+
+    /**
+     * Closes the start tag of an element containing other elements: ">\n"
+     */
+    void startChildren();
+
+    /**
+     * Closes the start tag of an element containing text or data: ">"
+     */
+    void startContent();
+
+    /**
+     * Writes "</tag>\n"
+     */
+    void endElement(const char* tag);
+
+    /**
+     * Writes escaped text content
+     */
+    void text(const std::string& text);
+
+    /**
+     * Writes the coordinates as "x0 y0 x1 y1 ..."
+     */
+    void coordinates(const double* xs, const double* ys, size_t count);
+
+    /**
+     * Writes the data Base64 encoded
+     */
+    void base64(const char* data, size_t length);
+
+    /**
+     * Writes the image as Base64 encoded PNG
+     */
+    void base64Png(cairo_surface_t* img);
+
+    /**
+     * Passes the buffered output to the stream
+     */
+    void flush();
+
+private:
+    void appendDouble(double value);
+    void appendEscaped(const std::string& value, bool attribute);
+    void checkFlush();
+    void base64Step(const char* data, size_t length);
+    void base64Close();
+
+    static cairo_status_t pngWriteFunction(XmlStreamWriter* writer, const unsigned char* data, unsigned int length);
+
+private:
+    OutputStream* out;
+
+    /**
+     * Formatted output not yet written to out
+     */
+    std::string buffer;
+
+    /**
+     * Base64 encoder state, see g_base64_encode_step
+     */
+    int base64State = 0;
+    int base64Save = 0;
+};
@@ -1,23 +1,43 @@
 #include "LoadHandler.h"
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <cstdlib>
+#include <functional>
+#include <memory>
+#include <string_view>
 #include <utility>
 
 #include <config.h>
 #include <glib/gstdio.h>
 #include <gtk/gtk.h>
 
+#include "control/jobs/Scheduler.h"
 #include "control/pagetype/PageTypeHandler.h"
 #include "model/BackgroundImage.h"
 #include "model/StrokeStyle.h"
 #include "model/XojPage.h"
 #include "util/GzUtil.h"
+#include "util/NumberParser.h"
+#include "util/Util.h"
+#include "util/XojMsgBox.h"
 #include "util/i18n.h"
 
 #include "LoadHandlerHelper.h"
 
 using std::string;
 
+/**
+ * Size of the blocks read from the content file and passed to the XML parser
+ */
+constexpr size_t CONTENT_BLOCK_SIZE = 512 * 1024;
+
+/**
+ * The complete pages are parsed when they reach this size, so the content is not kept in memory as a whole
+ */
+constexpr size_t PAGE_BATCH_SIZE = 16 * 1024 * 1024;
+
 #define error2(var, ...)                                                                \
     if (var == nullptr) {                                                               \
         var = g_error_new(G_MARKUP_ERROR, G_MARKUP_ERROR_INVALID_CONTENT, __VA_ARGS__); \
@@ -79,6 +99,7 @@ void LoadHandler::initAttributes() {
     this->teximage = nullptr;
     this->text = nullptr;
     this->pages.clear();
+    this->clonedBackgrounds.clear();
 
     if (this->audioFiles) {
         g_hash_table_unref(this->audioFiles);
@@ -108,6 +129,9 @@ auto LoadHandler::openFile(fs::path const& filepath) -> bool {
     if (!this->zipFp && zipError == ZIP_ER_NOZIP) {
         this->gzFp = GzUtil::openPath(filepath, "r");
         this->isGzFile = true;
+        if (this->gzFp) {
+            gzbuffer(this->gzFp, CONTENT_BLOCK_SIZE);
+        }
     }
 
     if (this->zipFp && !this->isGzFile) {
@@ -190,6 +214,379 @@ auto LoadHandler::readContentFile(char* buffer, zip_uint64_t len) -> zip_int64_t
     return -1;
 }
 
+auto LoadHandler::readContentBlock(string& buffer) -> bool {
+    // Read directly into the string
+    size_t offset = buffer.size();
+    buffer.resize(offset + CONTENT_BLOCK_SIZE);
+    zip_int64_t len = readContentFile(buffer.data() + offset, CONTENT_BLOCK_SIZE);
+    buffer.resize(offset + static_cast<size_t>(std::max<zip_int64_t>(len, 0)));
+    return len > 0;
+}
+
+static auto isSpace(char c) -> bool { return c == ' ' || c == '\n' || c == '\t' || c == '\r'; }
+
+/**
+ * @return true if c ends the name of an element
+ */
+static auto isNameEnd(char c) -> bool { return isSpace(c) || c == '>' || c == '/'; }
+
+/**
+ * @return The position of the first <page> element, or npos if content does not contain one (yet)
+ */
+static auto findFirstPage(const string& content) -> size_t {
+    for (size_t pos = 0; (pos = content.find("<page", pos)) != string::npos; pos += 5) {
+        if (pos + 5 < content.size() && isNameEnd(content[pos + 5])) {
+            return pos;
+        }
+    }
+    return string::npos;
+}
+
+/**
+ * Finds the complete <page> elements of the document from pos on, for parsing them separately.
+ * Text and attribute values cannot contain a raw '<', so a plain search is enough as long as the pages contain
+ * no comments or CDATA sections.
+ *
+ * @param ranges The ranges [begin, end) of the page elements are appended
+ * @param searched The size of content when it was searched the last time. The end of an incomplete page is
+ *                 searched for in the new part only, so a large page is not searched again after each block.
+ * @return true if the end of content was reached, it may continue with more pages. false if the pages end or
+ *         cannot be split safely, e.g. if there is anything but whitespace between the pages.
+ */
+static auto findPageRanges(const string& content, size_t pos, std::vector<std::pair<size_t, size_t>>& ranges,
+                           size_t searched) -> bool {
+    constexpr const char* pageEnd = "</page>";
+    // The closing tag may start in the part which was searched already
+    size_t searchFrom = searched - std::min(searched, strlen(pageEnd) - 1);
+    while (true) {
+        while (pos < content.size() && isSpace(content[pos])) { pos++; }
+        if (pos + 5 >= content.size()) {
+            return true;
+        }
+        if (content.compare(pos, 5, "<page") != 0 || !isNameEnd(content[pos + 5])) {
+            return false;
+        }
+
+        size_t tagEnd = content.find('>', pos);
+        size_t end = content.find(pageEnd, std::max(pos, searchFrom));
+        if (tagEnd == string::npos || end == string::npos) {
+            return true;
+        }
+        end += strlen(pageEnd);
+        // Self-closing pages, comments and CDATA sections
+        if (content[tagEnd - 1] == '/' || std::string_view(content).substr(pos, end - pos).find("<!") != string::npos) {
+            return false;
+        }
+
+        ranges.emplace_back(pos, end);
+        pos = end;
+    }
+}
+
+void LoadHandler::initPageParser(LoadHandler& root) {
+    this->rootHandler = &root;
+    this->filepath = root.filepath;
+    this->xournalFilepath = root.xournalFilepath;
+    this->isGzFile = root.isGzFile;
+    this->fileVersion = root.fileVersion;
+    this->creator = root.creator;
+    this->removePdfBackgroundFlag = root.removePdfBackgroundFlag;
+}
+
+auto LoadHandler::parsePageElement(const char* data, size_t len) -> PageRef {
+    const GMarkupParser parser = {LoadHandler::parserStartElement, LoadHandler::parserEndElement,
+                                  LoadHandler::parserText, nullptr, nullptr};
+    this->error = nullptr;
+    this->pos = PARSER_POS_STARTED;
+
+    GMarkupParseContext* context =
+            g_markup_parse_context_new(&parser, static_cast<GMarkupParseFlags>(0), this, nullptr);
+    if (g_markup_parse_context_parse(context, data, static_cast<gssize>(len), &error)) {
+        g_markup_parse_context_end_parse(context, &error);
+    }
+    g_markup_parse_context_free(context);
+
+    PageRef page = this->pages.empty() ? nullptr : this->pages.back();
+    this->pages.clear();
+    return page;
+}
+
+/**
+ * Parses the pages of a batch on the calling thread and on the workers of the scheduler, see
+ * LoadHandler::parsePagesParallel
+ */
+class PageBatch {
+public:
+    explicit PageBatch(std::function<void()> parse): parse(std::move(parse)) {}
+
+    /**
+     * Helps to parse the pages, unless the batch is finished already. Called by the workers.
+     */
+    void help() {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            if (this->finished) {
+                return;
+            }
+            this->active++;
+        }
+        this->parse();
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->active--;
+        }
+        this->done.notify_all();
+    }
+
+    /**
+     * Parses the remaining pages on the calling thread and waits until the workers are done with their pages
+     */
+    void finish() {
+        this->parse();
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->finished = true;
+        this->done.wait(lock, [this]() { return this->active == 0; });
+    }
+
+private:
+    /**
+     * Parses pages until none is left, refers to the state of parsePagesParallel, so it is not called after finish()
+     */
+    std::function<void()> parse;
+
+    std::mutex mutex;
+    std::condition_variable done;
+    int active = 0;
+    bool finished = false;
+};
+
+/**
+ * Lets a worker of the scheduler help to parse a PageBatch
+ */
+class ParsePagesJob: public Job {
+public:
+    explicit ParsePagesJob(std::shared_ptr<PageBatch> batch): batch(std::move(batch)) {}
+
+    auto getType() -> JobType override { return JOB_TYPE_PARSE; }
+
+protected:
+    void run() override { this->batch->help(); }
+
+private:
+    std::shared_ptr<PageBatch> batch;
+};
+
+auto LoadHandler::parsePagesParallel(const string& content, const std::vector<std::pair<size_t, size_t>>& ranges)
+        -> bool {
+    std::vector<PageRef> parsedPages(ranges.size());
+    std::vector<GError*> errors(ranges.size(), nullptr);
+    std::atomic<size_t> nextPage{0};
+    std::atomic<bool> failed{false};
+
+    auto parse = [&]() {
+        LoadHandler pageHandler;
+        pageHandler.initPageParser(*this);
+
+        for (size_t i = nextPage++; i < ranges.size() && !failed; i = nextPage++) {
+            parsedPages[i] = pageHandler.parsePageElement(content.data() + ranges[i].first,
+                                                          ranges[i].second - ranges[i].first);
+            if (pageHandler.error) {
+                errors[i] = pageHandler.error;
+                pageHandler.error = nullptr;
+                failed = true;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(this->clonedBackgroundsMutex);
+        this->clonedBackgrounds.insert(this->clonedBackgrounds.end(), pageHandler.clonedBackgrounds.begin(),
+                                       pageHandler.clonedBackgrounds.end());
+    };
+
+    // The workers only help, the calling thread parses all pages which are not taken by a worker. So loading
+    // does not wait for the jobs which run before, and works without a running scheduler.
+    auto batch = std::make_shared<PageBatch>(parse);
+    if (this->scheduler && ranges.size() > 1) {
+        size_t jobCount = std::min<size_t>(this->scheduler->getWorkerCount(), ranges.size() - 1);
+        for (size_t i = 0; i < jobCount; i++) {
+            auto* job = new ParsePagesJob(batch);
+            this->scheduler->addJob(job, JOB_PRIORITY_URGENT);
+            job->unref();
+        }
+    }
+    batch->finish();
+
+    // Report the error of the first broken page, as the serial parser would
+    for (GError*& pageError: errors) {
+        if (pageError == nullptr) {
+            continue;
+        }
+        if (this->error == nullptr) {
+            this->error = pageError;
+        } else {
+            g_error_free(pageError);
+        }
+    }
+    if (this->error) {
+        return false;
+    }
+
+    this->pages.insert(this->pages.end(), parsedPages.begin(), parsedPages.end());
+    return true;
+}
+
+/**
+ * The file information and the attachments of a lazily loaded document, kept until all pages are loaded
+ */
+struct LazyPageSource {
+    LazyPageSource(LoadHandler& loader);
+    ~LazyPageSource();
+
+    /**
+     * Provides the file information and the attachments to the page parsers
+     */
+    LoadHandler root;
+};
+
+LazyPageSource::LazyPageSource(LoadHandler& loader) {
+    root.filepath = loader.filepath;
+    root.xournalFilepath = loader.xournalFilepath;
+    root.isGzFile = loader.isGzFile;
+    root.fileVersion = loader.fileVersion;
+    root.creator = loader.creator;
+
+    g_hash_table_unref(root.audioFiles);
+    root.audioFiles = g_hash_table_ref(loader.audioFiles);
+
+    if (!root.isGzFile) {
+        // A separate handle, the one of the loader is closed after loading
+        int zipError = 0;
+        root.zipFp = zip_open(root.filepath.u8string().c_str(), ZIP_RDONLY, &zipError);
+    }
+}
+
+LazyPageSource::~LazyPageSource() {
+    if (root.zipFp) {
+        zip_close(root.zipFp);
+    }
+}
+
+void LoadHandler::setLazyPageLoading(bool lazy) { this->lazyPageLoading = lazy; }
+
+void LoadHandler::setScheduler(Scheduler* scheduler) { this->scheduler = scheduler; }
+
+/**
+ * @return The position of the first <layer> element of the page in [begin, end), or the position of the closing
+ *         page tag if the page has no layers or its background follows the layers
+ */
+static auto findLayersBegin(const string& content, size_t begin, size_t end) -> size_t {
+    size_t layersEnd = end - strlen("</page>");
+    size_t pos = begin;
+    while ((pos = content.find("<layer", pos)) < layersEnd) {
+        char c = content[pos + 6];
+        if (c == ' ' || c == '>' || c == '/' || c == '\n' || c == '\t' || c == '\r') {
+            break;
+        }
+        pos += 6;
+    }
+    if (pos >= layersEnd || content.find("<background", pos) < layersEnd) {
+        return layersEnd;
+    }
+    return pos;
+}
+
+/**
+ * Checks that the <layer> elements of a page are well-formed XML, without creating the elements
+ */
+static auto checkLayers(const char* data, size_t len, GError** error) -> bool {
+    const GMarkupParser parser = {nullptr, nullptr, nullptr, nullptr, nullptr};
+    constexpr const char* placeholderBegin = "<layers>";
+    constexpr const char* placeholderEnd = "</layers>";
+
+    GMarkupParseContext* context =
+            g_markup_parse_context_new(&parser, static_cast<GMarkupParseFlags>(0), nullptr, nullptr);
+    bool valid = g_markup_parse_context_parse(context, placeholderBegin, strlen(placeholderBegin), error) &&
+                 g_markup_parse_context_parse(context, data, static_cast<gssize>(len), error) &&
+                 g_markup_parse_context_parse(context, placeholderEnd, strlen(placeholderEnd), error) &&
+                 g_markup_parse_context_end_parse(context, error);
+    g_markup_parse_context_free(context);
+    return valid;
+}
+
+auto LoadHandler::parsePagesLazy(GMarkupParseContext* context, const string& text,
+                                 const std::vector<std::pair<size_t, size_t>>& ranges) -> bool {
+    auto parse = [&](const char* data, size_t len) {
+        return g_markup_parse_context_parse(context, data, static_cast<gssize>(len), &error) != 0 &&
+               this->error == nullptr;
+    };
+
+    if (!this->lazySource) {
+        // The header is parsed now, with the file version and the audio attachments
+        this->lazySource = std::make_shared<LazyPageSource>(*this);
+    }
+
+    constexpr const char* pageEnd = "</page>";
+    for (auto [begin, end]: ranges) {
+        size_t layersBegin = findLayersBegin(text, begin, end);
+        size_t layersEnd = end - strlen(pageEnd);
+
+        // Only the page element and its background are parsed now, the layers when they are accessed. They are
+        // checked now, so a broken file is reported when it is opened, as without lazy loading.
+        if (!parse(text.data() + begin, layersBegin - begin) || !parse(pageEnd, strlen(pageEnd)) ||
+            !checkLayers(text.data() + layersBegin, layersEnd - layersBegin, &error)) {
+            return false;
+        }
+        if (layersBegin < layersEnd) {
+            // Each page keeps only its own text, which is released as soon as the page is loaded
+            auto layers = std::make_shared<const string>(text, layersBegin, layersEnd - layersBegin);
+            this->pages.back()->setContentLoader([source = this->lazySource, layers](std::vector<Layer*>& result) {
+                LoadHandler pageHandler;
+                pageHandler.initPageParser(source->root);
+                return pageHandler.parseLayers(layers->data(), layers->size(), result);
+            });
+        }
+    }
+
+    return true;
+}
+
+auto LoadHandler::parseLayers(const char* data, size_t len, std::vector<Layer*>& layers) -> bool {
+    const GMarkupParser parser = {LoadHandler::parserStartElement, LoadHandler::parserEndElement,
+                                  LoadHandler::parserText, nullptr, nullptr};
+    this->error = nullptr;
+    auto layerPage = std::make_shared<XojPage>(0, 0);
+    this->page = layerPage;
+    this->pos = PARSER_POS_IN_PAGE;
+
+    // GMarkup expects a single root element, the layers are parsed as children of a placeholder element
+    constexpr const char* placeholderBegin = "<layers>";
+    constexpr const char* placeholderEnd = "</layers>";
+
+    GMarkupParseContext* context =
+            g_markup_parse_context_new(&parser, static_cast<GMarkupParseFlags>(0), this, nullptr);
+    bool valid = g_markup_parse_context_parse(context, placeholderBegin, strlen(placeholderBegin), &error) &&
+                 g_markup_parse_context_parse(context, data, static_cast<gssize>(len), &error) &&
+                 g_markup_parse_context_parse(context, placeholderEnd, strlen(placeholderEnd), &error) &&
+                 g_markup_parse_context_end_parse(context, &error);
+    g_markup_parse_context_free(context);
+    // The element handlers report errors in error, without failing the parser
+    valid = valid && error == nullptr;
+
+    if (!valid) {
+        string message = FS(_F("Could not load a page of \"{1}\": {2}\nThe page is shown incomplete. The document "
+                               "cannot be saved, so the file keeps the content of the page.") %
+                            this->xournalFilepath.u8string() % (error ? error->message : _("Unknown parser error")));
+        g_warning("%s", message.c_str());
+        Util::execInUiThread([message]() { XojMsgBox::showErrorToUser(nullptr, message); });
+    }
+    if (error) {
+        g_error_free(error);
+        error = nullptr;
+    }
+
+    layers.swap(layerPage->layer);
+    return valid;
+}
+
 auto LoadHandler::parseXml() -> bool {
     const GMarkupParser parser = {LoadHandler::parserStartElement, LoadHandler::parserEndElement,
                                   LoadHandler::parserText, nullptr, nullptr};
@@ -202,21 +599,63 @@ auto LoadHandler::parseXml() -> bool {
 
     GMarkupParseContext* context =
             g_markup_parse_context_new(&parser, static_cast<GMarkupParseFlags>(0), this, nullptr);
+    auto parse = [&](const char* data, size_t len) {
+        return g_markup_parse_context_parse(context, data, static_cast<gssize>(len), &error) != 0 &&
+               this->error == nullptr;
+    };
+
+    // The content is read in blocks, only the part which is not parsed yet is kept
+    string buffer;
+    bool more = readContentBlock(buffer);
+
+    // The header is parsed first, it contains the file version and the audio attachments
+    size_t headerEnd = string::npos;
+    while ((headerEnd = findFirstPage(buffer)) == string::npos && more) { more = readContentBlock(buffer); }
+    bool splitPages = headerEnd != string::npos;
+    if (splitPages) {
+        valid = parse(buffer.data(), headerEnd) && this->pos == PARSER_POS_STARTED;
+        buffer.erase(0, headerEnd);
+    }
 
-    zip_int64_t len = 0;
-    do {
-        char buffer[1024];
-        len = readContentFile(buffer, sizeof(buffer));
-        if (len > 0) {
-            valid = g_markup_parse_context_parse(context, buffer, len, &error);
+    // The pages are parsed separately, in batches of complete pages: lazily, or on all cores
+    std::vector<std::pair<size_t, size_t>> pageRanges;
+    size_t searched = 0;
+    while (valid && splitPages) {
+        bool morePages =
+                findPageRanges(buffer, pageRanges.empty() ? 0 : pageRanges.back().second, pageRanges, searched);
+        searched = buffer.size();
+        size_t batchEnd = pageRanges.empty() ? 0 : pageRanges.back().second;
+        if (morePages && more && batchEnd < PAGE_BATCH_SIZE) {
+            more = readContentBlock(buffer);
+            continue;
         }
 
-        if (error) {
-            g_warning("LoadHandler::parseXml: %s\n", error->message);
-            valid = false;
+        if (!pageRanges.empty()) {
+            valid = this->lazyPageLoading ? parsePagesLazy(context, buffer, pageRanges) :
+                                            parsePagesParallel(buffer, pageRanges);
+            buffer.erase(0, batchEnd);
+            searched -= batchEnd;
+            pageRanges.clear();
+        }
+        splitPages = morePages && more;
+    }
+
+    // The rest is parsed as a stream, e.g. the end of the document or all of a document which cannot be split
+    while (valid) {
+        if (!buffer.empty()) {
+            valid = parse(buffer.data(), buffer.size());
+            buffer.clear();
+        }
+        if (!more) {
             break;
         }
-    } while (len >= 0 && valid && !error);
+        more = readContentBlock(buffer);
+    }
+
+    if (error) {
+        g_warning("LoadHandler::parseXml: %s\n", error->message);
+        valid = false;
+    }
 
     if (valid) {
         valid = g_markup_parse_context_end_parse(context, &error);
@@ -231,6 +670,10 @@ auto LoadHandler::parseXml() -> bool {
     }
 
     g_markup_parse_context_free(context);
+    // The pages keep the source as long as they need it
+    this->lazySource.reset();
+
+    resolveClonedBackgrounds();
 
     // Add all parsed pages to the document
     this->doc.addPages(pages.begin(), pages.end());
@@ -390,11 +833,8 @@ void LoadHandler::parseBgPixmap() {
         if (endptr == filename.c_str()) {
             error("%s", FC(_F("Could not read page number for cloned background image: {1}.") % filepath.string()));
         }
-        PageRef p = pages[nr];
-
-        if (p) {
-            this->page->setBackgroundImage(p->getBackgroundImage());
-        }
+        // The page may be parsed by another thread, the image is assigned once all pages are parsed
+        this->clonedBackgrounds.emplace_back(this->page, nr);
     } else {
         error("%s", FC(_F("Unknown pixmap::domain type: {1}") % domain));
     }
@@ -402,6 +842,17 @@ void LoadHandler::parseBgPixmap() {
     this->page->setBackgroundType(PageType(PageTypeFormat::Image));
 }
 
+void LoadHandler::resolveClonedBackgrounds() {
+    for (auto& [clone, nr]: this->clonedBackgrounds) {
+        if (nr < pages.size() && pages[nr]) {
+            clone->setBackgroundImage(pages[nr]->getBackgroundImage());
+        } else {
+            g_warning("%s", FC(_F("Cloned background image refers to missing page {1}") % nr));
+        }
+    }
+    this->clonedBackgrounds.clear();
+}
+
 void LoadHandler::parseBgPdf() {
     int pageno = LoadHandlerHelper::getAttribInt("pageno", this);
     bool attachToDocument = false;
@@ -409,9 +860,12 @@ void LoadHandler::parseBgPdf() {
 
     this->page->setBackgroundPdfPageNr(pageno - 1);
 
-    if (!this->pdfFilenameParsed) {
+    // The PDF is loaded only once, into the document of the root handler, also if the pages are parsed in parallel
+    LoadHandler& root = *this->rootHandler;
+    std::lock_guard<std::mutex> lock(root.pdfMutex);
+    if (!root.pdfFilenameParsed) {
 
-        if (this->pdfReplacementFilepath.empty()) {
+        if (root.pdfReplacementFilepath.empty()) {
             const char* domain = LoadHandlerHelper::getAttrib("domain", false, this);
             {
                 const char* sFilename = LoadHandlerHelper::getAttrib("filename", false, this);
@@ -425,12 +879,12 @@ void LoadHandler::parseBgPdf() {
             if (!strcmp("absolute", domain))  // Absolute OR relative path
             {
                 if (pdfFilename.is_relative()) {
-                    pdfFilename = xournalFilepath.remove_filename() / pdfFilename;
+                    pdfFilename = root.xournalFilepath.remove_filename() / pdfFilename;
                 }
             } else if (!strcmp("attach", domain)) {
                 // Handle old format separately
                 if (this->isGzFile) {
-                    pdfFilename = (fs::path{xournalFilepath} += ".") += pdfFilename;
+                    pdfFilename = (fs::path{root.xournalFilepath} += ".") += pdfFilename;
                 } else {
                     gpointer data = nullptr;
                     gsize dataLength = 0;
@@ -439,13 +893,13 @@ void LoadHandler::parseBgPdf() {
                         return;
                     }
 
-                    doc.readPdf(pdfFilename, false, attachToDocument, data, dataLength);
+                    root.doc.readPdf(pdfFilename, false, attachToDocument, data, dataLength);
 
-                    if (!doc.getLastErrorMsg().empty()) {
-                        error("%s", FC(_F("Error reading PDF: {1}") % doc.getLastErrorMsg()));
+                    if (!root.doc.getLastErrorMsg().empty()) {
+                        error("%s", FC(_F("Error reading PDF: {1}") % root.doc.getLastErrorMsg()));
                     }
 
-                    this->pdfFilenameParsed = true;
+                    root.pdfFilenameParsed = true;
                     return;
                 }
             } else {
@@ -453,22 +907,22 @@ void LoadHandler::parseBgPdf() {
                 return;
             }
         } else {
-            pdfFilename = this->pdfReplacementFilepath;
-            attachToDocument = this->pdfReplacementAttach;
+            pdfFilename = root.pdfReplacementFilepath;
+            attachToDocument = root.pdfReplacementAttach;
         }
 
-        this->pdfFilenameParsed = true;
+        root.pdfFilenameParsed = true;
 
         if (fs::is_regular_file(pdfFilename)) {
-            doc.readPdf(pdfFilename, false, attachToDocument);
-            if (!doc.getLastErrorMsg().empty()) {
-                error("%s", FC(_F("Error reading PDF: {1}") % doc.getLastErrorMsg()));
+            root.doc.readPdf(pdfFilename, false, attachToDocument);
+            if (!root.doc.getLastErrorMsg().empty()) {
+                error("%s", FC(_F("Error reading PDF: {1}") % root.doc.getLastErrorMsg()));
             }
         } else {
             if (attachToDocument) {
-                this->attachedPdfMissing = true;
+                root.attachedPdfMissing = true;
             } else {
-                this->pdfMissing = pdfFilename.u8string();
+                root.pdfMissing = pdfFilename.u8string();
             }
         }
     }
@@ -530,15 +984,7 @@ void LoadHandler::parseStroke() {
         pressure = endPtr;
     }
 
-    while (*pressure != 0) {
-        char* tmpptr = nullptr;
-        double val = g_ascii_strtod(pressure, &tmpptr);
-        if (tmpptr == pressure) {
-            break;
-        }
-        pressure = tmpptr;
-        this->pressureBuffer.push_back(val);
-    }
+    xoj::util::parseDoubles(pressure, pressure + strlen(pressure), this->pressureBuffer);
 
     Color color{0U};
     const char* sColor = LoadHandlerHelper::getAttrib("color", false, this);
@@ -715,6 +1161,8 @@ void LoadHandler::parseAttachment() {
             break;
         }
         case PARSER_POS_IN_TEXIMAGE: {
+            // A PDF is opened by poppler, see readTexImage
+            std::lock_guard<std::mutex> lock(this->rootHandler->pdfMutex);
             this->teximage->loadData(std::move(imgData), nullptr);
             break;
         }
@@ -898,30 +1346,17 @@ void LoadHandler::parserText(GMarkupParseContext* context, const gchar* text, gs
 
     auto* handler = static_cast<LoadHandler*>(userdata);
     if (handler->pos == PARSER_POS_IN_STROKE) {
-        const char* ptr = text;
-        int n = 0;
-
-        bool xRead = false;
-        double x = 0;
-
-        while (textLen > 0) {
-            double tmp = g_ascii_strtod(text, const_cast<char**>(&ptr));
-            if (ptr == text) {
-                break;
-            }
-            textLen -= (ptr - text);
-            text = ptr;
-            n++;
-
-            if (!xRead) {
-                xRead = true;
-                x = tmp;
-            } else {
-                xRead = false;
-                handler->stroke->addPoint(Point(x, tmp));
-            }
-        }
-        handler->stroke->freeUnusedPointItems();
+        // Parse all coordinates at once, the buffer keeps its capacity for the next strokes
+        auto& coordinates = handler->coordinateBuffer;
+        coordinates.clear();
+        coordinates.reserve(textLen / 2 + 1);
+        xoj::util::parseDoubles(text, text + textLen, coordinates);
+        auto n = coordinates.size();
+
+        StrokePoints points;
+        points.reserve(n / 2);
+        for (size_t i = 0; i + 1 < n; i += 2) { points.push_back(Point(coordinates[i], coordinates[i + 1])); }
+        handler->stroke->setPoints(std::move(points));
 
         if (n < 4 || (n & 1)) {
             error2(*error, "%s", FC(_F("Wrong count of points ({1})") % n));
@@ -978,6 +1413,9 @@ void LoadHandler::readTexImage(const gchar* base64string, gsize base64stringLen)
         return;
     }
 
+    // A PDF is opened by poppler, which is not thread-safe, while the pages are parsed in parallel. The PNG images
+    // are decoded by cairo into their own surface, images and audio attachments only keep their data or filename.
+    std::lock_guard<std::mutex> lock(this->rootHandler->pdfMutex);
     this->teximage->loadData(parseBase64(const_cast<char*>(base64string), base64stringLen));
 }
 
@@ -1021,11 +1459,15 @@ auto LoadHandler::loadDocument(fs::path const& filepath) -> Document* {
 // Todo(fabian): return data and length by value not by reference, to ensure data and length is assigned always
 //      return string not a pointer. Ownage is not clear!
 auto LoadHandler::readZipAttachment(fs::path const& filename, gpointer& data, gsize& length) -> bool {
+    // libzip archives must not be used from multiple threads at once
+    std::lock_guard<std::mutex> lock(this->rootHandler->zipMutex);
+    zip_t* zipFp = this->rootHandler->zipFp;
+
     zip_stat_t attachmentFileStat;
-    int statStatus = zip_stat(this->zipFp, filename.u8string().c_str(), 0, &attachmentFileStat);
+    int statStatus = zip_stat(zipFp, filename.u8string().c_str(), 0, &attachmentFileStat);
     if (statStatus != 0) {
         error("%s", FC(_F("Could not open attachment: {1}. Error message: {2}") % filename.string() %
-                       zip_error_strerror(zip_get_error(this->zipFp))));
+                       zip_error_strerror(zip_get_error(zipFp))));
         return false;
     }
 
@@ -1037,11 +1479,11 @@ auto LoadHandler::readZipAttachment(fs::path const& filename, gpointer& data, gs
         return false;
     }
 
-    zip_file_t* attachmentFile = zip_fopen(this->zipFp, filename.u8string().c_str(), 0);
+    zip_file_t* attachmentFile = zip_fopen(zipFp, filename.u8string().c_str(), 0);
 
     if (!attachmentFile) {
         error("%s", FC(_F("Could not open attachment: {1}. Error message: {2}") % filename.string() %
-                       zip_error_strerror(zip_get_error(this->zipFp))));
+                       zip_error_strerror(zip_get_error(zipFp))));
         return false;
     }
 
@@ -1066,7 +1508,8 @@ auto LoadHandler::readZipAttachment(fs::path const& filename, gpointer& data, gs
 }
 
 auto LoadHandler::getTempFileForPath(fs::path const& filename) -> fs::path {
-    gpointer tmpFilename = g_hash_table_lookup(this->audioFiles, filename.u8string().c_str());
+    // The audio files are only added while parsing the document header, so they can be read without locking
+    gpointer tmpFilename = g_hash_table_lookup(this->rootHandler->audioFiles, filename.u8string().c_str());
     if (tmpFilename) {
         return string(static_cast<char*>(tmpFilename));
     }
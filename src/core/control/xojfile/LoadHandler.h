@@ -11,8 +11,11 @@
 
 #pragma once
 
+#include <memory>
+#include <mutex>
 #include <regex>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <zip.h>
@@ -26,6 +29,8 @@
 
 #include "LoadHandlerHelper.h"
 
+class Scheduler;
+struct LazyPageSource;
 
 enum ParserPosition {
     PARSER_POS_NOT_STARTED = 1,  // Waiting for opening <xounal> tag
@@ -52,6 +57,18 @@ public:
     bool isAttachedPdfMissing() const;
     std::string getMissingPdfFilename();
 
+    /**
+     * Only parse the page sizes and backgrounds when loading. The layers of a page are parsed when they are
+     * accessed for the first time, e.g. when the page is shown, searched, exported or saved.
+     */
+    void setLazyPageLoading(bool lazy);
+
+    /**
+     * The pages of a document which is not loaded lazily are parsed on the workers of scheduler, besides the
+     * calling thread. Without a scheduler they are parsed on the calling thread only.
+     */
+    void setScheduler(Scheduler* scheduler);
+
     void removePdfBackground();
     void setPdfReplacement(fs::path filepath, bool attachToDocument);
 
@@ -77,8 +94,48 @@ private:
     zip_int64_t readContentFile(char* buffer, zip_uint64_t len);
     bool closeFile();
     bool openFile(fs::path const& filepath);
+
+    /**
+     * Appends the next block of the content file to buffer
+     * @return false at the end of the file
+     */
+    bool readContentBlock(std::string& buffer);
+
     bool parseXml();
 
+    /**
+     * Parses the <page> elements in ranges of content, in parallel on the scheduler, and appends them to pages.
+     * The elements are created off the main thread, see readTexImage.
+     */
+    bool parsePagesParallel(const std::string& content, const std::vector<std::pair<size_t, size_t>>& ranges);
+
+    /**
+     * Prepares this handler to parse single pages of the document loaded by root
+     */
+    void initPageParser(LoadHandler& root);
+
+    /**
+     * Parses a single <page> element
+     * @return The page, or nullptr on error
+     */
+    PageRef parsePageElement(const char* data, size_t len);
+
+    /**
+     * Parses the page backgrounds of the pages in ranges of content, and defers their layers to
+     * XojPage::setContentLoader. The header of the document needs to be parsed before.
+     */
+    bool parsePagesLazy(GMarkupParseContext* context, const std::string& content,
+                        const std::vector<std::pair<size_t, size_t>>& ranges);
+
+    /**
+     * Parses the <layer> elements of a page
+     *
+     * @return false if the layers could not be parsed completely, the error is reported to the user
+     */
+    bool parseLayers(const char* data, size_t len, std::vector<Layer*>& layers);
+
+    void resolveClonedBackgrounds();
+
     static void parserText(GMarkupParseContext* context, const gchar* text, gsize textLen, gpointer userdata,
                            GError** error);
     static void parserEndElement(GMarkupParseContext* context, const gchar* elementName, gpointer userdata,
@@ -109,6 +166,8 @@ private:
     bool attachedPdfMissing;
 
     bool removePdfBackgroundFlag;
+    bool lazyPageLoading = false;
+    Scheduler* scheduler = nullptr;
     fs::path pdfReplacementFilepath;
     bool pdfReplacementAttach;
 
@@ -128,8 +187,14 @@ private:
     bool isGzFile = false;
 
     std::vector<double> pressureBuffer;
+    std::vector<double> coordinateBuffer;
 
     std::vector<PageRef> pages;
+
+    /**
+     * Pages with a cloned background image and the index of the page with the image
+     */
+    std::vector<std::pair<PageRef, size_t>> clonedBackgrounds;
     PageRef page;
     Layer* layer;
     Stroke* stroke;
@@ -150,9 +215,24 @@ private:
     int loadedTimeStamp;
     std::string loadedFilename;
 
+    /**
+     * The handler which loads the document. Pages parsed in parallel use its zip file, audio files and document.
+     */
+    LoadHandler* rootHandler = this;
+    std::mutex zipMutex;
+    std::mutex pdfMutex;
+    std::mutex clonedBackgroundsMutex;
+
+    /**
+     * Shared by the pages loaded lazily, while the document is parsed
+     */
+    std::shared_ptr<LazyPageSource> lazySource;
+
     DocumentHandler dHanlder;
     Document doc;
 
+    friend struct LazyPageSource;
+
     friend Color LoadHandlerHelper::parseBackgroundColor(LoadHandler* loadHandler);
     friend bool LoadHandlerHelper::parseColor(const char* text, Color& color, LoadHandler* loadHandler);
 
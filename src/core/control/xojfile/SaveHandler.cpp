@@ -1,16 +1,12 @@
 #include "SaveHandler.h"
 
 #include <cinttypes>
+#include <utility>
 
 #include <config.h>
 
 #include "control/jobs/ProgressListener.h"
 #include "control/pagetype/PageTypeHandler.h"
-#include "control/xml/XmlImageNode.h"
-#include "control/xml/XmlNode.h"
-#include "control/xml/XmlPointNode.h"
-#include "control/xml/XmlTexNode.h"
-#include "control/xml/XmlTextNode.h"
 #include "model/BackgroundImage.h"
 #include "model/Document.h"
 #include "model/Image.h"
@@ -19,49 +15,46 @@
 #include "model/StrokeStyle.h"
 #include "model/TexImage.h"
 #include "model/Text.h"
+#include "util/GzUtil.h"
 #include "util/PathUtil.h"
 #include "util/i18n.h"
 
+#include "SavedPageCache.h"
+
 SaveHandler::SaveHandler() {
     this->firstPdfPageVisited = false;
     this->attachBgId = 1;
 }
 
 void SaveHandler::prepareSave(Document* doc) {
-    if (this->root) {
-        // cleanup old data
-        backgroundImages.clear();
-    }
+    backgroundImages.clear();
 
+    this->doc = doc;
     this->firstPdfPageVisited = false;
     this->attachBgId = 1;
 
-    root.reset(new XmlNode("xournal"));
-
-    writeHeader();
-
-    cairo_surface_t* preview = doc->getPreview();
-    if (preview) {
-        auto* image = new XmlImageNode("preview");
-        image->setImage(preview);
-        this->root->addChild(image);
-    }
-
-    for (size_t i = 0; i < doc->getPageCount(); i++) {
-        PageRef p = doc->getPage(i);
-        p->getBackgroundImage().clearSaveState();
-    }
-
-    for (size_t i = 0; i < doc->getPageCount(); i++) {
-        PageRef p = doc->getPage(i);
-        visitPage(root.get(), p, doc, static_cast<int>(i));
+    this->cachedPages.clear();
+    if (this->pageCache) {
+        this->cachedPages.resize(doc->getPageCount());
+        for (size_t i = 0; i < doc->getPageCount(); i++) {
+            PageRef p = doc->getPage(i);
+            CachedPage& page = this->cachedPages[i];
+            page.revision = p->getSnapshotSource() ? p->getSnapshotRevision() : p->getContentRevision();
+            page.member = this->pageCache->get(getCacheKey(p), page.revision);
+        }
     }
 }
 
-void SaveHandler::writeHeader() {
-    this->root->setAttrib("creator", PROJECT_STRING);
-    this->root->setAttrib("fileversion", FILE_FORMAT_VERSION);
-    this->root->addChild(new XmlTextNode("title", std::string{"Xournal++ document - see "} + PROJECT_URL));
+void SaveHandler::writeHeader(XmlStreamWriter& out) {
+    out.startElement("xournal");
+    out.attrib("creator", PROJECT_STRING);
+    out.attrib("fileversion", FILE_FORMAT_VERSION);
+    out.startChildren();
+
+    out.startElement("title");
+    out.startContent();
+    out.text(std::string{"Xournal++ document - see "} + PROJECT_URL);
+    out.endElement("title");
 }
 
 auto SaveHandler::getColorStr(Color c, unsigned char alpha) -> std::string {
@@ -71,136 +64,145 @@ auto SaveHandler::getColorStr(Color c, unsigned char alpha) -> std::string {
     return color;
 }
 
-void SaveHandler::writeTimestamp(AudioElement* audioElement, XmlAudioNode* xmlAudioNode) {
-    /** set stroke timestamp value to the XmlPointNode */
-    xmlAudioNode->setAttrib("ts", audioElement->getTimestamp());
-    xmlAudioNode->setAttrib("fn", audioElement->getAudioFilename().u8string());
+void SaveHandler::writeTimestamp(AudioElement* audioElement, XmlStreamWriter& out) {
+    /** set stroke timestamp value to the stroke element */
+    out.attrib("ts", audioElement->getTimestamp());
+    out.attrib("fn", audioElement->getAudioFilename().u8string());
 }
 
-void SaveHandler::visitStroke(XmlPointNode* stroke, Stroke* s) {
+void SaveHandler::visitStroke(XmlStreamWriter& out, Stroke* s) {
     StrokeTool t = s->getToolType();
 
     unsigned char alpha = 0xff;
 
+    out.startElement("stroke");
     if (t == STROKE_TOOL_PEN) {
-        stroke->setAttrib("tool", "pen");
-        writeTimestamp(s, stroke);
+        out.attrib("tool", "pen");
+        writeTimestamp(s, out);
     } else if (t == STROKE_TOOL_ERASER) {
-        stroke->setAttrib("tool", "eraser");
+        out.attrib("tool", "eraser");
     } else if (t == STROKE_TOOL_HIGHLIGHTER) {
-        stroke->setAttrib("tool", "highlighter");
+        out.attrib("tool", "highlighter");
         alpha = 0x7f;
     } else {
         g_warning("Unknown stroke tool type: %i", t);
-        stroke->setAttrib("tool", "pen");
+        out.attrib("tool", "pen");
     }
 
-    stroke->setAttrib("color", getColorStr(s->getColor(), alpha).c_str());
+    out.attrib("color", getColorStr(s->getColor(), alpha));
 
-    int pointCount = s->getPointCount();
-
-    for (int i = 0; i < pointCount; i++) { stroke->addPoint(s->getPoint(i)); }
+    const StrokePoints& points = s->getStrokePoints();
 
     if (s->hasPressure()) {
-        auto* values = new double[pointCount + 1];
-        values[0] = s->getWidth();
-        for (int i = 0; i < pointCount; i++) { values[i + 1] = s->getPoint(i).z; }
-
-        stroke->setAttrib("width", values, pointCount);
+        // The pressure of the last point is not written, there is one width per segment
+        out.attrib("width", s->getWidth(), points.pressureData(), points.size() - 1);
     } else {
-        stroke->setAttrib("width", s->getWidth());
+        out.attrib("width", s->getWidth());
     }
 
-    visitStrokeExtended(stroke, s);
+    visitStrokeExtended(out, s);
+
+    out.startContent();
+    out.coordinates(points.xData(), points.yData(), points.size());
+    out.endElement("stroke");
 }
 
 /**
  * Export the fill attributes
  */
-void SaveHandler::visitStrokeExtended(XmlPointNode* stroke, Stroke* s) {
+void SaveHandler::visitStrokeExtended(XmlStreamWriter& out, Stroke* s) {
     if (s->getFill() != -1) {
-        stroke->setAttrib("fill", s->getFill());
+        out.attrib("fill", s->getFill());
     }
 
     const StrokeCapStyle capStyle = s->getStrokeCapStyle();
     if (capStyle == StrokeCapStyle::BUTT) {
-        stroke->setAttrib("capStyle", "butt");
+        out.attrib("capStyle", "butt");
     } else if (capStyle == StrokeCapStyle::ROUND) {
-        stroke->setAttrib("capStyle", "round");
+        out.attrib("capStyle", "round");
     } else if (capStyle == StrokeCapStyle::SQUARE) {
-        stroke->setAttrib("capStyle", "square");
+        out.attrib("capStyle", "square");
     } else {
         g_warning("Unknown stroke cap type: %i", capStyle);
-        stroke->setAttrib("capStyle", "round");
+        out.attrib("capStyle", "round");
     }
 
     if (s->getLineStyle().hasDashes()) {
-        stroke->setAttrib("style", StrokeStyle::formatStyle(s->getLineStyle()));
+        out.attrib("style", StrokeStyle::formatStyle(s->getLineStyle()));
     }
 }
 
-void SaveHandler::visitLayer(XmlNode* page, Layer* l) {
-    auto* layer = new XmlNode("layer");
-    page->addChild(layer);
+void SaveHandler::visitLayer(XmlStreamWriter& out, Layer* l) {
+    out.startElement("layer");
     if (l->hasName()) {
-        layer->setAttrib("name", l->getName().c_str());
+        out.attrib("name", l->getName());
     }
 
+    if (l->getElements().empty()) {
+        out.endEmptyElement();
+        return;
+    }
+    out.startChildren();
+
     for (Element* e: l->getElements()) {
         if (e->getType() == ELEMENT_STROKE) {
             auto* s = dynamic_cast<Stroke*>(e);
-            auto* stroke = new XmlPointNode("stroke");
-            layer->addChild(stroke);
-            visitStroke(stroke, s);
+            visitStroke(out, s);
         } else if (e->getType() == ELEMENT_TEXT) {
             Text* t = dynamic_cast<Text*>(e);
-            auto* text = new XmlTextNode("text", t->getText());
-            layer->addChild(text);
-
             XojFont& f = t->getFont();
 
-            text->setAttrib("font", f.getName().c_str());
-            text->setAttrib("size", f.getSize());
-            text->setAttrib("x", t->getX());
-            text->setAttrib("y", t->getY());
-            text->setAttrib("color", getColorStr(t->getColor()).c_str());
+            out.startElement("text");
+            out.attrib("font", f.getName());
+            out.attrib("size", f.getSize());
+            out.attrib("x", t->getX());
+            out.attrib("y", t->getY());
+            out.attrib("color", getColorStr(t->getColor()));
+
+            writeTimestamp(t, out);
 
-            writeTimestamp(t, text);
+            out.startContent();
+            out.text(t->getText());
+            out.endElement("text");
         } else if (e->getType() == ELEMENT_IMAGE) {
             auto* i = dynamic_cast<Image*>(e);
-            auto* image = new XmlImageNode("image");
-            layer->addChild(image);
 
-            image->setImage(i->getImage());
-
-            image->setAttrib("left", i->getX());
-            image->setAttrib("top", i->getY());
-            image->setAttrib("right", i->getX() + i->getElementWidth());
-            image->setAttrib("bottom", i->getY() + i->getElementHeight());
+            out.startElement("image");
+            out.attrib("left", i->getX());
+            out.attrib("top", i->getY());
+            out.attrib("right", i->getX() + i->getElementWidth());
+            out.attrib("bottom", i->getY() + i->getElementHeight());
+            out.startContent();
+            out.base64Png(i->getImage());
+            out.endElement("image");
         } else if (e->getType() == ELEMENT_TEXIMAGE) {
             auto* i = dynamic_cast<TexImage*>(e);
-            auto* image = new XmlTexNode("teximage", std::string(i->getBinaryData()));
-            layer->addChild(image);
-
-            image->setAttrib("text", i->getText().c_str());
-            image->setAttrib("left", i->getX());
-            image->setAttrib("top", i->getY());
-            image->setAttrib("right", i->getX() + i->getElementWidth());
-            image->setAttrib("bottom", i->getY() + i->getElementHeight());
+            const std::string& data = i->getBinaryData();
+
+            out.startElement("teximage");
+            out.attrib("text", i->getText());
+            out.attrib("left", i->getX());
+            out.attrib("top", i->getY());
+            out.attrib("right", i->getX() + i->getElementWidth());
+            out.attrib("bottom", i->getY() + i->getElementHeight());
+            out.startContent();
+            out.base64(data.data(), data.size());
+            out.endElement("teximage");
         }
     }
+
+    out.endElement("layer");
 }
 
-void SaveHandler::visitPage(XmlNode* root, PageRef p, Document* doc, int id) {
-    auto* page = new XmlNode("page");
-    root->addChild(page);
-    page->setAttrib("width", p->getWidth());
-    page->setAttrib("height", p->getHeight());
+void SaveHandler::visitPage(XmlStreamWriter& out, PageRef p, Document* doc, int id) {
+    out.startElement("page");
+    out.attrib("width", p->getWidth());
+    out.attrib("height", p->getHeight());
+    out.startChildren();
 
-    auto* background = new XmlNode("background");
-    page->addChild(background);
+    out.startElement("background");
 
-    writeBackgroundName(background, p);
+    writeBackgroundName(out, p);
 
     if (p->getBackgroundType().isPdfPage()) {
         /**
@@ -208,16 +210,16 @@ void SaveHandler::visitPage(XmlNode* root, PageRef p, Document* doc, int id) {
          * DO NOT CHANGE THE ORDER OF THE ATTRIBUTES!
          */
 
-        background->setAttrib("type", "pdf");
+        out.attrib("type", "pdf");
         if (!firstPdfPageVisited) {
             firstPdfPageVisited = true;
 
             if (doc->isAttachPdf()) {
-                background->setAttrib("domain", "attach");
+                out.attrib("domain", "attach");
                 auto filepath = doc->getFilepath();
                 Util::clearExtensions(filepath);
                 filepath += ".xopp.bg.pdf";
-                background->setAttrib("filename", "bg.pdf");
+                out.attrib("filename", "bg.pdf");
 
                 GError* error = nullptr;
                 doc->getPdfDocument().save(filepath, &error);
@@ -232,24 +234,22 @@ void SaveHandler::visitPage(XmlNode* root, PageRef p, Document* doc, int id) {
                     g_error_free(error);
                 }
             } else {
-                background->setAttrib("domain", "absolute");
-                background->setAttrib("filename", doc->getPdfFilepath().string());
+                out.attrib("domain", "absolute");
+                out.attrib("filename", doc->getPdfFilepath().string());
             }
         }
-        background->setAttrib("pageno", p->getPdfPageNr() + 1);
+        out.attrib("pageno", p->getPdfPageNr() + 1);
     } else if (p->getBackgroundType().isImagePage()) {
-        background->setAttrib("type", "pixmap");
+        out.attrib("type", "pixmap");
 
         int cloneId = p->getBackgroundImage().getCloneId();
         if (cloneId != -1) {
-            background->setAttrib("domain", "clone");
-            char* filename = g_strdup_printf("%i", cloneId);
-            background->setAttrib("filename", filename);
-            g_free(filename);
+            out.attrib("domain", "clone");
+            out.attrib("filename", std::to_string(cloneId));
         } else if (p->getBackgroundImage().isAttached() && p->getBackgroundImage().getPixbuf()) {
             char* filename = g_strdup_printf("bg_%d.png", this->attachBgId++);
-            background->setAttrib("domain", "attach");
-            background->setAttrib("filename", filename);
+            out.attrib("domain", "attach");
+            out.attrib("filename", filename);
             p->getBackgroundImage().setFilepath(filename);
 
             backgroundImages.emplace_back(p->getBackgroundImage());
@@ -257,44 +257,53 @@ void SaveHandler::visitPage(XmlNode* root, PageRef p, Document* doc, int id) {
             g_free(filename);
             p->getBackgroundImage().setCloneId(id);
         } else {
-            background->setAttrib("domain", "absolute");
-            background->setAttrib("filename", p->getBackgroundImage().getFilepath().string());
+            out.attrib("domain", "absolute");
+            out.attrib("filename", p->getBackgroundImage().getFilepath().string());
             p->getBackgroundImage().setCloneId(id);
         }
     } else {
-        writeSolidBackground(background, p);
+        writeSolidBackground(out, p);
     }
 
+    out.endEmptyElement();
+
     // no layer, but we need to write one layer, else the old Xournal cannot read the file
     if (p->getLayers()->empty()) {
-        auto* layer = new XmlNode("layer");
-        page->addChild(layer);
+        out.startElement("layer");
+        out.endEmptyElement();
     }
 
-    for (Layer* l: *p->getLayers()) { visitLayer(page, l); }
+    for (Layer* l: *p->getLayers()) { visitLayer(out, l); }
+
+    out.endElement("page");
 }
 
-void SaveHandler::writeSolidBackground(XmlNode* background, PageRef p) {
-    background->setAttrib("type", "solid");
-    background->setAttrib("color", getColorStr(p->getBackgroundColor()));
+void SaveHandler::writeSolidBackground(XmlStreamWriter& out, PageRef p) {
+    out.attrib("type", "solid");
+    out.attrib("color", getColorStr(p->getBackgroundColor()));
 
-    background->setAttrib("style", PageTypeHandler::getStringForPageTypeFormat(p->getBackgroundType().format));
+    out.attrib("style", PageTypeHandler::getStringForPageTypeFormat(p->getBackgroundType().format));
 
     // Not compatible with Xournal, so the background needs
     // to be changed to a basic one!
     if (!p->getBackgroundType().config.empty()) {
-        background->setAttrib("config", p->getBackgroundType().config);
+        out.attrib("config", p->getBackgroundType().config);
     }
 }
 
-void SaveHandler::writeBackgroundName(XmlNode* background, PageRef p) {
+void SaveHandler::writeBackgroundName(XmlStreamWriter& out, PageRef p) {
     if (p->backgroundHasName()) {
-        background->setAttrib("name", p->getBackgroundName());
+        out.attrib("name", p->getBackgroundName());
     }
 }
 
 void SaveHandler::saveTo(const fs::path& filepath, ProgressListener* listener) {
-    GzOutputStream out(filepath);
+    // Checked before the file is opened, so it is not overwritten
+    if (!loadPages()) {
+        return;
+    }
+
+    GzOutputStream out(filepath, this->compressionLevel);
 
     if (!out.getLastError().empty()) {
         this->errorMessage = out.getLastError();
@@ -311,10 +320,56 @@ void SaveHandler::saveTo(const fs::path& filepath, ProgressListener* listener) {
 }
 
 void SaveHandler::saveTo(OutputStream* out, const fs::path& filepath, ProgressListener* listener) {
-    // XMLNode should be locale-safe ( store doubles using Locale 'C' format
+    // XmlStreamWriter is locale-safe ( store doubles using Locale 'C' format
+    XmlStreamWriter writer(out);
 
     out->write("<?xml version=\"1.0\" standalone=\"no\"?>\n");
-    root->writeOut(out, listener);
+    writeHeader(writer);
+
+    cairo_surface_t* preview = doc->getPreview();
+    if (preview) {
+        writer.startElement("preview");
+        writer.startContent();
+        writer.base64Png(preview);
+        writer.endElement("preview");
+    }
+
+    for (size_t i = 0; i < doc->getPageCount(); i++) {
+        PageRef p = doc->getPage(i);
+        p->getBackgroundImage().clearSaveState();
+    }
+
+    if (listener) {
+        listener->setMaximumState(static_cast<int>(doc->getPageCount()));
+    }
+
+    auto* gzOut = this->pageCache ? dynamic_cast<GzOutputStream*>(out) : nullptr;
+
+    for (size_t i = 0; i < doc->getPageCount(); i++) {
+        PageRef p = doc->getPage(i);
+        if (gzOut && isPageCacheable(p)) {
+            writeCachedPage(writer, *gzOut, p, static_cast<int>(i));
+        } else {
+            visitPage(writer, p, doc, static_cast<int>(i));
+        }
+
+        if (listener) {
+            listener->setCurrentState(static_cast<int>(i + 1));
+        }
+    }
+
+    writer.endElement("xournal");
+    writer.flush();
+
+    // Pages which were not loaded before are loaded while they are written
+    checkPagesLoaded();
+
+    if (this->pageCache) {
+        std::vector<PageRef> pages;
+        pages.reserve(doc->getPageCount());
+        for (size_t i = 0; i < doc->getPageCount(); i++) { pages.push_back(getCacheKey(doc->getPage(i))); }
+        this->pageCache->endSave(pages);
+    }
 
     for (BackgroundImage const& img: backgroundImages) {
         auto tmpfn = (fs::path(filepath) += ".") += img.getFilepath();
@@ -329,3 +384,82 @@ void SaveHandler::saveTo(OutputStream* out, const fs::path& filepath, ProgressLi
 }
 
 auto SaveHandler::getErrorMessage() -> std::string { return this->errorMessage; }
+
+auto SaveHandler::loadPages() -> bool {
+    for (size_t i = 0; i < doc->getPageCount(); i++) {
+        if (!this->pageCache || !this->cachedPages[i].member) {
+            doc->getPage(i)->ensureContentLoaded();
+        }
+    }
+    return checkPagesLoaded();
+}
+
+auto SaveHandler::checkPagesLoaded() -> bool {
+    for (size_t i = 0; i < doc->getPageCount(); i++) {
+        if (doc->getPage(i)->hasContentError()) {
+            this->errorMessage = FS(_F("Page {1} could not be loaded completely, the document is not saved "
+                                       "so the file keeps the content of the page.") %
+                                    (i + 1));
+            return false;
+        }
+        if (doc->getPage(i)->isContentSkipped() && !(this->pageCache && this->cachedPages[i].member)) {
+            this->errorMessage = FS(_F("Page {1} was not copied to be saved.") % (i + 1));
+            return false;
+        }
+    }
+    return true;
+}
+
+void SaveHandler::setCompressionLevel(int level) { this->compressionLevel = level; }
+
+void SaveHandler::setPageCache(SavedPageCache* cache) { this->pageCache = cache; }
+
+auto SaveHandler::createSnapshot(Document* doc) -> std::unique_ptr<Document> {
+    if (!this->pageCache) {
+        return doc->createSnapshot();
+    }
+
+    bool pdfPageVisited = false;
+    return doc->createSnapshot([this, &pdfPageVisited](const PageRef& p, const XojPage::Revision& revision) {
+        // The same pages as in isPageCacheable, the pages are passed in order
+        PageType type = p->getBackgroundType();
+        bool firstPdfPage = type.isPdfPage() && !std::exchange(pdfPageVisited, true);
+        return !type.isImagePage() && !firstPdfPage && this->pageCache->get(p, revision) != nullptr;
+    });
+}
+
+auto SaveHandler::isPageCacheable(PageRef p) -> bool {
+    PageType type = p->getBackgroundType();
+    // Image backgrounds refer to the page index, the first PDF page writes the PDF filename
+    return !type.isImagePage() && !(type.isPdfPage() && !this->firstPdfPageVisited);
+}
+
+auto SaveHandler::getCacheKey(const PageRef& p) -> PageRef {
+    PageRef source = p->getSnapshotSource();
+    return source ? source : p;
+}
+
+void SaveHandler::writeCachedPage(XmlStreamWriter& writer, GzOutputStream& out, PageRef p, int id) {
+    CachedPage& cached = this->cachedPages[static_cast<size_t>(id)];
+    std::shared_ptr<const std::string> member = cached.member;
+
+    if (!member) {
+        StringOutputStream pageOut;
+        {
+            XmlStreamWriter pageWriter(&pageOut);
+            visitPage(pageWriter, p, this->doc, id);
+        }
+
+        auto compressed = std::make_shared<std::string>();
+        if (p->hasContentError() || !GzUtil::compress(pageOut.getString(), *compressed, this->compressionLevel)) {
+            writer.flush();
+            out.write(pageOut.getString());
+            return;
+        }
+        member = compressed;
+        this->pageCache->store(getCacheKey(p), cached.revision, member);
+    }
+
+    writer.flush();
+    out.writeCompressed(*member);
+}
@@ -15,48 +15,112 @@
 #include <string>
 #include <vector>
 
-#include "control/xml/XmlAudioNode.h"
+#include "control/xml/XmlStreamWriter.h"
 #include "model/Document.h"
 #include "model/PageRef.h"
 #include "model/Stroke.h"
 #include "util/OutputStream.h"
 
 
-class XmlNode;
-class XmlPointNode;
 class ProgressListener;
+class SavedPageCache;
 
 class SaveHandler {
 public:
     SaveHandler();
 
 public:
+    /**
+     * Prepares saving doc. The pages are serialized directly to the output in saveTo, so the document
+     * must not change until saveTo returns. Save a snapshot (Document::createSnapshot) to not block
+     * editing, prepareSave is then called while the original document is still locked.
+     */
     void prepareSave(Document* doc);
     void saveTo(const fs::path& filepath, ProgressListener* listener = nullptr);
     void saveTo(OutputStream* out, const fs::path& filepath, ProgressListener* listener = nullptr);
     std::string getErrorMessage();
 
+    /**
+     * Sets the zlib compression level used by saveTo(filepath), e.g. Z_BEST_SPEED for autosave
+     */
+    void setCompressionLevel(int level);
+
+    /**
+     * Reuses the compressed pages of the last save for pages which did not change, and stores the
+     * pages of this save in cache. Only used when saving to a file, call it before prepareSave.
+     */
+    void setPageCache(SavedPageCache* cache);
+
+    /**
+     * Creates the snapshot of doc to save, see Document::createSnapshot. The layers of the pages which are
+     * written from the page cache are not copied. Call it after setPageCache while doc is locked.
+     */
+    std::unique_ptr<Document> createSnapshot(Document* doc);
+
 protected:
     static std::string getColorStr(Color c, unsigned char alpha = 0xff);
 
-    virtual void visitPage(XmlNode* root, PageRef p, Document* doc, int id);
-    virtual void visitLayer(XmlNode* page, Layer* l);
-    virtual void visitStroke(XmlPointNode* stroke, Stroke* s);
+    /**
+     * Writes the page from the page cache, or serializes and stores it
+     */
+    void writeCachedPage(XmlStreamWriter& writer, GzOutputStream& out, PageRef p, int id);
+
+    /**
+     * Loads the layers of the pages which are not written from the page cache. A page whose layers could not
+     * be loaded completely must not be saved, the content which could not be loaded would be lost.
+     *
+     * @return false if a page could not be loaded completely, the error message is set then
+     */
+    bool loadPages();
+
+    /**
+     * @return false if a page could not be loaded completely, or a page whose layers were not copied to the
+     *         snapshot is not in the page cache anymore. The error message is set then.
+     */
+    bool checkPagesLoaded();
+
+    /**
+     * @return The page of the user's document, the page cache is keyed by it also when saving a snapshot
+     */
+    static PageRef getCacheKey(const PageRef& p);
+
+    /**
+     * @return false if the XML of the page depends on other pages or has side effects
+     */
+    bool isPageCacheable(PageRef p);
+
+    virtual void visitPage(XmlStreamWriter& out, PageRef p, Document* doc, int id);
+    virtual void visitLayer(XmlStreamWriter& out, Layer* l);
+    virtual void visitStroke(XmlStreamWriter& out, Stroke* s);
 
     /**
      * Export the fill attributes
      */
-    virtual void visitStrokeExtended(XmlPointNode* stroke, Stroke* s);
+    virtual void visitStrokeExtended(XmlStreamWriter& out, Stroke* s);
 
-    virtual void writeHeader();
-    virtual void writeSolidBackground(XmlNode* background, PageRef p);
-    virtual void writeTimestamp(AudioElement* audioElement, XmlAudioNode* xmlAudioNode);
-    virtual void writeBackgroundName(XmlNode* background, PageRef p);
+    /**
+     * Writes the start tag of the root element and the title
+     */
+    virtual void writeHeader(XmlStreamWriter& out);
+    virtual void writeSolidBackground(XmlStreamWriter& out, PageRef p);
+    virtual void writeTimestamp(AudioElement* audioElement, XmlStreamWriter& out);
+    virtual void writeBackgroundName(XmlStreamWriter& out, PageRef p);
 
 protected:
-    std::unique_ptr<XmlNode> root{};
+    Document* doc = nullptr;
     bool firstPdfPageVisited;
     int attachBgId;
+    int compressionLevel = Z_DEFAULT_COMPRESSION;
+    SavedPageCache* pageCache = nullptr;
+
+    /**
+     * The cache entries of all pages, taken in prepareSave to match the content of the document
+     */
+    struct CachedPage {
+        std::shared_ptr<const std::string> member;
+        XojPage::Revision revision;
+    };
+    std::vector<CachedPage> cachedPages;
 
     std::string errorMessage;
 
@@ -0,0 +1,35 @@
+#include "SavedPageCache.h"
+
+#include <unordered_set>
+
+SavedPageCache::SavedPageCache() = default;
+
+SavedPageCache::~SavedPageCache() = default;
+
+void SavedPageCache::endSave(const std::vector<PageRef>& docPages) {
+    std::unordered_set<XojPage*> pageSet;
+    for (const PageRef& p: docPages) { pageSet.insert(p.get()); }
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    for (auto it = this->pages.begin(); it != this->pages.end();) {
+        if (pageSet.count(it->first.get())) {
+            ++it;
+        } else {
+            it = this->pages.erase(it);
+        }
+    }
+}
+
+auto SavedPageCache::get(const PageRef& page, const XojPage::Revision& revision) -> std::shared_ptr<const std::string> {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto it = this->pages.find(page);
+    if (it == this->pages.end() || it->second.revision != revision) {
+        return nullptr;
+    }
+    return it->second.member;
+}
+
+void SavedPageCache::store(const PageRef& page, XojPage::Revision revision, std::shared_ptr<const std::string> member) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->pages[page] = {std::move(member), std::move(revision)};
+}
@@ -0,0 +1,59 @@
+/*
+ * Xournal++
+ *
+ * Compressed pages of the last save, to only serialize changed pages
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "model/XojPage.h"
+
+/**
+ * Keeps each page of the last save as compressed gzip member. The next save writes the stored member of
+ * all pages which did not change in between and only serializes the changed pages. Used by autosave.
+ *
+ * A member is stored with the content revision of its page (XojPage::getContentRevision), so every change
+ * of the model is detected, also changes without an undo action.
+ */
+class SavedPageCache {
+public:
+    SavedPageCache();
+    ~SavedPageCache();
+
+public:
+    /**
+     * Called when a save is finished, removes the pages which are not in the document anymore
+     */
+    void endSave(const std::vector<PageRef>& docPages);
+
+    /**
+     * @return The stored member of the page, or nullptr if the page needs to be serialized because it changed
+     */
+    std::shared_ptr<const std::string> get(const PageRef& page, const XojPage::Revision& revision);
+
+    /**
+     * Stores the member of the page, serialized at the revision
+     */
+    void store(const PageRef& page, XojPage::Revision revision, std::shared_ptr<const std::string> member);
+
+private:
+    struct Entry {
+        std::shared_ptr<const std::string> member;
+        XojPage::Revision revision;
+    };
+
+    std::unordered_map<PageRef, Entry> pages;
+
+    std::mutex mutex;
+};
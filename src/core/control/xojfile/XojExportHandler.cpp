@@ -4,11 +4,6 @@
 
 #include "control/jobs/ProgressListener.h"
 #include "control/pagetype/PageTypeHandler.h"
-#include "control/xml/XmlImageNode.h"
-#include "control/xml/XmlNode.h"
-#include "control/xml/XmlPointNode.h"
-#include "control/xml/XmlTexNode.h"
-#include "control/xml/XmlTextNode.h"
 #include "model/BackgroundImage.h"
 #include "model/Document.h"
 #include "model/Image.h"
@@ -25,22 +20,27 @@ XojExportHandler::~XojExportHandler() = default;
 /**
  * Export the fill attributes
  */
-void XojExportHandler::visitStrokeExtended(XmlPointNode* stroke, Stroke* s) {
+void XojExportHandler::visitStrokeExtended(XmlStreamWriter& out, Stroke* s) {
     // Fill is not exported in .xoj
     // Line style is also not supported
 }
 
-void XojExportHandler::writeHeader() {
-    this->root->setAttrib("creator", PROJECT_STRING);
+void XojExportHandler::writeHeader(XmlStreamWriter& out) {
+    out.startElement("xournal");
+    out.attrib("creator", PROJECT_STRING);
     // Keep this version on 2, as this is anyway not read by Xournal
-    this->root->setAttrib("fileversion", "2");
-    this->root->addChild(
-            new XmlTextNode("title", std::string{"Xournal document (Compatibility) - see "} + PROJECT_URL));
+    out.attrib("fileversion", "2");
+    out.startChildren();
+
+    out.startElement("title");
+    out.startContent();
+    out.text(std::string{"Xournal document (Compatibility) - see "} + PROJECT_URL);
+    out.endElement("title");
 }
 
-void XojExportHandler::writeSolidBackground(XmlNode* background, PageRef p) {
-    background->setAttrib("type", "solid");
-    background->setAttrib("color", getColorStr(p->getBackgroundColor()));
+void XojExportHandler::writeSolidBackground(XmlStreamWriter& out, PageRef p) {
+    out.attrib("type", "solid");
+    out.attrib("color", getColorStr(p->getBackgroundColor()));
 
     PageTypeFormat bgFormat = p->getBackgroundType().format;
     std::string format;
@@ -51,13 +51,13 @@ void XojExportHandler::writeSolidBackground(XmlNode* background, PageRef p) {
         format = "plain";
     }
 
-    background->setAttrib("style", format);
+    out.attrib("style", format);
 }
 
-void XojExportHandler::writeTimestamp(AudioElement* audioElement, XmlAudioNode* xmlAudioNode) {
+void XojExportHandler::writeTimestamp(AudioElement* audioElement, XmlStreamWriter& out) {
     // Do nothing since timestamp are not supported by Xournal
 }
 
-void XojExportHandler::writeBackgroundName(XmlNode* background, PageRef p) {
+void XojExportHandler::writeBackgroundName(XmlStreamWriter& out, PageRef p) {
     // Do nothing since background name is not supported by Xournal
 }
@@ -27,11 +27,11 @@ protected:
     /**
      * Export the fill attributes
      */
-    void visitStrokeExtended(XmlPointNode* stroke, Stroke* s) override;
-    void writeHeader() override;
-    void writeSolidBackground(XmlNode* background, PageRef p) override;
-    void writeTimestamp(AudioElement* audioElement, XmlAudioNode* xmlAudioNode) override;
-    void writeBackgroundName(XmlNode* background, PageRef p) override;
+    void visitStrokeExtended(XmlStreamWriter& out, Stroke* s) override;
+    void writeHeader(XmlStreamWriter& out) override;
+    void writeSolidBackground(XmlStreamWriter& out, PageRef p) override;
+    void writeTimestamp(AudioElement* audioElement, XmlStreamWriter& out) override;
+    void writeBackgroundName(XmlStreamWriter& out, PageRef p) override;
 
 private:
 };
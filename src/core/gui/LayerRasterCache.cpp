@@ -0,0 +1,289 @@
+#include "LayerRasterCache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+using xoj::util::Rectangle;
+
+auto LayerCacheBudget::reserve(LayerRasterCache* cache, size_t bytes, size_t limit) -> bool {
+    std::lock_guard lock{this->mutex};
+
+    auto it = std::find_if(this->caches.begin(), this->caches.end(), [cache](auto& c) { return c.first == cache; });
+    if (it != this->caches.end()) {
+        this->usage -= it->second;
+        this->caches.erase(it);
+    }
+    if (bytes > limit) {
+        return false;
+    }
+
+    // The caches are released while the budget is locked, so they are not deleted meanwhile, see ~LayerRasterCache
+    while (this->usage + bytes > limit && !this->caches.empty()) {
+        auto& [victim, victimBytes] = this->caches.front();
+        victim->releaseSurfaces();
+        this->usage -= victimBytes;
+        this->caches.pop_front();
+    }
+
+    this->caches.emplace_back(cache, bytes);
+    this->usage += bytes;
+    return true;
+}
+
+void LayerCacheBudget::release(LayerRasterCache* cache) {
+    std::lock_guard lock{this->mutex};
+    auto it = std::find_if(this->caches.begin(), this->caches.end(), [cache](auto& c) { return c.first == cache; });
+    if (it != this->caches.end()) {
+        this->usage -= it->second;
+        this->caches.erase(it);
+    }
+}
+
+auto LayerCacheBudget::getUsage() -> size_t {
+    std::lock_guard lock{this->mutex};
+    return this->usage;
+}
+
+LayerRasterCache::LayerRasterCache(LayerCacheBudget* budget): budget(budget) {}
+
+LayerRasterCache::~LayerRasterCache() {
+    this->budget->release(this);
+    releaseAll();
+}
+
+void LayerRasterCache::releaseAll() {
+    for (Entry& entry: this->entries) { cairo_surface_destroy(entry.surface); }
+    this->entries.clear();
+    this->valid = false;
+}
+
+/*
+ * The budget calls this while it is locked. The caches do not call the budget while they hold the state lock,
+ * and the budget does not wait for the surfaces of another page.
+ */
+auto LayerRasterCache::releaseSurfaces() -> bool {
+    std::unique_lock paintLock{this->paintMutex, std::try_to_lock};
+    std::lock_guard stateLock{this->stateMutex};
+    if (paintLock.owns_lock()) {
+        releaseAll();
+        return true;
+    }
+
+    // Do not wait for the render job
+    this->clearRequested = true;
+    return false;
+}
+
+void LayerRasterCache::clear() {
+    if (releaseSurfaces()) {
+        this->budget->release(this);
+    }
+}
+
+auto LayerRasterCache::addArea(std::vector<Rectangle<double>>& region, const Rectangle<double>& area) -> bool {
+    auto it = std::find_if(region.begin(), region.end(),
+                           [&area](const Rectangle<double>& r) { return r.intersects(area).has_value(); });
+    if (it != region.end()) {
+        it->unite(area);
+        return true;
+    }
+    if (region.size() < MAX_DAMAGE) {
+        region.push_back(area);
+        return true;
+    }
+    return false;
+}
+
+void LayerRasterCache::damage(const Rectangle<double>& area) {
+    std::lock_guard lock{this->stateMutex};
+    for (Entry& entry: this->entries) {
+        if (!entry.damageOverflow && !addArea(entry.damage, area)) {
+            entry.damageOverflow = true;
+            entry.damage.clear();
+        }
+    }
+}
+
+void LayerRasterCache::pageRerendered() { this->pageSerial++; }
+
+auto LayerRasterCache::update(double scale, int variant, size_t limit, const std::function<PageState()>& readPage,
+                              const DrawFunction& draw) -> bool {
+    std::lock_guard paintLock{this->paintMutex};
+
+    // The damage is taken over before the page is read: a change which is recorded later
+    // is part of the next update, a change which is read now has been recorded already.
+    // The entries stay in place with their surfaces moved out, they record the damage meanwhile.
+    std::vector<Entry> previous;
+    uint64_t serial = 0;
+    {
+        std::lock_guard stateLock{this->stateMutex};
+        if (this->clearRequested) {
+            this->clearRequested = false;
+            releaseAll();
+        }
+        for (Entry& entry: this->entries) {
+            previous.push_back(std::move(entry));
+            entry = Entry{};
+            entry.key = previous.back().key;
+        }
+        serial = this->pageSerial;
+    }
+
+    PageState page = readPage();
+    int width = static_cast<int>(std::ceil(page.width * scale));
+    int height = static_cast<int>(std::ceil(page.height * scale));
+
+    auto releaseEntries = [](std::vector<Entry>& list) {
+        for (Entry& entry: list) { cairo_surface_destroy(entry.surface); }
+        list.clear();
+    };
+
+    if (scale != this->scale || variant != this->variant || width != this->width || height != this->height) {
+        releaseEntries(previous);
+        this->scale = scale;
+        this->variant = variant;
+        this->width = width;
+        this->height = height;
+    }
+
+    // Other pages may be released for this one, also while this page is being drawn
+    size_t bytes = page.layers.size() * static_cast<size_t>(std::max(width, 0)) * std::max(height, 0) * 4;
+    if (page.layers.empty() || width <= 0 || height <= 0 || !this->budget->reserve(this, bytes, limit)) {
+        releaseEntries(previous);
+        this->valid = false;
+        this->budget->release(this);
+        return false;
+    }
+
+    std::vector<Entry> next;
+    next.reserve(page.layers.size());
+
+    std::vector<Rectangle<double>> belowRegion;
+    bool belowComplete = false;
+    cairo_surface_t* belowSurface = nullptr;
+    const void* belowKey = nullptr;
+
+    for (const LayerState& layer: page.layers) {
+        Entry entry;
+        auto it = std::find_if(previous.begin(), previous.end(), [&](const Entry& e) { return e.key == layer.key; });
+        if (it != previous.end()) {
+            entry = std::move(*it);
+            previous.erase(it);
+        } else {
+            entry.key = layer.key;
+        }
+
+        bool complete = entry.surface == nullptr || entry.below != belowKey || belowComplete || entry.damageOverflow ||
+                        (entry.pageSerial != serial && entry.revision != layer.revision);
+
+        if (entry.surface == nullptr) {
+            entry.surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+            cairo_surface_set_device_scale(entry.surface, scale, scale);
+        }
+        entry.below = belowKey;
+
+        if (complete) {
+            redraw(entry, belowSurface, nullptr, draw);
+            entry.revision = layer.revision;
+            entry.pageSerial = serial;
+            belowComplete = true;
+        } else {
+            // Unchanged layers only need the areas in which the layers below were drawn again
+            if (layer.selected || entry.revision != layer.revision) {
+                for (const Rectangle<double>& area: entry.damage) {
+                    if (!addArea(belowRegion, area)) {
+                        belowRegion.push_back(area);
+                    }
+                }
+            }
+            for (const Rectangle<double>& area: belowRegion) { redraw(entry, belowSurface, &area, draw); }
+        }
+
+        entry.damage.clear();
+        entry.damageOverflow = false;
+
+        belowSurface = entry.surface;
+        belowKey = entry.key;
+        next.push_back(std::move(entry));
+    }
+
+    // Layers which were removed or hidden
+    releaseEntries(previous);
+
+    {
+        std::lock_guard stateLock{this->stateMutex};
+        for (Entry& entry: next) {
+            auto it = std::find_if(this->entries.begin(), this->entries.end(),
+                                   [&](const Entry& e) { return e.key == entry.key; });
+            if (it != this->entries.end()) {
+                entry.damage = std::move(it->damage);
+                entry.damageOverflow = it->damageOverflow;
+            }
+        }
+        this->entries = std::move(next);
+        this->valid = true;
+
+        if (!this->clearRequested) {
+            return true;
+        }
+        this->clearRequested = false;
+        releaseAll();
+    }
+
+    this->budget->release(this);
+    return false;
+}
+
+void LayerRasterCache::redraw(Entry& entry, cairo_surface_t* below, const Rectangle<double>* area,
+                              const DrawFunction& draw) {
+    cairo_t* cr = cairo_create(entry.surface);
+
+    Rectangle<double> aligned;
+    if (area) {
+        // Whole device pixels, partially covered pixels at the border would mix the old and the new content
+        double x1 = std::floor(area->x * this->scale) / this->scale;
+        double y1 = std::floor(area->y * this->scale) / this->scale;
+        double x2 = std::ceil((area->x + area->width) * this->scale) / this->scale;
+        double y2 = std::ceil((area->y + area->height) * this->scale) / this->scale;
+        aligned = Rectangle<double>(x1, y1, x2 - x1, y2 - y1);
+
+        cairo_rectangle(cr, aligned.x, aligned.y, aligned.width, aligned.height);
+        cairo_clip(cr);
+    }
+
+    cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+    if (below) {
+        cairo_set_source_surface(cr, below, 0, 0);
+    } else {
+        cairo_set_source_rgba(cr, 0, 0, 0, 0);
+    }
+    cairo_paint(cr);
+    cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+
+    draw(cr, entry.key, area ? &aligned : nullptr);
+
+    cairo_destroy(cr);
+}
+
+auto LayerRasterCache::isValid(double scale) -> bool {
+    std::lock_guard lock{this->paintMutex};
+    return this->valid && this->scale == scale;
+}
+
+auto LayerRasterCache::paint(cairo_t* cr, const Rectangle<double>& area, double scale) -> bool {
+    std::lock_guard lock{this->paintMutex};
+    if (!this->valid || this->entries.empty() || this->scale != scale) {
+        return false;
+    }
+
+    cairo_save(cr);
+    cairo_rectangle(cr, area.x, area.y, area.width, area.height);
+    cairo_clip(cr);
+    cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+    cairo_set_source_surface(cr, this->entries.back().surface, 0, 0);
+    cairo_pattern_set_filter(cairo_get_source(cr), CAIRO_FILTER_NEAREST);
+    cairo_paint(cr);
+    cairo_restore(cr);
+    return true;
+}
@@ -0,0 +1,233 @@
+/*
+ * Xournal++
+ *
+ * Rasterized layers of a page
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <cairo.h>
+
+#include "util/Rectangle.h"
+
+class LayerRasterCache;
+
+/**
+ * Limits the memory of the rasterized layers of all pages. The pages which were updated least recently
+ * are released first.
+ */
+class LayerCacheBudget {
+public:
+    LayerCacheBudget() = default;
+    LayerCacheBudget(const LayerCacheBudget&) = delete;
+    LayerCacheBudget& operator=(const LayerCacheBudget&) = delete;
+
+public:
+    /**
+     * Records that cache needs bytes now. Other caches are released until all caches fit into limit.
+     *
+     * @return false if cache alone does not fit into limit, nothing is recorded for it then
+     */
+    bool reserve(LayerRasterCache* cache, size_t bytes, size_t limit);
+
+    /**
+     * Records that cache released its surfaces
+     */
+    void release(LayerRasterCache* cache);
+
+    /**
+     * @return The memory of all caches in bytes
+     */
+    size_t getUsage();
+
+private:
+    std::mutex mutex;
+
+    /**
+     * The caches with their memory, the least recently updated first
+     */
+    std::list<std::pair<LayerRasterCache*, size_t>> caches;
+    size_t usage = 0;
+};
+
+/**
+ * Keeps the background and the layers of a page rasterized at the current zoom, so a full rerender
+ * of the page only draws the layers which changed.
+ *
+ * The surfaces are cumulative: the surface of a layer contains the background and all visible layers
+ * below it. Highlighter strokes are multiplied with what is below them, so a layer can not be rasterized
+ * on its own and composited afterwards. The topmost surface is the rendered page.
+ *
+ * A layer is drawn again completely if its surface is new, or if its revision changed and the whole page
+ * was rerendered since it was drawn the last time. Rerendered rectangles are recorded by every surface,
+ * they are drawn again in the layers which changed since they were drawn completely and in the selected
+ * layer, which is modified by the tools. Whenever a layer is drawn again, the layers above it are drawn
+ * again in the same area.
+ *
+ * The memory of the caches of all pages is limited by a LayerCacheBudget.
+ *
+ * update() and paint() are called by the render job of the page, damage() and pageRerendered()
+ * by the UI thread.
+ */
+class LayerRasterCache {
+public:
+    /**
+     * A layer of the page, or the background
+     */
+    struct LayerState {
+        const void* key = nullptr;
+        uint64_t revision = 0;
+        bool selected = false;
+    };
+
+    /**
+     * The page as it is drawn
+     */
+    struct PageState {
+        double width = 0;
+        double height = 0;
+
+        /**
+         * The background followed by the visible layers, bottom to top
+         */
+        std::vector<LayerState> layers;
+    };
+
+    /**
+     * Draws the background or the elements of a layer to cr, in page coordinates.
+     * area is nullptr if the whole layer is drawn, otherwise cr is clipped to area.
+     */
+    using DrawFunction = std::function<void(cairo_t* cr, const void* key, const xoj::util::Rectangle<double>* area)>;
+
+public:
+    explicit LayerRasterCache(LayerCacheBudget* budget);
+    ~LayerRasterCache();
+    LayerRasterCache(const LayerRasterCache&) = delete;
+    LayerRasterCache& operator=(const LayerRasterCache&) = delete;
+
+public:
+    /**
+     * Brings the surfaces up to date
+     *
+     * @param scale Device pixel per page unit
+     * @param variant Changes of the variant (e.g. the audio highlighting) drop all surfaces
+     * @param limit The memory limit of the caches of all pages in bytes, see LayerCacheBudget
+     * @param readPage Reads the state of the page. Called after the recorded damage was taken over.
+     * @return false if the page does not fit into the limit, nothing is cached then
+     */
+    bool update(double scale, int variant, size_t limit, const std::function<PageState()>& readPage,
+                const DrawFunction& draw);
+
+    /**
+     * Paints the area of the rendered page, cr is in page coordinates
+     *
+     * @return false if there is no up to date rendering at this scale
+     */
+    bool paint(cairo_t* cr, const xoj::util::Rectangle<double>& area, double scale);
+
+    /**
+     * @return true if the surfaces were rendered at this scale, they are brought up to date by update()
+     */
+    bool isValid(double scale);
+
+    /**
+     * Records a rerendered area of the page, in page coordinates
+     */
+    void damage(const xoj::util::Rectangle<double>& area);
+
+    /**
+     * Records that the whole page is rerendered
+     */
+    void pageRerendered();
+
+    /**
+     * Releases all surfaces. If a render job is updating the cache, they are released once it is done.
+     */
+    void clear();
+
+private:
+    /**
+     * More damaged rectangles than this make the layer being drawn again completely
+     */
+    static constexpr size_t MAX_DAMAGE = 16;
+
+    struct Entry {
+        const void* key = nullptr;
+
+        /**
+         * The key of the entry below, nullptr for the background
+         */
+        const void* below = nullptr;
+
+        cairo_surface_t* surface = nullptr;
+
+        /**
+         * The revision and the page rerender count when the layer was drawn completely
+         */
+        uint64_t revision = 0;
+        uint64_t pageSerial = 0;
+
+        std::vector<xoj::util::Rectangle<double>> damage;
+        bool damageOverflow = false;
+    };
+
+    void releaseAll();
+
+    /**
+     * Releases all surfaces, or requests it from the running update, without telling the budget
+     *
+     * @return true if the surfaces were released now
+     */
+    bool releaseSurfaces();
+
+    /**
+     * Adds area to region, united with an intersecting rectangle
+     *
+     * @return false if the region has MAX_DAMAGE rectangles already
+     */
+    static bool addArea(std::vector<xoj::util::Rectangle<double>>& region, const xoj::util::Rectangle<double>& area);
+
+    /**
+     * Draws the area (nullptr: all) of the entry, on top of the surface below
+     */
+    void redraw(Entry& entry, cairo_surface_t* below, const xoj::util::Rectangle<double>* area,
+                const DrawFunction& draw);
+
+private:
+    LayerCacheBudget* budget;
+
+    /**
+     * Guards the surfaces, held while they are drawn
+     */
+    std::mutex paintMutex;
+
+    std::vector<Entry> entries;
+    double scale = 0;
+    int width = 0;
+    int height = 0;
+    int variant = 0;
+    bool valid = false;
+
+    /**
+     * Guards the damage of the entries and clearRequested
+     */
+    std::mutex stateMutex;
+    bool clearRequested = false;
+
+    std::atomic<uint64_t> pageSerial{0};
+
+    friend class LayerCacheBudget;
+};
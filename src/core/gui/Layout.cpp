@@ -4,6 +4,7 @@
 #include <numeric>
 #include <optional>
 #include <utility>
+#include <vector>
 
 #include "control/Control.h"
 #include "gui/scroll/ScrollHandling.h"
@@ -42,11 +43,15 @@ Layout::Layout(XournalView* view, ScrollHandling* scrollHandling): view(view), s
 
 void Layout::horizontalScrollChanged(GtkAdjustment* adjustment, Layout* layout) {
     Layout::checkScroll(adjustment, layout->lastScrollHorizontal);
+    layout->scrollPredictor.scrolled(layout->lastScrollHorizontal, layout->lastScrollVertical,
+                                     g_get_monotonic_time());
     layout->updateVisibility();
 }
 
 void Layout::verticalScrollChanged(GtkAdjustment* adjustment, Layout* layout) {
     Layout::checkScroll(adjustment, layout->lastScrollVertical);
+    layout->scrollPredictor.scrolled(layout->lastScrollHorizontal, layout->lastScrollVertical,
+                                     g_get_monotonic_time());
     layout->updateVisibility();
 }
 
@@ -67,6 +72,8 @@ void Layout::updateVisibility() {
     std::optional<size_t> mostPageNr;
     double mostPagePercent = 0;
 
+    std::vector<XojPageView*> visiblePages;
+
     for (size_t row = 0; row < this->rowYStart.size(); ++row) {
         auto y2 = as_signed_strict(this->rowYStart[row]);
         for (size_t col = 0; col < this->colXStart.size(); ++col) {
@@ -85,6 +92,7 @@ void Layout::updateVisibility() {
                     auto const& pageRect = pageView->getRect();
                     if (auto intersection = pageRect.intersects(visRect); intersection) {
                         pageView->setIsVisible(true);
+                        visiblePages.push_back(pageView);
                         // Set the selected page
                         double percent = intersection->area() / pageRect.area();
 
@@ -103,6 +111,10 @@ void Layout::updateVisibility() {
         x1 = 0;
     }
 
+    // Pages which are shown now are rendered before pages which are still waiting from earlier
+    this->view->getControl()->getScheduler()->prioritizePages(visiblePages);
+    this->view->prefetchPages(visRect, this->scrollPredictor.predict(visRect));
+
     if (mostPageNr) {
         this->view->getControl()->firePageSelected(*mostPageNr);
     }
@@ -174,6 +186,9 @@ void Layout::recalculate() {
 
 void Layout::layoutPages(int width, int height) {
     std::lock_guard g{pc.m};
+    // The pages moved, this is no scroll movement
+    this->scrollPredictor.reset();
+
     if (!pc.valid) {
         recalculate_int();
     }
@@ -20,6 +20,7 @@
 #include "util/Rectangle.h"
 
 #include "LayoutMapper.h"
+#include "ScrollPredictor.h"
 
 
 class XojPageView;
@@ -166,6 +167,11 @@ private:
     double lastScrollHorizontal = -1;
     double lastScrollVertical = -1;
 
+    /**
+     * The scroll direction and velocity, the pages ahead are rendered before they are shown
+     */
+    ScrollPredictor scrollPredictor;
+
     /**
      * layoutPages invalidates the precalculation of recalculate
      * this bool prevents that layotPages can be called without a previously call to recalculate
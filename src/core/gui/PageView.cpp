@@ -59,6 +59,8 @@ XojPageView::XojPageView(XournalView* xournal, const PageRef& page):
         page(page),
         xournal(xournal),
         settings(xournal->getControl()->getSettings()),
+        buffer(xournal->getTilePool()),
+        layerCache(xournal->getLayerCacheBudget()),
         eraser(new EraseHandler(xournal->getControl()->getUndoRedoHandler(), xournal->getControl()->getDocument(),
                                 this->page, xournal->getControl()->getToolHandler(), this)),
         oldtext(nullptr) {
@@ -69,6 +71,11 @@ XojPageView::~XojPageView() {
     // Unregister listener before destroying this handler
     this->unregisterListener();
 
+    // A cancelled render job does not schedule the page again, see RenderJob::postpone
+    {
+        std::lock_guard lock{this->repaintRectMutex};
+        this->lastVisibleTime = -1;
+    }
     this->xournal->getControl()->getScheduler()->removePage(this);
     delete this->inputHandler;
     delete this->eraser;
@@ -79,16 +86,49 @@ XojPageView::~XojPageView() {
 
 void XojPageView::setIsVisible(bool visible) {
     if (visible) {
-        this->lastVisibleTime = 0;
+        bool wasHidden = this->lastVisibleTime > 0;
+        {
+            std::lock_guard lock{this->repaintRectMutex};
+            this->lastVisibleTime = 0;
+        }
+        if (wasHidden) {
+            resumeRendering();
+        }
     } else if (this->lastVisibleTime <= 0) {
         GTimeVal val;
         g_get_current_time(&val);
-        this->lastVisibleTime = val.tv_sec;
+        {
+            std::lock_guard lock{this->repaintRectMutex};
+            this->lastVisibleTime = static_cast<int>(val.tv_sec);
+        }
+
+        // Rendering a page which left the viewport only delays the pages which are shown now
+        this->xournal->getControl()->getScheduler()->cancelPage(this);
+    }
+}
+
+void XojPageView::resumeRendering() {
+    // A cancelled job which is still running schedules the page itself when it hands its work back,
+    // see RenderJob::postpone
+    this->repaintRectMutex.lock();
+    bool pending = this->rerenderComplete || this->tilesRequested || !this->rerenderRects.empty();
+    this->repaintRectMutex.unlock();
+
+    this->drawingMutex.lock();
+    bool hasPreview = this->buffer.hasPreview();
+    this->drawingMutex.unlock();
+
+    if (pending) {
+        this->xournal->getControl()->getScheduler()->addRerenderPage(this);
+    }
+    if (hasPreview) {
+        this->xournal->getControl()->getScheduler()->addRefinePage(this);
     }
 }
 
 auto XojPageView::getLastVisibleTime() -> int {
-    if (this->crBuffer == nullptr) {
+    std::lock_guard lock{this->drawingMutex};
+    if (this->buffer.isEmpty()) {
         return -1;
     }
 
@@ -97,11 +137,10 @@ auto XojPageView::getLastVisibleTime() -> int {
 
 void XojPageView::deleteViewBuffer() {
     this->drawingMutex.lock();
-    if (this->crBuffer) {
-        cairo_surface_destroy(this->crBuffer);
-        this->crBuffer = nullptr;
-    }
+    this->buffer.clear();
     this->drawingMutex.unlock();
+
+    this->layerCache.clear();
 }
 
 auto XojPageView::containsPoint(int x, int y, bool local) const -> bool {
@@ -129,9 +168,9 @@ auto XojPageView::searchTextOnPage(string& text, int* occures, double* top) -> b
         if (pNr != npos) {
             Document* doc = xournal->getControl()->getDocument();
 
-            doc->lock();
+            doc->lockShared();
             pdf = doc->getPdfPage(pNr);
-            doc->unlock();
+            doc->unlockShared();
         }
         this->search = new SearchControl(page, pdf);
     }
@@ -580,9 +619,11 @@ auto XojPageView::onButtonReleaseEvent(const PositionInputData& pos) -> bool {
     if (this->inEraser) {
         this->inEraser = false;
         Document* doc = this->xournal->getControl()->getDocument();
-        doc->lock();
+        doc->lockShared();
+        this->page->lock();
         this->eraser->finalize();
-        doc->unlock();
+        this->page->unlock();
+        doc->unlockShared();
     }
 
     if (this->verticalSpace) {
@@ -680,6 +721,7 @@ auto XojPageView::onKeyReleaseEvent(GdkEventKey* event) -> bool {
 }
 
 void XojPageView::rerenderPage() {
+    this->layerCache.pageRerendered();
     this->rerenderComplete = true;
     this->xournal->getControl()->getScheduler()->addRerenderPage(this);
 }
@@ -702,12 +744,15 @@ void XojPageView::rerenderRect(double x, double y, double width, double height)
 }
 
 void XojPageView::addRerenderRect(double x, double y, double width, double height) {
+    auto rect = Rectangle<double>{x, y, width, height};
+
+    // Also while the whole page is rerendered, the layers are only drawn completely if they changed
+    this->layerCache.damage(rect);
+
     if (this->rerenderComplete) {
         return;
     }
 
-    auto rect = Rectangle<double>{x, y, width, height};
-
     this->repaintRectMutex.lock();
 
     for (auto&& r: this->rerenderRects) {
@@ -721,9 +766,19 @@ void XojPageView::addRerenderRect(double x, double y, double width, double heigh
         }
     }
 
-    this->rerenderRects.push_back(rect);
+    if (this->rerenderRects.size() < MAX_RERENDER_RECTS) {
+        this->rerenderRects.push_back(rect);
+    } else {
+        // Many scattered changes are rendered faster as one larger area
+        this->rerenderRects.back().unite(rect);
+    }
     this->repaintRectMutex.unlock();
 
+    // A page which left the viewport is rendered again once it is shown
+    if (this->lastVisibleTime > 0) {
+        return;
+    }
+
     this->xournal->getControl()->getScheduler()->addRerenderPage(this);
 }
 
@@ -793,58 +848,94 @@ void XojPageView::drawLoadingPage(cairo_t* cr) {
     rerenderPage();
 }
 
+void XojPageView::requestTiles() {
+    this->repaintRectMutex.lock();
+    this->tilesRequested = true;
+    this->repaintRectMutex.unlock();
+
+    this->xournal->getControl()->getScheduler()->addRerenderPage(this);
+}
+
+auto XojPageView::prefetch(const Rectangle<double>& area) -> size_t {
+    double scale = xournal->getZoom() * xournal->getDpiScaleFactor();
+    TileRange range = TiledPageBuffer::tilesFor(area, scale);
+    size_t bytes = size_t(range.count()) * TiledPageBuffer::TILE_SIZE * TiledPageBuffer::TILE_SIZE * 4;
+
+    this->drawingMutex.lock();
+    bool rendered = this->buffer.getScale() == scale;
+    for (int y = range.y1; rendered && y < range.y2; y++) {
+        for (int x = range.x1; rendered && x < range.x2; x++) { rendered = this->buffer.isValid(x, y); }
+    }
+    this->drawingMutex.unlock();
+
+    if (rendered) {
+        return bytes;
+    }
+
+    // The area is rendered like the last painted area, it is replaced once the page is painted
+    this->repaintRectMutex.lock();
+    this->visibleArea = area;
+    this->tilesRequested = true;
+    this->repaintRectMutex.unlock();
+
+    this->xournal->getControl()->getScheduler()->addPrefetchPage(this);
+    return bytes;
+}
+
+auto XojPageView::isPrefetched() const -> bool { return this->prefetched; }
+
+void XojPageView::setPrefetched(bool prefetched) { this->prefetched = prefetched; }
+
 /**
  * Does the painting, called in synchronized block
  */
 void XojPageView::paintPageSync(cairo_t* cr, GdkRectangle* rect) {
-    if (this->crBuffer == nullptr) {
-        drawLoadingPage(cr);
-        return;
-    }
-
     double zoom = xournal->getZoom();
     int dispWidth = getDisplayWidth();
+    int dispHeight = getDisplayHeight();
 
-    cairo_save(cr);
+    // Only the exposed part of the page is painted and rendered
+    double x1 = NAN, x2 = NAN, y1 = NAN, y2 = NAN;
+    cairo_clip_extents(cr, &x1, &y1, &x2, &y2);
+    auto area = Rectangle<double>(0, 0, dispWidth, dispHeight).intersects({x1, y1, x2 - x1, y2 - y1});
+    if (!area) {
+        return;
+    }
 
-    double width = cairo_image_surface_get_width(this->crBuffer);
+    this->repaintRectMutex.lock();
+    this->visibleArea = *area;
+    this->visibleArea *= 1.0 / zoom;
+    this->repaintRectMutex.unlock();
 
-    bool rerender = true;
-    if (width / xournal->getDpiScaleFactor() == dispWidth) {
-        rerender = false;
+    if (this->buffer.isEmpty()) {
+        drawLoadingPage(cr);
+        return;
     }
 
-    if (width != dispWidth) {
-        double scale = (static_cast<double>(dispWidth)) / (width);
+    cairo_save(cr);
 
-        // Scale current image to fit the zoom level
-        cairo_scale(cr, scale, scale);
-        cairo_pattern_set_filter(cairo_get_source(cr), CAIRO_FILTER_FAST);
+    cairo_rectangle(cr, 0, 0, dispWidth, dispHeight);
+    cairo_clip(cr);
 
-        cairo_set_source_surface(cr, this->crBuffer, 0, 0);
+    // Tiles which are not rendered yet are shown blank
+    cairo_set_source_rgb(cr, 1, 1, 1);
+    cairo_paint(cr);
 
-        if (rerender) {
-            rerenderPage();
-        }
+    bool complete = false;
+    this->buffer.paint(cr, *area, zoom, zoom * xournal->getDpiScaleFactor(), complete);
 
-        rect = nullptr;
-    } else {
-        cairo_set_source_surface(cr, this->crBuffer, 0, 0);
+    if (!complete) {
+        requestTiles();
     }
 
-    if (rect) {
-        cairo_rectangle(cr, rect->x, rect->y, rect->width, rect->height);
-        cairo_fill(cr);
-
 #ifdef DEBUG_SHOW_PAINT_BOUNDS
+    if (rect) {
         cairo_set_source_rgb(cr, 1.0, 0.5, 1.0);
         cairo_set_line_width(cr, 1. / zoom);
         cairo_rectangle(cr, rect->x, rect->y, rect->width, rect->height);
         cairo_stroke(cr);
-#endif
-    } else {
-        cairo_paint(cr);
     }
+#endif
 
     cairo_restore(cr);
 
@@ -904,10 +995,8 @@ auto XojPageView::paintPage(cairo_t* cr, GdkRectangle* rect) -> bool {
 auto XojPageView::isSelected() const -> bool { return selected; }
 
 auto XojPageView::getBufferPixels() -> int {
-    if (crBuffer) {
-        return cairo_image_surface_get_width(crBuffer) * cairo_image_surface_get_height(crBuffer);
-    }
-    return 0;
+    std::lock_guard lock{this->drawingMutex};
+    return static_cast<int>(this->buffer.getPixelCount());
 }
 
 auto XojPageView::getSelectionColor() -> GdkRGBA { return Util::rgb_to_GdkRGBA(settings->getSelectionColor()); }
@@ -998,11 +1087,8 @@ void XojPageView::elementChanged(Element* elem) {
     if (this->inputHandler && elem == this->inputHandler->getStroke()) {
         this->drawingMutex.lock();
 
-        cairo_t* cr = cairo_create(this->crBuffer);
-
-        this->inputHandler->draw(cr);
-
-        cairo_destroy(cr);
+        Rectangle<double> area(elem->getX(), elem->getY(), elem->getElementWidth(), elem->getElementHeight());
+        this->buffer.drawOnTiles(area, [this](cairo_t* cr) { this->inputHandler->draw(cr); });
 
         this->drawingMutex.unlock();
     } else {
@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <mutex>
 #include <vector>
 
@@ -25,6 +26,8 @@
 
 #include "Layout.h"
 #include "Redrawable.h"
+#include "LayerRasterCache.h"
+#include "TiledPageBuffer.h"
 
 class EditSelection;
 class EraseHandler;
@@ -98,6 +101,21 @@ public:
      * else the time in Seconds
      */
     int getLastVisibleTime();
+
+    /**
+     * Renders an area of the page, which is not shown yet, ahead. Nothing is scheduled if its tiles are up to date.
+     *
+     * @param area The area in page coordinates
+     * @return The memory used by the tiles of the area, in bytes
+     */
+    size_t prefetch(const xoj::util::Rectangle<double>& area);
+
+    /**
+     * The page is rendered ahead, its buffer is not released by XournalView::cleanupBufferCache
+     */
+    bool isPrefetched() const;
+    void setPrefetched(bool prefetched);
+
     TextEditor* getTextEditor();
 
     /**
@@ -188,6 +206,16 @@ private:
 
     void drawLoadingPage(cairo_t* cr);
 
+    /**
+     * Schedules the rendering of the missing tiles of the visible area
+     */
+    void requestTiles();
+
+    /**
+     * Schedules the work which was dropped when the page left the viewport
+     */
+    void resumeRendering();
+
     void setX(int x);
     void setY(int y);
 
@@ -228,7 +256,15 @@ private:
 
     bool selected = false;
 
-    cairo_surface_t* crBuffer = nullptr;
+    /**
+     * The rendered page, guarded by drawingMutex
+     */
+    TiledPageBuffer buffer;
+
+    /**
+     * The rasterized layers, which the buffer is rendered from
+     */
+    LayerRasterCache layerCache;
 
     bool inEraser = false;
 
@@ -243,16 +279,34 @@ private:
     SearchControl* search = nullptr;
 
     /**
-     * Unixtimestam when the page was last time in the visible area
+     * Unixtimestam when the page was last time in the visible area. Written by the UI thread
+     * while repaintRectMutex is held, so RenderJob::postpone sees whether the page is shown.
+     */
+    std::atomic<int> lastVisibleTime{-1};
+
+    /**
+     * More rectangles to rerender than this are united into the last one
      */
-    int lastVisibleTime = -1;
+    static constexpr size_t MAX_RERENDER_RECTS = 16;
 
     std::mutex repaintRectMutex;
     std::vector<xoj::util::Rectangle<double>> rerenderRects;
     bool rerenderComplete = false;
 
+    /**
+     * The last painted area of the page in page coordinates, and whether
+     * some of its tiles were missing. Guarded by repaintRectMutex
+     */
+    xoj::util::Rectangle<double> visibleArea;
+    bool tilesRequested = false;
+
     std::mutex drawingMutex;
 
+    /**
+     * See isPrefetched(), only used in the UI thread
+     */
+    bool prefetched = false;
+
     int dispX{};  // position on display - set in Layout::layoutPages
     int dispY{};
 
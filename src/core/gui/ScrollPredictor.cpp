@@ -0,0 +1,64 @@
+#include "ScrollPredictor.h"
+
+#include <algorithm>
+#include <cmath>
+
+using xoj::util::Rectangle;
+
+static int sign(double value) { return (value > 0) - (value < 0); }
+
+void ScrollPredictor::scrolled(double x, double y, int64_t time) {
+    double dx = x - this->lastX;
+    double dy = y - this->lastY;
+    int64_t dt = time - this->lastTime;
+    bool hadPosition = this->hasPosition;
+
+    this->hasPosition = true;
+    this->lastX = x;
+    this->lastY = y;
+    this->lastTime = time;
+
+    if (!hadPosition || (dx == 0 && dy == 0)) {
+        return;
+    }
+
+    // The axis with the larger movement is the scroll direction
+    double distance = 0;
+    if (std::abs(dy) >= std::abs(dx)) {
+        this->directionX = 0;
+        this->directionY = sign(dy);
+        distance = std::abs(dy);
+    } else {
+        this->directionX = sign(dx);
+        this->directionY = 0;
+        distance = std::abs(dx);
+    }
+
+    // Several scroll events may arrive within the same millisecond
+    double current = distance / (static_cast<double>(std::max<int64_t>(dt, 1000)) / 1e6);
+    if (dt > IDLE_TIME || this->velocity == 0) {
+        this->velocity = current;
+    } else {
+        this->velocity = (this->velocity + current) / 2;
+    }
+}
+
+void ScrollPredictor::reset() {
+    this->hasPosition = false;
+    this->velocity = 0;
+}
+
+auto ScrollPredictor::predict(const Rectangle<double>& visible) const -> Rectangle<double> {
+    if (this->directionX == 0) {
+        double distance =
+                std::clamp(this->velocity * LOOKAHEAD_TIME, visible.height, visible.height * MAX_VIEWPORTS);
+        double y = this->directionY >= 0 ? visible.y + visible.height : visible.y - distance;
+        return {visible.x, y, visible.width, distance};
+    }
+
+    double distance = std::clamp(this->velocity * LOOKAHEAD_TIME, visible.width, visible.width * MAX_VIEWPORTS);
+    double x = this->directionX > 0 ? visible.x + visible.width : visible.x - distance;
+    return {x, visible.y, distance, visible.height};
+}
+
+auto ScrollPredictor::getVelocity() const -> double { return this->velocity; }
@@ -0,0 +1,78 @@
+/*
+ * Xournal++
+ *
+ * Predicts the area which is scrolled into view next
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "util/Rectangle.h"
+
+/**
+ * Tracks the direction and the velocity of scrolling, so the pages which are about to appear
+ * can be rendered ahead.
+ *
+ * The direction is kept after scrolling stopped: the next movement (or page flip) most likely
+ * continues the reading direction. Before the first movement, reading down is assumed.
+ */
+class ScrollPredictor {
+public:
+    /**
+     * Rendering ahead covers the distance scrolled within this time, in seconds
+     */
+    static constexpr double LOOKAHEAD_TIME = 0.5;
+
+    /**
+     * The predicted area extends at least one and at most this many viewports beyond the visible area
+     */
+    static constexpr double MAX_VIEWPORTS = 4;
+
+    /**
+     * A pause longer than this (in microseconds) starts a new movement, the velocity is not averaged with the last one
+     */
+    static constexpr int64_t IDLE_TIME = 250000;
+
+public:
+    /**
+     * Records the scroll position
+     *
+     * @param time A monotonic time in microseconds, e.g. g_get_monotonic_time()
+     */
+    void scrolled(double x, double y, int64_t time);
+
+    /**
+     * Forgets the last position, e.g. after a zoom change moved the layout
+     */
+    void reset();
+
+    /**
+     * @return The area next to the visible area in the scroll direction, in layout coordinates
+     */
+    xoj::util::Rectangle<double> predict(const xoj::util::Rectangle<double>& visible) const;
+
+    /**
+     * @return Layout pixels per second in the direction of the last movement
+     */
+    double getVelocity() const;
+
+private:
+    bool hasPosition = false;
+    double lastX = 0;
+    double lastY = 0;
+    int64_t lastTime = 0;
+
+    double velocity = 0;
+
+    /**
+     * -1, 0 or 1 per axis, only the axis of the last movement is not 0
+     */
+    int directionX = 0;
+    int directionY = 1;
+};
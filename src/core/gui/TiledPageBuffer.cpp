@@ -0,0 +1,249 @@
+#include "TiledPageBuffer.h"
+
+#include <algorithm>
+#include <cmath>
+
+using xoj::util::Rectangle;
+
+TilePool::~TilePool() {
+    for (cairo_surface_t* surface: this->freeTiles) { cairo_surface_destroy(surface); }
+}
+
+auto TilePool::acquire() -> cairo_surface_t* {
+    {
+        std::lock_guard lock{this->mutex};
+        if (!this->freeTiles.empty()) {
+            cairo_surface_t* surface = this->freeTiles.back();
+            this->freeTiles.pop_back();
+            return surface;
+        }
+    }
+
+    return cairo_image_surface_create(CAIRO_FORMAT_ARGB32, TiledPageBuffer::TILE_SIZE, TiledPageBuffer::TILE_SIZE);
+}
+
+void TilePool::release(cairo_surface_t* surface) {
+    {
+        std::lock_guard lock{this->mutex};
+        if (this->freeTiles.size() < MAX_FREE_TILES) {
+            this->freeTiles.push_back(surface);
+            return;
+        }
+    }
+
+    cairo_surface_destroy(surface);
+}
+
+TiledPageBuffer::TiledPageBuffer(TilePool* pool): pool(pool) {}
+
+TiledPageBuffer::~TiledPageBuffer() { clear(); }
+
+auto TiledPageBuffer::makeKey(int x, int y) -> Key {
+    return (static_cast<Key>(static_cast<uint32_t>(x)) << 32U) | static_cast<uint32_t>(y);
+}
+
+auto TiledPageBuffer::keyX(Key key) -> int { return static_cast<int>(static_cast<uint32_t>(key >> 32U)); }
+
+auto TiledPageBuffer::keyY(Key key) -> int { return static_cast<int>(static_cast<uint32_t>(key)); }
+
+auto TiledPageBuffer::tilesFor(const Rectangle<double>& area, double scale) -> TileRange {
+    TileRange range;
+    if (area.width <= 0 || area.height <= 0 || scale <= 0) {
+        return range;
+    }
+
+    range.x1 = std::max(0, static_cast<int>(std::floor(area.x * scale / TILE_SIZE)));
+    range.y1 = std::max(0, static_cast<int>(std::floor(area.y * scale / TILE_SIZE)));
+    range.x2 = static_cast<int>(std::ceil((area.x + area.width) * scale / TILE_SIZE));
+    range.y2 = static_cast<int>(std::ceil((area.y + area.height) * scale / TILE_SIZE));
+    return range;
+}
+
+auto TiledPageBuffer::tileArea(int x, int y, double scale) -> Rectangle<double> {
+    double size = TILE_SIZE / scale;
+    return Rectangle<double>(x * size, y * size, size, size);
+}
+
+auto TiledPageBuffer::getScale() const -> double { return this->scale; }
+
+void TiledPageBuffer::setScale(double scale) {
+    if (this->scale == scale) {
+        return;
+    }
+
+    // Keep the generation with the most content as fallback
+    if (!this->tiles.empty() || this->staleTiles.empty()) {
+        releaseAll(this->staleTiles);
+        this->staleTiles.swap(this->tiles);
+        this->staleScale = this->scale;
+    } else {
+        releaseAll(this->tiles);
+    }
+
+    this->scale = scale;
+}
+
+auto TiledPageBuffer::isEmpty() const -> bool { return this->tiles.empty() && this->staleTiles.empty(); }
+
+auto TiledPageBuffer::getPixelCount() const -> size_t {
+    return (this->tiles.size() + this->staleTiles.size()) * TILE_SIZE * TILE_SIZE;
+}
+
+void TiledPageBuffer::clear() {
+    releaseAll(this->tiles);
+    releaseAll(this->staleTiles);
+}
+
+void TiledPageBuffer::releaseAll(TileMap& map) {
+    for (auto& [key, tile]: map) { this->pool->release(tile.surface); }
+    map.clear();
+}
+
+void TiledPageBuffer::invalidateAll() {
+    for (auto& [key, tile]: this->tiles) { tile.dirty = true; }
+}
+
+auto TiledPageBuffer::isValid(int x, int y) const -> bool {
+    auto it = this->tiles.find(makeKey(x, y));
+    return it != this->tiles.end() && !it->second.dirty && !it->second.preview;
+}
+
+auto TiledPageBuffer::isPainted(int x, int y) const -> bool {
+    auto it = this->tiles.find(makeKey(x, y));
+    return it != this->tiles.end() && !it->second.dirty;
+}
+
+auto TiledPageBuffer::hasPreview() const -> bool {
+    return std::any_of(this->tiles.begin(), this->tiles.end(), [](auto const& e) { return e.second.preview; });
+}
+
+void TiledPageBuffer::setTile(int x, int y, cairo_surface_t* surface, bool preview) {
+    Tile& tile = this->tiles[makeKey(x, y)];
+    if (tile.surface) {
+        this->pool->release(tile.surface);
+    }
+    tile.surface = surface;
+    tile.dirty = false;
+    tile.preview = preview;
+}
+
+void TiledPageBuffer::releaseDirty() {
+    for (auto it = this->tiles.begin(); it != this->tiles.end();) {
+        if (it->second.dirty) {
+            this->pool->release(it->second.surface);
+            it = this->tiles.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void TiledPageBuffer::releasePreviews() {
+    for (auto it = this->tiles.begin(); it != this->tiles.end();) {
+        if (it->second.preview) {
+            this->pool->release(it->second.surface);
+            it = this->tiles.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void TiledPageBuffer::trim(const TileRange& keep, size_t maxTiles) {
+    if (this->tiles.size() <= maxTiles) {
+        return;
+    }
+
+    for (auto it = this->tiles.begin(); it != this->tiles.end();) {
+        if (!keep.contains(keyX(it->first), keyY(it->first))) {
+            this->pool->release(it->second.surface);
+            it = this->tiles.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void TiledPageBuffer::releaseStaleIfCovered(const TileRange& range) {
+    if (this->staleTiles.empty()) {
+        return;
+    }
+
+    for (int y = range.y1; y < range.y2; y++) {
+        for (int x = range.x1; x < range.x2; x++) {
+            if (!isValid(x, y)) {
+                return;
+            }
+        }
+    }
+
+    releaseAll(this->staleTiles);
+}
+
+void TiledPageBuffer::drawOnTiles(const Rectangle<double>& area, const std::function<void(cairo_t*)>& draw,
+                                  bool preview) {
+    TileRange range = tilesFor(area, this->scale);
+    for (auto& [key, tile]: this->tiles) {
+        int x = keyX(key);
+        int y = keyY(key);
+        if (tile.dirty || !range.contains(x, y)) {
+            continue;
+        }
+
+        cairo_t* cr = cairo_create(tile.surface);
+        cairo_translate(cr, -x * TILE_SIZE, -y * TILE_SIZE);
+        draw(cr);
+        cairo_destroy(cr);
+        tile.preview = tile.preview || preview;
+    }
+}
+
+void TiledPageBuffer::paintTiles(cairo_t* cr, const TileMap& map, double tileScale, double zoom,
+                                 const Rectangle<double>& area) {
+    double factor = zoom / tileScale;
+
+    for (auto const& [key, tile]: map) {
+        int x = keyX(key);
+        int y = keyY(key);
+        if (!tileArea(x, y, tileScale).intersects(area)) {
+            continue;
+        }
+
+        cairo_save(cr);
+        cairo_scale(cr, factor, factor);
+        cairo_set_source_surface(cr, tile.surface, x * TILE_SIZE, y * TILE_SIZE);
+        if (std::abs(factor - 1.0) > 1e-6) {
+            cairo_pattern_set_filter(cairo_get_source(cr), CAIRO_FILTER_FAST);
+        }
+        cairo_rectangle(cr, x * TILE_SIZE, y * TILE_SIZE, TILE_SIZE, TILE_SIZE);
+        cairo_fill(cr);
+        cairo_restore(cr);
+    }
+}
+
+auto TiledPageBuffer::paint(cairo_t* cr, const Rectangle<double>& area, double zoom, double targetScale,
+                            bool& complete) -> bool {
+    complete = this->scale == targetScale;
+
+    if (isEmpty()) {
+        complete = false;
+        return false;
+    }
+
+    Rectangle<double> pageArea = area;
+    pageArea *= 1.0 / zoom;
+
+    if (!this->staleTiles.empty()) {
+        paintTiles(cr, this->staleTiles, this->staleScale, zoom, pageArea);
+    }
+    paintTiles(cr, this->tiles, this->scale, zoom, pageArea);
+
+    if (complete) {
+        TileRange range = tilesFor(pageArea, this->scale);
+        for (int y = range.y1; y < range.y2 && complete; y++) {
+            for (int x = range.x1; x < range.x2 && complete; x++) { complete = isPainted(x, y); }
+        }
+    }
+
+    return true;
+}
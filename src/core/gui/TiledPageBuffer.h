@@ -0,0 +1,226 @@
+/*
+ * Xournal++
+ *
+ * Tiled backing store of a rendered page
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <cairo.h>
+
+#include "util/Rectangle.h"
+
+/**
+ * Recycles the surfaces of page tiles, so scrolling does not
+ * allocate and free image memory for every tile
+ */
+class TilePool {
+public:
+    TilePool() = default;
+    ~TilePool();
+    TilePool(const TilePool&) = delete;
+    TilePool& operator=(const TilePool&) = delete;
+
+public:
+    /**
+     * @return A TILE_SIZE x TILE_SIZE ARGB32 surface with undefined content
+     */
+    cairo_surface_t* acquire();
+
+    /**
+     * Gives a surface back to the pool, takes ownership of the reference
+     */
+    void release(cairo_surface_t* surface);
+
+private:
+    /**
+     * Free tiles kept for reuse (32 MiB)
+     */
+    static constexpr size_t MAX_FREE_TILES = 128;
+
+    std::mutex mutex;
+    std::vector<cairo_surface_t*> freeTiles;
+};
+
+/**
+ * The range [x1, x2) x [y1, y2) of tile indices
+ */
+struct TileRange {
+    int x1 = 0;
+    int y1 = 0;
+    int x2 = 0;
+    int y2 = 0;
+
+    bool isEmpty() const { return x1 >= x2 || y1 >= y2; }
+    bool contains(int x, int y) const { return x >= x1 && x < x2 && y >= y1 && y < y2; }
+    int count() const { return isEmpty() ? 0 : (x2 - x1) * (y2 - y1); }
+};
+
+/**
+ * The rendered content of a page, split in square tiles.
+ *
+ * Only the tiles of the visible part of a page are rendered, so the memory at high zoom
+ * levels depends on the size of the viewport and not of the page. Tiles are invalidated
+ * individually. After a zoom change, the tiles of the previous zoom are kept and painted
+ * scaled until the page is rendered at the new zoom.
+ *
+ * The buffer is not synchronized, all calls have to hold XojPageView::drawingMutex.
+ */
+class TiledPageBuffer {
+public:
+    /**
+     * Width and height of a tile, in device pixels
+     */
+    static constexpr int TILE_SIZE = 256;
+
+    struct Tile {
+        cairo_surface_t* surface = nullptr;
+        bool dirty = false;
+
+        /**
+         * Rendered with a low resolution PDF background, it is rendered again once the page settles
+         */
+        bool preview = false;
+    };
+
+public:
+    explicit TiledPageBuffer(TilePool* pool);
+    ~TiledPageBuffer();
+    TiledPageBuffer(const TiledPageBuffer&) = delete;
+    TiledPageBuffer& operator=(const TiledPageBuffer&) = delete;
+
+public:
+    /**
+     * @return The tiles covering the given area, in page coordinates, at the given scale
+     */
+    static TileRange tilesFor(const xoj::util::Rectangle<double>& area, double scale);
+
+    /**
+     * @return The area of a tile in page coordinates
+     */
+    static xoj::util::Rectangle<double> tileArea(int x, int y, double scale);
+
+    /**
+     * @return The scale (device pixel per page unit) of the current tiles
+     */
+    double getScale() const;
+
+    /**
+     * Changes the scale, the current tiles are kept as fallback until the page is rendered again
+     */
+    void setScale(double scale);
+
+    bool isEmpty() const;
+
+    /**
+     * @return The count of pixels held by this buffer
+     */
+    size_t getPixelCount() const;
+
+    /**
+     * Releases all tiles
+     */
+    void clear();
+
+    /**
+     * Marks all tiles as dirty, they are still painted until they are replaced
+     */
+    void invalidateAll();
+
+    /**
+     * @return true if the tile exists and is up to date
+     */
+    bool isValid(int x, int y) const;
+
+    /**
+     * @return true if the tile exists and is up to date, but may be a preview
+     */
+    bool isPainted(int x, int y) const;
+
+    /**
+     * @return true if there is a preview tile
+     */
+    bool hasPreview() const;
+
+    /**
+     * Installs a freshly rendered tile, takes ownership of the surface
+     *
+     * @param preview The tile has a low resolution PDF background
+     */
+    void setTile(int x, int y, cairo_surface_t* surface, bool preview = false);
+
+    /**
+     * Releases all tiles which are marked as dirty
+     */
+    void releaseDirty();
+
+    /**
+     * Releases all preview tiles
+     */
+    void releasePreviews();
+
+    /**
+     * Releases the tiles outside of keep, if there are more than maxTiles
+     */
+    void trim(const TileRange& keep, size_t maxTiles);
+
+    /**
+     * Releases the tiles of the previous scale if all tiles of the range are valid
+     */
+    void releaseStaleIfCovered(const TileRange& range);
+
+    /**
+     * Calls draw for each painted tile intersecting the page area, with a context in device pixels relative to the page
+     *
+     * @param preview The drawing has a low resolution PDF background, the tiles become previews
+     */
+    void drawOnTiles(const xoj::util::Rectangle<double>& area, const std::function<void(cairo_t*)>& draw,
+                     bool preview = false);
+
+    /**
+     * Paints the tiles intersecting area
+     *
+     * @param cr context in display coordinates relative to the page
+     * @param area the area to paint, in display coordinates
+     * @param zoom the current zoom (display pixel per page unit)
+     * @param complete Is set to false if a tile of area is missing, dirty or not rendered at targetScale.
+     *                 Previews count as complete, they are replaced by the job which rendered them.
+     * @return false if nothing could be painted
+     */
+    bool paint(cairo_t* cr, const xoj::util::Rectangle<double>& area, double zoom, double targetScale, bool& complete);
+
+private:
+    using Key = uint64_t;
+    using TileMap = std::unordered_map<Key, Tile>;
+
+    static Key makeKey(int x, int y);
+    static int keyX(Key key);
+    static int keyY(Key key);
+
+    void paintTiles(cairo_t* cr, const TileMap& tiles, double tileScale, double zoom,
+                    const xoj::util::Rectangle<double>& area);
+    void releaseAll(TileMap& tiles);
+
+private:
+    TilePool* pool;
+
+    TileMap tiles;
+    double scale = 0;
+
+    /**
+     * The tiles of the previous scale
+     */
+    TileMap staleTiles;
+    double staleScale = 0;
+};
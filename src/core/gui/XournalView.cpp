@@ -19,10 +19,12 @@
 #include "util/Rectangle.h"
 #include "util/Util.h"
 
+#include "LayerRasterCache.h"
 #include "Layout.h"
 #include "PageView.h"
 #include "RepaintHandler.h"
 #include "Shadow.h"
+#include "TiledPageBuffer.h"
 #include "XournalppCursor.h"
 #include "filesystem.h"
 
@@ -38,7 +40,10 @@ std::pair<size_t, size_t> XournalView::preloadPageBounds(size_t page, size_t max
 
 XournalView::XournalView(GtkWidget* parent, Control* control, ScrollHandling* scrollHandling):
         scrollHandling(scrollHandling), control(control) {
-    this->cache = new PdfCache(control->getSettings()->getPdfPageCacheSize());
+    this->cache = new PdfCache(control->getSettings()->getPdfPageCacheSize(),
+                               size_t(control->getSettings()->getPdfPageCacheMemory()) * 1024 * 1024);
+    this->tilePool = new TilePool();
+    this->layerCacheBudget = new LayerCacheBudget();
 
     registerListener(control);
 
@@ -73,6 +78,10 @@ XournalView::~XournalView() {
 
     delete this->cache;
     this->cache = nullptr;
+    delete this->tilePool;
+    this->tilePool = nullptr;
+    delete this->layerCacheBudget;
+    this->layerCacheBudget = nullptr;
     delete this->repaintHandler;
     this->repaintHandler = nullptr;
 
@@ -106,12 +115,52 @@ auto XournalView::cleanupBufferCache() -> void {
         auto&& page = this->viewPages[i];
         const size_t pageNum = i + 1;
         const bool isPreload = pagesLower <= pageNum && pageNum <= pagesUpper;
-        if (!isPreload && page->getLastVisibleTime() > 0 && page->getBufferPixels() > 0) {
+        if (!isPreload && !page->isPrefetched() && page->getLastVisibleTime() > 0 && page->getBufferPixels() > 0) {
             page->deleteViewBuffer();
         }
     }
 }
 
+void XournalView::prefetchPages(const Rectangle<double>& visible, const Rectangle<double>& predicted) {
+    const size_t budget = size_t(control->getSettings()->getPrefetchMemory()) * 1024 * 1024;
+    const double zoom = getZoom();
+
+    std::vector<XojPageView*> candidates;
+    for (XojPageView* page: this->viewPages) {
+        Rectangle<double> rect = page->getRect();
+        if (budget > 0 && !rect.intersects(visible) && rect.intersects(predicted)) {
+            candidates.push_back(page);
+        } else if (page->isPrefetched()) {
+            page->setPrefetched(false);
+            control->getScheduler()->cancelPrefetch(page);
+        }
+    }
+
+    auto distance = [&visible](XojPageView* page) {
+        Rectangle<double> rect = page->getRect();
+        return std::hypot(rect.x + rect.width / 2 - (visible.x + visible.width / 2),
+                          rect.y + rect.height / 2 - (visible.y + visible.height / 2));
+    };
+    std::sort(candidates.begin(), candidates.end(),
+              [&distance](XojPageView* a, XojPageView* b) { return distance(a) < distance(b); });
+
+    size_t used = 0;
+    for (XojPageView* page: candidates) {
+        Rectangle<double> rect = page->getRect();
+        Rectangle<double> area = *rect.intersects(predicted);
+        area = area.translated(-rect.x, -rect.y);
+        area *= 1 / zoom;
+
+        if (used < budget) {
+            used += page->prefetch(area);
+            page->setPrefetched(true);
+        } else if (page->isPrefetched()) {
+            page->setPrefetched(false);
+            control->getScheduler()->cancelPrefetch(page);
+        }
+    }
+}
+
 auto XournalView::getCurrentPage() const -> size_t { return currentPage; }
 
 const int scrollKeySize = 30;
@@ -325,9 +374,9 @@ void XournalView::pageSelected(size_t page) {
     }
 
     Document* doc = control->getDocument();
-    doc->lock();
+    doc->lockShared();
     auto const& file = doc->getEvMetadataFilename();
-    doc->unlock();
+    doc->unlockShared();
 
     control->getMetadataManager()->storeMetadata(file, page, getZoom());
 
@@ -495,9 +544,9 @@ void XournalView::zoomChanged() {
     }
 
     Document* doc = control->getDocument();
-    doc->lock();
+    doc->lockShared();
     auto const& file = doc->getEvMetadataFilename();
-    doc->unlock();
+    doc->unlockShared();
 
     control->getMetadataManager()->storeMetadata(file, getCurrentPage(), zoom->getZoomReal());
 
@@ -546,11 +595,15 @@ auto XournalView::getTextEditor() -> TextEditor* {
 
 auto XournalView::getCache() -> PdfCache* { return this->cache; }
 
+auto XournalView::getTilePool() -> TilePool* { return this->tilePool; }
+
+auto XournalView::getLayerCacheBudget() -> LayerCacheBudget* { return this->layerCacheBudget; }
+
 void XournalView::pageInserted(size_t page) {
     Document* doc = control->getDocument();
-    doc->lock();
+    doc->lockShared();
     auto* pageView = new XojPageView(this, doc->getPage(page));
-    doc->unlock();
+    doc->unlockShared();
 
     viewPages.insert(begin(viewPages) + page, pageView);
 
@@ -721,13 +774,13 @@ void XournalView::documentChanged(DocumentChangeType type) {
     this->cache->clearCache();
 
     Document* doc = control->getDocument();
-    doc->lock();
+    doc->lockShared();
 
     size_t pagecount = doc->getPageCount();
     viewPages.reserve(pagecount);
     for (size_t i = 0; i < pagecount; i++) { viewPages.push_back(new XojPageView(this, doc->getPage(i))); }
 
-    doc->unlock();
+    doc->unlockShared();
 
     layoutPages();
     scrollTo(0, 0);
@@ -27,6 +27,8 @@ class PagePositionHandler;
 class XojPageView;
 class PdfCache;
 class RepaintHandler;
+class TilePool;
+class LayerCacheBudget;
 class ScrollHandling;
 class TextEditor;
 class HandRecognition;
@@ -98,6 +100,8 @@ public:
     int getDpiScaleFactor();
     Document* getDocument();
     PdfCache* getCache();
+    TilePool* getTilePool();
+    LayerCacheBudget* getLayerCacheBudget();
     RepaintHandler* getRepaintHandler();
     GtkWidget* getWidget();
     XournalppCursor* getCursor();
@@ -151,6 +155,15 @@ private:
 
     void cleanupBufferCache();
 
+    /**
+     * Renders the pages in the predicted area ahead, nearest first, as long as they fit into the prefetch budget.
+     * Pages which were rendered ahead before and are not predicted anymore are not rendered further.
+     *
+     * @param visible The visible area, in layout coordinates
+     * @param predicted The area which is expected to be shown next, see ScrollPredictor
+     */
+    void prefetchPages(const xoj::util::Rectangle<double>& visible, const xoj::util::Rectangle<double>& predicted);
+
     static void staticLayoutPages(GtkWidget* widget, GtkAllocation* allocation, void* data);
 
 private:
@@ -171,6 +184,16 @@ private:
 
     PdfCache* cache = nullptr;
 
+    /**
+     * Shared surfaces for the tiles of all pages
+     */
+    TilePool* tilePool = nullptr;
+
+    /**
+     * Limits the memory of the rasterized layers of all pages
+     */
+    LayerCacheBudget* layerCacheBudget = nullptr;
+
     /**
      * Handler for rerendering pages / repainting pages
      */
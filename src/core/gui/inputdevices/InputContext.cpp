@@ -5,6 +5,7 @@
 #include "InputContext.h"
 
 #include "control/DeviceListHelper.h"
+#include "control/RenderStatistics.h"
 
 #include "InputEvents.h"
 #include "SetsquareInputHandler.h"
@@ -75,6 +76,8 @@ auto InputContext::handle(GdkEvent* sourceEvent) -> bool {
         return false;
     }
 
+    RenderStatistics::getInstance().inputReceived();
+
     InputEvent event = InputEvents::translateEvent(sourceEvent, this->getSettings());
 
     // Add the device to the list of known devices if it is currently unknown
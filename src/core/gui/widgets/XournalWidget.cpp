@@ -1,12 +1,17 @@
 #include "XournalWidget.h"
 
+#include <algorithm>
 #include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
 
 #include <config-debug.h>
 #include <gdk/gdk.h>
 #include <gdk/gdkkeysyms.h>
 
 #include "control/Control.h"
+#include "control/RenderStatistics.h"
 #include "control/settings/Settings.h"
 #include "control/tools/EditSelection.h"
 #include "gui/Layout.h"
@@ -258,11 +263,69 @@ void gtk_xournal_repaint_area(GtkWidget* widget, int x1, int y1, int x2, int y2)
     gtk_widget_queue_draw_area(widget, x1, y1, x2 - x1, y2 - y1);
 }
 
+/**
+ * Draws the render statistics in the top left corner of the visible area
+ */
+static void gtk_xournal_draw_statistics(GtkXournal* xournal, cairo_t* cr) {
+    RenderStatistics::Summary summary = RenderStatistics::getInstance().getSummary();
+
+    auto ms = [](double us) { return us / 1000.0; };
+    auto timingLine = [&ms](const std::string& name, const RenderStatistics::Timing& t) {
+        char line[256];
+        std::snprintf(line, sizeof(line), "%-16s %8llu  last %7.2f  avg %7.2f  max %7.2f ms", name.c_str(),
+                      static_cast<unsigned long long>(t.count), ms(static_cast<double>(t.last)), ms(t.average()),
+                      ms(static_cast<double>(t.max)));
+        return std::string(line);
+    };
+
+    std::vector<std::string> lines;
+    lines.push_back(std::to_string(summary.framesPerSecond) + " frames per second");
+    for (auto const& [name, timing]: summary.timings) { lines.push_back(timingLine(name, timing)); }
+    lines.push_back(timingLine("InputLatency", summary.inputLatency));
+    lines.push_back("PDF cache: " + std::to_string(summary.pdfCacheHits) + " hits, " +
+                    std::to_string(summary.pdfCacheMisses) + " misses");
+    lines.push_back("Elements: " + std::to_string(summary.elementsDrawn) + " drawn, " +
+                    std::to_string(summary.elementsCulled) + " culled");
+
+    constexpr double fontSize = 12;
+    constexpr double padding = 6;
+
+    cairo_save(cr);
+    cairo_translate(cr, gtk_adjustment_get_value(xournal->scrollHandling->getHorizontal()),
+                    gtk_adjustment_get_value(xournal->scrollHandling->getVertical()));
+
+    cairo_select_font_face(cr, "Monospace", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
+    cairo_set_font_size(cr, fontSize);
+
+    double width = 0;
+    for (const std::string& line: lines) {
+        cairo_text_extents_t ex;
+        cairo_text_extents(cr, line.c_str(), &ex);
+        width = std::max(width, ex.x_advance);
+    }
+
+    cairo_set_source_rgba(cr, 0, 0, 0, 0.7);
+    cairo_rectangle(cr, 0, 0, width + 2 * padding, static_cast<double>(lines.size()) * fontSize * 1.3 + 2 * padding);
+    cairo_fill(cr);
+
+    cairo_set_source_rgb(cr, 1, 1, 1);
+    double y = padding;
+    for (const std::string& line: lines) {
+        y += fontSize * 1.3;
+        cairo_move_to(cr, padding, y - fontSize * 0.3);
+        cairo_show_text(cr, line.c_str());
+    }
+
+    cairo_restore(cr);
+}
+
 static auto gtk_xournal_draw(GtkWidget* widget, cairo_t* cr) -> gboolean {
     g_return_val_if_fail(widget != nullptr, false);
     g_return_val_if_fail(GTK_IS_XOURNAL(widget), false);
 
     GtkXournal* xournal = GTK_XOURNAL(widget);
+    RenderStatistics& statistics = RenderStatistics::getInstance();
+    const int64_t frameStart = statistics.isEnabled() ? RenderStatistics::now() : 0;
 
     double x1 = NAN, x2 = NAN, y1 = NAN, y2 = NAN;
 
@@ -319,6 +382,13 @@ static auto gtk_xournal_draw(GtkWidget* widget, cairo_t* cr) -> gboolean {
         }
     }
 
+    if (frameStart != 0) {
+        statistics.framePainted(frameStart, RenderStatistics::now() - frameStart);
+        if (statistics.isHudVisible()) {
+            gtk_xournal_draw_statistics(xournal, cr);
+        }
+    }
+
     return true;
 }
 
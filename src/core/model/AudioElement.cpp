@@ -6,11 +6,17 @@ AudioElement::AudioElement(ElementType type): Element(type) {}
 
 AudioElement::~AudioElement() { this->timestamp = 0; }
 
-void AudioElement::setAudioFilename(fs::path fn) { this->audioFilename = std::move(fn); }
+void AudioElement::setAudioFilename(fs::path fn) {
+    this->audioFilename = std::move(fn);
+    contentChanged();
+}
 
 auto AudioElement::getAudioFilename() const -> fs::path const& { return this->audioFilename; }
 
-void AudioElement::setTimestamp(size_t timestamp) { this->timestamp = timestamp; }
+void AudioElement::setTimestamp(size_t timestamp) {
+    this->timestamp = timestamp;
+    contentChanged();
+}
 
 auto AudioElement::getTimestamp() const -> size_t { return this->timestamp; }
 
@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <utility>
 
+#include <config-debug.h>
 #include <config.h>
 
 #include "pdf/base/XojPdfAction.h"
@@ -18,14 +19,22 @@
 Document::Document(DocumentHandler* handler): handler(handler) {}
 
 Document::~Document() {
+#ifdef DEBUG_LOCK_STATISTICS
+    if (!this->snapshot) {
+        g_message("Document lock: %s", getLockStatistics().toString().c_str());
+    }
+#endif
+
     clearDocument(true);
     freeTreeContentModel();
 }
 
 void Document::freeTreeContentModel() {
     if (this->contentsModel) {
-        gtk_tree_model_foreach(this->contentsModel, reinterpret_cast<GtkTreeModelForeachFunc>(freeTreeContentEntry),
-                               this);
+        if (!this->snapshot) {
+            gtk_tree_model_foreach(this->contentsModel,
+                                   reinterpret_cast<GtkTreeModelForeachFunc>(freeTreeContentEntry), this);
+        }
 
         g_object_unref(this->contentsModel);
         this->contentsModel = nullptr;
@@ -73,6 +82,12 @@ void Document::unlock() {
 */
 auto Document::tryLock() -> bool { return this->documentLock.try_lock(); }
 
+void Document::lockShared() { this->documentLock.lock_shared(); }
+
+void Document::unlockShared() { this->documentLock.unlock_shared(); }
+
+auto Document::getLockStatistics() const -> LockStatistics { return this->documentLock.getStatistics(); }
+
 void Document::clearDocument(bool destroy) {
     if (this->preview) {
         cairo_surface_destroy(this->preview);
@@ -423,6 +438,29 @@ auto Document::operator=(const Document& doc) -> Document& {
     return *this;
 }
 
+auto Document::createSnapshot(const XojPage::SkipContent& skipContent) -> std::unique_ptr<Document> {
+    // A snapshot never fires document events, so it needs no handler
+    auto snapshot = std::make_unique<Document>(nullptr);
+    snapshot->snapshot = true;
+
+    snapshot->pdfDocument = this->pdfDocument;
+    snapshot->filepath = this->filepath;
+    snapshot->pdfFilepath = this->pdfFilepath;
+    snapshot->attachPdf = this->attachPdf;
+    snapshot->password = this->password;
+    snapshot->createBackupOnSave = this->createBackupOnSave;
+    snapshot->setPreview(this->preview);
+
+    if (this->contentsModel) {
+        snapshot->contentsModel = GTK_TREE_MODEL(g_object_ref(this->contentsModel));
+    }
+
+    snapshot->pages.reserve(this->pages.size());
+    for (const PageRef& p: this->pages) { snapshot->pages.push_back(XojPage::createSnapshot(p, skipContent)); }
+
+    return snapshot;
+}
+
 void Document::setCreateBackupOnSave(bool backup) { this->createBackupOnSave = backup; }
 
 auto Document::shouldCreateBackupOnSave() const -> bool { return this->createBackupOnSave; }
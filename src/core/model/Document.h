@@ -4,6 +4,9 @@
  * The document
  *
  * All methods are unlocked, you need to lock the document before you change something and unlock after.
+ * Readers lock the document shared, so several pages can be rendered at the same time. Changes of a single
+ * page lock the document shared and the page exclusive, see XojPage::lock. Changes of the page list or of
+ * several pages lock the document exclusive. The document is always locked before a page.
  *
  * @author Xournal++ Team
  * https://github.com/xournalpp/xournalpp
@@ -14,7 +17,6 @@
 #pragma once
 
 #include <memory>
-#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -22,6 +24,7 @@
 #include "pdf/base/XojPdfBookmarkIterator.h"
 #include "pdf/base/XojPdfDocument.h"
 #include "pdf/base/XojPdfPage.h"
+#include "util/InstrumentedSharedMutex.h"
 
 #include "DocumentHandler.h"
 #include "LinkDestination.h"
@@ -66,6 +69,18 @@ public:
 
     Document& operator=(const Document& doc);
 
+    /**
+     * Copies the document to save, export or print it without holding the lock while the user keeps
+     * editing. The document needs to be locked (shared is enough) while the snapshot is created, the
+     * snapshot itself is only accessed by one thread and needs no locking.
+     *
+     * Shares the PDF background, the bookmarks and the lazily loaded page contents with this document.
+     *
+     * @param skipContent Called for each page in order, the layers of the pages it returns true for are not
+     *                    copied, see XojPage::createSnapshot
+     */
+    std::unique_ptr<Document> createSnapshot(const XojPage::SkipContent& skipContent = nullptr);
+
     void setFilepath(fs::path filepath);
     fs::path getFilepath();
     fs::path getPdfFilepath();
@@ -86,10 +101,24 @@ public:
     cairo_surface_t* getPreview();
     void setPreview(cairo_surface_t* preview);
 
+    /**
+     * Locks the document exclusive, for changes of the document or of several pages
+     */
     void lock();
     void unlock();
     bool tryLock();
 
+    /**
+     * Locks the document to read it, other readers can hold the lock at the same time
+     */
+    void lockShared();
+    void unlockShared();
+
+    /**
+     * @return How often the document lock was contended
+     */
+    LockStatistics getLockStatistics() const;
+
 private:
     void buildContentsModel();
     void freeTreeContentModel();
@@ -142,6 +171,11 @@ private:
      */
     GtkTreeModel* contentsModel = nullptr;
 
+    /**
+     * Created by createSnapshot, the entries of the contents model belong to the original document
+     */
+    bool snapshot = false;
+
     /**
      *  create a backup before save
      */
@@ -155,7 +189,7 @@ private:
     /**
      * The lock of the document
      */
-    std::mutex documentLock;
+    InstrumentedSharedMutex documentLock;
 };
 
 template <class InputIter>
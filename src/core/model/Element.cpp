@@ -5,22 +5,58 @@
 #include "util/serializing/ObjectInputStream.h"
 #include "util/serializing/ObjectOutputStream.h"
 
+#include "SpatialIndex.h"
+
 using xoj::util::Rectangle;
 
 Element::Element(ElementType type): type(type) {}
 
-Element::~Element() = default;
+Element::Element(const Element& other):
+        Serializable(other),
+        sizeCalculated(other.sizeCalculated),
+        width(other.width),
+        height(other.height),
+        x(other.x),
+        y(other.y),
+        snappedBounds(other.snappedBounds),
+        type(other.type),
+        color(other.color) {}
+
+auto Element::operator=(const Element& other) -> Element& {
+    if (this == &other) {
+        return *this;
+    }
+
+    this->sizeCalculated = other.sizeCalculated;
+    this->width = other.width;
+    this->height = other.height;
+    this->x = other.x;
+    this->y = other.y;
+    this->snappedBounds = other.snappedBounds;
+    this->type = other.type;
+    this->color = other.color;
+    boundsChanged();
+    return *this;
+}
+
+Element::~Element() {
+    // Copy, remove() modifies the list
+    auto indices = this->spatialIndices;
+    for (SpatialIndex* index: indices) { index->remove(this); }
+}
 
 auto Element::getType() const -> ElementType { return this->type; }
 
 void Element::setX(double x) {
     this->x = x;
     this->sizeCalculated = false;
+    boundsChanged();
 }
 
 void Element::setY(double y) {
     this->y = y;
     this->sizeCalculated = false;
+    boundsChanged();
 }
 
 auto Element::getX() const -> double {
@@ -50,6 +86,15 @@ void Element::move(double dx, double dy) {
     this->x += dx;
     this->y += dy;
     this->snappedBounds = this->snappedBounds.translated(dx, dy);
+    boundsChanged();
+}
+
+void Element::boundsChanged() {
+    for (SpatialIndex* index: this->spatialIndices) { index->markDirty(this); }
+}
+
+void Element::contentChanged() {
+    for (SpatialIndex* index: this->spatialIndices) { index->markChanged(this); }
 }
 
 auto Element::getElementWidth() const -> double {
@@ -72,7 +117,10 @@ auto Element::boundingRect() const -> Rectangle<double> {
     return Rectangle<double>(getX(), getY(), getElementWidth(), getElementHeight());
 }
 
-void Element::setColor(Color color) { this->color = color; }
+void Element::setColor(Color color) {
+    this->color = color;
+    contentChanged();
+}
 
 auto Element::getColor() const -> Color { return this->color; }
 
@@ -20,6 +20,8 @@
 #include "util/Rectangle.h"
 #include "util/serializing/Serializable.h"
 
+class SpatialIndex;
+
 enum ElementType { ELEMENT_STROKE = 1, ELEMENT_IMAGE, ELEMENT_TEXIMAGE, ELEMENT_TEXT };
 
 class ShapeContainer {
@@ -33,6 +35,13 @@ class Element: public Serializable {
 protected:
     Element(ElementType type);
 
+    /**
+     * A copy is not part of the layers of the original, see spatialIndices. An element which is assigned to
+     * stays part of its own layers.
+     */
+    Element(const Element& other);
+    Element& operator=(const Element& other);
+
 public:
     ~Element() override;
 
@@ -78,6 +87,16 @@ private:
 protected:
     virtual void calcSize() const = 0;
 
+    /**
+     * Has to be called after the bounding box of the element changed
+     */
+    void boundsChanged();
+
+    /**
+     * Has to be called after the element changed the way it is drawn, without changing its bounding box
+     */
+    void contentChanged();
+
 protected:
     // If the size has been calculated
     mutable bool sizeCalculated = false;
@@ -102,4 +121,12 @@ private:
      * The color in RGB format
      */
     Color color{0U};
+
+    /**
+     * The indices of the layers containing this element. An element is only
+     * part of several layers while a merged layer is kept for undo.
+     */
+    std::vector<SpatialIndex*> spatialIndices;
+
+    friend class SpatialIndex;
 };
@@ -38,11 +38,13 @@ auto Image::clone() -> Element* {
 void Image::setWidth(double width) {
     this->width = width;
     this->calcSize();
+    boundsChanged();
 }
 
 void Image::setHeight(double height) {
     this->height = height;
     this->calcSize();
+    boundsChanged();
 }
 
 auto Image::cairoReadFunction(const Image* image, unsigned char* data, unsigned int length) -> cairo_status_t {
@@ -63,6 +65,7 @@ void Image::setImage(std::string data) {
         this->image = nullptr;
     }
     this->data = std::move(data);
+    contentChanged();
 }
 
 void Image::setImage(GdkPixbuf* img) { setImage(f_pixbuf_to_cairo_surface(img)); }
@@ -74,6 +77,7 @@ void Image::setImage(cairo_surface_t* image) {
     }
 
     this->image = image;
+    contentChanged();
 }
 
 auto Image::getImage() const -> cairo_surface_t* {
@@ -98,6 +102,7 @@ void Image::scale(double x0, double y0, double fx, double fy, double rotation,
     this->width *= fx;
     this->height *= fy;
     this->calcSize();
+    boundsChanged();
 }
 
 void Image::rotate(double x0, double y0, double th) {}
@@ -5,6 +5,7 @@
 Layer::Layer() = default;
 
 Layer::~Layer() {
+    this->index.clear();
     for (Element* e: this->elements) { delete e; }
     this->elements.clear();
 }
@@ -28,14 +29,13 @@ void Layer::addElement(Element* e) {
         return;
     }
 
-    for (Element* elem2: this->elements) {
-        if (e == elem2) {
-            g_warning("Layer::addElement: Element is already on this layer!");
-            return;
-        }
+    if (this->index.contains(e)) {
+        g_warning("Layer::addElement: Element is already on this layer!");
+        return;
     }
 
     this->elements.push_back(e);
+    this->index.insert(e, this->elements, this->elements.size() - 1);
 }
 
 void Layer::insertElement(Element* e, ElementIndex pos) {
@@ -45,12 +45,10 @@ void Layer::insertElement(Element* e, ElementIndex pos) {
         return;
     }
 
-    for (Element* elem2: this->elements) {
-        if (e == elem2) {
-            g_warning("Layer::insertElement() try to add an element twice!");
-            Stacktrace::printStracktrace();
-            return;
-        }
+    if (this->index.contains(e)) {
+        g_warning("Layer::insertElement() try to add an element twice!");
+        Stacktrace::printStracktrace();
+        return;
     }
 
     // prevent crash, even if this never should happen,
@@ -61,10 +59,13 @@ void Layer::insertElement(Element* e, ElementIndex pos) {
 
     // If the element should be inserted at the top
     if (pos >= static_cast<int>(this->elements.size())) {
+        pos = static_cast<ElementIndex>(this->elements.size());
         this->elements.push_back(e);
     } else {
         this->elements.insert(this->elements.begin() + pos, e);
     }
+
+    this->index.insert(e, this->elements, static_cast<size_t>(pos));
 }
 
 auto Layer::indexOf(Element* e) const -> ElementIndex {
@@ -81,6 +82,7 @@ auto Layer::removeElement(Element* e, bool free) -> ElementIndex {
     for (unsigned int i = 0; i < this->elements.size(); i++) {
         if (e == this->elements[i]) {
             this->elements.erase(this->elements.begin() + i);
+            this->index.remove(e);
 
             if (free) {
                 delete e;
@@ -108,8 +110,17 @@ void Layer::setVisible(bool visible) { this->visible = visible; }
 
 auto Layer::getElements() const -> const std::vector<Element*>& { return this->elements; }
 
+auto Layer::getElementsInArea(const xoj::util::Rectangle<double>& area) const -> std::vector<Element*> {
+    return this->index.query(area);
+}
+
 auto Layer::hasName() const -> bool { return name.has_value(); }
 
 auto Layer::getName() const -> std::string { return name.value_or(""); }
 
-void Layer::setName(const std::string& newName) { this->name = newName; }
+void Layer::setName(const std::string& newName) {
+    this->name = newName;
+    this->nameRevision++;
+}
+
+auto Layer::getRevision() const -> uint64_t { return this->index.getRevision() + this->nameRevision; }
@@ -14,7 +14,10 @@
 #include <string>
 #include <vector>
 
+#include "util/Rectangle.h"
+
 #include "Element.h"
+#include "SpatialIndex.h"
 
 template <class T>
 using optional = std::optional<T>;
@@ -57,6 +60,12 @@ public:
      */
     const std::vector<Element*>& getElements() const;
 
+    /**
+     * Returns the Element%s whose bounding box may intersect the area, in the order of the layer.
+     * Uses the spatial index, so the result may contain some elements not intersecting the area.
+     */
+    std::vector<Element*> getElementsInArea(const xoj::util::Rectangle<double>& area) const;
+
     /**
      * Returns whether or not the Layer is empty
      */
@@ -93,10 +102,22 @@ public:
      */
     void setName(const std::string& newName);
 
+    /**
+     * @return A counter which changes whenever an element is added, removed or changed, or the name changes.
+     *         Used to keep rasterized layers, see LayerRasterCache, and saved pages, see SavedPageCache.
+     */
+    uint64_t getRevision() const;
+
 private:
     std::vector<Element*> elements;
 
+    /**
+     * Spatial index of the elements, updated by the element itself if it changes
+     */
+    mutable SpatialIndex index;
+
     bool visible = true;
 
     optional<std::string> name;
+    uint64_t nameRevision = 0;
 };
@@ -0,0 +1,250 @@
+#include "SpatialIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "Element.h"
+
+using xoj::util::Rectangle;
+
+/**
+ * Edge length of a grid cell, in page coordinates
+ */
+constexpr double CELL_SIZE = 64.0;
+
+/**
+ * Elements touching more cells are kept in the list of large elements
+ */
+constexpr int64_t MAX_CELLS_PER_ELEMENT = 64;
+
+/**
+ * Coordinates outside of this range are not mapped to cells
+ */
+constexpr double MAX_COORDINATE = 1e8;
+
+SpatialIndex::~SpatialIndex() { clear(); }
+
+auto SpatialIndex::makeKey(int x, int y) -> Key {
+    return (static_cast<Key>(static_cast<uint32_t>(x)) << 32U) | static_cast<uint32_t>(y);
+}
+
+auto SpatialIndex::cellsFor(const Rectangle<double>& rect) -> CellRange {
+    CellRange range;
+    double x2 = rect.x + rect.width;
+    double y2 = rect.y + rect.height;
+    if (!(std::abs(rect.x) < MAX_COORDINATE && std::abs(rect.y) < MAX_COORDINATE && std::abs(x2) < MAX_COORDINATE &&
+          std::abs(y2) < MAX_COORDINATE)) {
+        // Empty range, also for NaN
+        return range;
+    }
+
+    range.x1 = static_cast<int>(std::floor(std::min(rect.x, x2) / CELL_SIZE));
+    range.y1 = static_cast<int>(std::floor(std::min(rect.y, y2) / CELL_SIZE));
+    range.x2 = static_cast<int>(std::floor(std::max(rect.x, x2) / CELL_SIZE));
+    range.y2 = static_cast<int>(std::floor(std::max(rect.y, y2) / CELL_SIZE));
+    return range;
+}
+
+void SpatialIndex::insert(Element* e, const std::vector<Element*>& elements, size_t pos) {
+    std::lock_guard lock{this->mutex};
+    this->revision++;
+
+    auto orderOf = [this](Element* neighbour, double& order) {
+        auto it = this->entries.find(neighbour);
+        if (it == this->entries.end()) {
+            return false;
+        }
+        order = it->second.order;
+        return true;
+    };
+
+    double prev = 0;
+    double next = 0;
+    bool hasPrev = pos > 0 && orderOf(elements[pos - 1], prev);
+    bool hasNext = pos + 1 < elements.size() && orderOf(elements[pos + 1], next);
+
+    Entry& entry = this->entries[e];
+    bool needsRenumber = false;
+    if (hasPrev && hasNext) {
+        entry.order = prev + (next - prev) / 2;
+        // The gap between the neighbours is exhausted
+        needsRenumber = !(prev < entry.order && entry.order < next);
+    } else if (hasPrev) {
+        entry.order = prev + 1;
+    } else if (hasNext) {
+        entry.order = next - 1;
+    } else {
+        entry.order = 0;
+        needsRenumber = elements.size() > 1;
+    }
+
+    e->spatialIndices.push_back(this);
+    registerElement(e, entry);
+
+    if (needsRenumber) {
+        renumber(elements);
+    }
+}
+
+void SpatialIndex::renumber(const std::vector<Element*>& elements) {
+    double order = 0;
+    for (Element* e: elements) {
+        auto it = this->entries.find(e);
+        if (it != this->entries.end()) {
+            it->second.order = order++;
+        }
+    }
+}
+
+void SpatialIndex::remove(Element* e) {
+    std::lock_guard lock{this->mutex};
+    this->revision++;
+
+    auto it = this->entries.find(e);
+    if (it == this->entries.end()) {
+        return;
+    }
+
+    unregisterElement(e, it->second);
+    this->entries.erase(it);
+    this->dirty.erase(e);
+    detach(e);
+}
+
+void SpatialIndex::detach(Element* e) {
+    auto& indices = e->spatialIndices;
+    indices.erase(std::remove(indices.begin(), indices.end(), this), indices.end());
+}
+
+void SpatialIndex::clear() {
+    std::lock_guard lock{this->mutex};
+    this->revision++;
+
+    for (auto& [e, entry]: this->entries) { detach(e); }
+    this->entries.clear();
+    this->cells.clear();
+    this->largeElements.clear();
+    this->dirty.clear();
+}
+
+void SpatialIndex::markDirty(Element* e) {
+    std::lock_guard lock{this->mutex};
+    this->revision++;
+    this->dirty.insert(e);
+}
+
+void SpatialIndex::markChanged(Element*) { this->revision++; }
+
+auto SpatialIndex::getRevision() const -> uint64_t { return this->revision; }
+
+auto SpatialIndex::contains(Element* e) -> bool {
+    std::lock_guard lock{this->mutex};
+    return this->entries.find(e) != this->entries.end();
+}
+
+auto SpatialIndex::size() const -> size_t { return this->entries.size(); }
+
+void SpatialIndex::registerElement(Element* e, Entry& entry) {
+    entry.cells = cellsFor(e->boundingRect());
+
+    int64_t width = static_cast<int64_t>(entry.cells.x2) - entry.cells.x1 + 1;
+    int64_t height = static_cast<int64_t>(entry.cells.y2) - entry.cells.y1 + 1;
+    entry.large = width <= 0 || height <= 0 || width * height > MAX_CELLS_PER_ELEMENT;
+
+    if (entry.large) {
+        this->largeElements.push_back(e);
+        return;
+    }
+
+    for (int y = entry.cells.y1; y <= entry.cells.y2; y++) {
+        for (int x = entry.cells.x1; x <= entry.cells.x2; x++) { this->cells[makeKey(x, y)].push_back(e); }
+    }
+}
+
+void SpatialIndex::unregisterElement(Element* e, const Entry& entry) {
+    if (entry.large) {
+        this->largeElements.erase(std::find(this->largeElements.begin(), this->largeElements.end(), e));
+        return;
+    }
+
+    for (int y = entry.cells.y1; y <= entry.cells.y2; y++) {
+        for (int x = entry.cells.x1; x <= entry.cells.x2; x++) {
+            auto cell = this->cells.find(makeKey(x, y));
+            if (cell == this->cells.end()) {
+                continue;
+            }
+
+            auto& list = cell->second;
+            list.erase(std::find(list.begin(), list.end(), e));
+            if (list.empty()) {
+                this->cells.erase(cell);
+            }
+        }
+    }
+}
+
+void SpatialIndex::updateDirty() {
+    for (Element* e: this->dirty) {
+        auto it = this->entries.find(e);
+        if (it == this->entries.end()) {
+            continue;
+        }
+
+        unregisterElement(e, it->second);
+        registerElement(e, it->second);
+    }
+    this->dirty.clear();
+}
+
+auto SpatialIndex::query(const Rectangle<double>& area) -> std::vector<Element*> {
+    std::lock_guard lock{this->mutex};
+
+    updateDirty();
+
+    std::vector<std::pair<double, Element*>> found;
+    auto addAll = [&](const std::vector<Element*>& list) {
+        for (Element* e: list) { found.emplace_back(this->entries[e].order, e); }
+    };
+
+    addAll(this->largeElements);
+
+    CellRange range = cellsFor(area);
+    int64_t width = static_cast<int64_t>(range.x2) - range.x1 + 1;
+    int64_t height = static_cast<int64_t>(range.y2) - range.y1 + 1;
+
+    if (width > 0 && height > 0) {
+        if (width * height > static_cast<int64_t>(this->cells.size())) {
+            // Large query areas: walk the occupied cells instead of the area
+            for (auto& [key, list]: this->cells) {
+                auto x = static_cast<int>(static_cast<uint32_t>(key >> 32U));
+                auto y = static_cast<int>(static_cast<uint32_t>(key));
+                if (x >= range.x1 && x <= range.x2 && y >= range.y1 && y <= range.y2) {
+                    addAll(list);
+                }
+            }
+        } else {
+            for (int y = range.y1; y <= range.y2; y++) {
+                for (int x = range.x1; x <= range.x2; x++) {
+                    auto cell = this->cells.find(makeKey(x, y));
+                    if (cell != this->cells.end()) {
+                        addAll(cell->second);
+                    }
+                }
+            }
+        }
+    }
+
+    std::sort(found.begin(), found.end());
+
+    std::vector<Element*> result;
+    result.reserve(found.size());
+    for (auto& [order, e]: found) {
+        // Elements spanning several cells are found multiple times
+        if (result.empty() || result.back() != e) {
+            result.push_back(e);
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,135 @@
+/*
+ * Xournal++
+ *
+ * Spatial index of the elements of a layer
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "util/Rectangle.h"
+
+class Element;
+
+/**
+ * Uniform grid over the bounding boxes of the elements of a layer.
+ *
+ * Each element is registered in all cells its bounding box touches, elements spanning
+ * many cells are kept in a separate list which is part of every query. Elements notify
+ * the index when their bounding box changes, they are registered again on the next query.
+ *
+ * The index also keeps the position of each element in the layer as an order key, so
+ * queries return the elements in drawing order.
+ */
+class SpatialIndex {
+public:
+    SpatialIndex() = default;
+    ~SpatialIndex();
+    SpatialIndex(const SpatialIndex&) = delete;
+    SpatialIndex& operator=(const SpatialIndex&) = delete;
+
+public:
+    /**
+     * Adds the element which was inserted at elements[pos]
+     */
+    void insert(Element* e, const std::vector<Element*>& elements, size_t pos);
+
+    /**
+     * Removes the element from the index
+     */
+    void remove(Element* e);
+
+    /**
+     * Removes all elements
+     */
+    void clear();
+
+    /**
+     * @return true if the element is part of this index
+     */
+    bool contains(Element* e);
+
+    /**
+     * Marks the bounding box of the element as outdated
+     */
+    void markDirty(Element* e);
+
+    /**
+     * Notes that the element is drawn differently, without a change of its bounding box
+     */
+    void markChanged(Element* e);
+
+    /**
+     * @return A counter which changes whenever an element is added, removed or changed
+     */
+    uint64_t getRevision() const;
+
+    /**
+     * @return The elements whose bounding box may intersect the area, in layer order.
+     *         The result may contain elements which do not intersect the area.
+     */
+    std::vector<Element*> query(const xoj::util::Rectangle<double>& area);
+
+    /**
+     * @return The count of indexed elements
+     */
+    size_t size() const;
+
+private:
+    struct CellRange {
+        int x1 = 0;
+        int y1 = 0;
+        int x2 = -1;
+        int y2 = -1;
+    };
+
+    struct Entry {
+        double order = 0;
+        CellRange cells;
+        bool large = false;
+    };
+
+    using Key = uint64_t;
+
+    static Key makeKey(int x, int y);
+    static CellRange cellsFor(const xoj::util::Rectangle<double>& rect);
+
+    void detach(Element* e);
+    void registerElement(Element* e, Entry& entry);
+    void unregisterElement(Element* e, const Entry& entry);
+    void renumber(const std::vector<Element*>& elements);
+    void updateDirty();
+
+private:
+    std::mutex mutex;
+
+    std::unordered_map<Element*, Entry> entries;
+
+    /**
+     * Cell -> elements touching this cell
+     */
+    std::unordered_map<Key, std::vector<Element*>> cells;
+
+    /**
+     * Elements which span too many cells to register them in each
+     */
+    std::vector<Element*> largeElements;
+
+    /**
+     * Elements whose bounding box changed since they were registered
+     */
+    std::unordered_set<Element*> dirty;
+
+    std::atomic<uint64_t> revision{0};
+};
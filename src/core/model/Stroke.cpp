@@ -1,13 +1,17 @@
 #include "Stroke.h"
 
 #include <cmath>
+#include <memory>
 #include <numeric>
+#include <utility>
 
+#include "util/GeometryKernels.h"
 #include "util/i18n.h"
 #include "util/serializing/ObjectInputStream.h"
 #include "util/serializing/ObjectOutputStream.h"
 
 using xoj::util::Rectangle;
+namespace geometry = xoj::util::geometry;
 
 template <typename Float>
 constexpr void updateBounds(Float& x, Float& y, Float& width, Float& height, Rectangle<Float>& snap, Point const& p,
@@ -85,7 +89,8 @@ void Stroke::serialize(ObjectOutputStream& out) const {
 
     out.writeInt(this->capStyle);
 
-    out.writeData(this->points.data(), this->points.size(), sizeof(Point));
+    std::vector<Point> pointVector = this->points.toVector();
+    out.writeData(pointVector.data(), pointVector.size(), sizeof(Point));
 
     this->lineStyle.serialize(out);
 
@@ -108,9 +113,10 @@ void Stroke::readSerialized(ObjectInputStream& in) {
     Point* p{};
     int count{};
     in.readData(reinterpret_cast<void**>(&p), &count);
-    this->points = std::vector<Point>{p, p + count};
+    this->points = StrokePoints(p, static_cast<size_t>(count));
     g_free(p);
     this->lineStyle.readSerialized(in);
+    geometryChanged();
 
     in.endObject();
 }
@@ -131,20 +137,27 @@ auto Stroke::getFill() const -> int { return fill; }
  * ...
  *   1: The shape is nearly fully transparent filled
  */
-void Stroke::setFill(int fill) { this->fill = fill; }
+void Stroke::setFill(int fill) {
+    this->fill = fill;
+    contentChanged();
+}
 
-void Stroke::setWidth(double width) { this->width = width; }
+void Stroke::setWidth(double width) {
+    this->width = width;
+    this->sizeCalculated = false;
+    boundsChanged();
+    geometryChanged();
+}
 
 auto Stroke::getWidth() const -> double { return this->width; }
 
 auto Stroke::rescaleWithMirror() -> bool { return true; }
 
 auto Stroke::isInSelection(ShapeContainer* container) -> bool {
-    for (auto&& p: this->points) {
-        double px = p.x;
-        double py = p.y;
-
-        if (!container->contains(px, py)) {
+    const double* xs = this->points.xData();
+    const double* ys = this->points.yData();
+    for (size_t i = 0; i < this->points.size(); i++) {
+        if (!container->contains(xs[i], ys[i])) {
             return false;
         }
     }
@@ -154,10 +167,10 @@ auto Stroke::isInSelection(ShapeContainer* container) -> bool {
 
 void Stroke::setFirstPoint(double x, double y) {
     if (!this->points.empty()) {
-        Point& p = this->points.front();
-        p.x = x;
-        p.y = y;
+        this->points.setPosition(0, x, y);
         this->sizeCalculated = false;
+        boundsChanged();
+        geometryChanged();
     }
 }
 
@@ -165,29 +178,46 @@ void Stroke::setLastPoint(double x, double y) { setLastPoint({x, y}); }
 
 void Stroke::setLastPoint(const Point& p) {
     if (!this->points.empty()) {
-        this->points.back() = p;
+        this->points.set(this->points.size() - 1, p);
         this->sizeCalculated = false;
+        boundsChanged();
+        geometryChanged();
     }
 }
 
 void Stroke::addPoint(const Point& p) {
-    this->points.emplace_back(p);
+    this->points.push_back(p);
     updateBounds(Element::x, Element::y, Element::width, Element::height, Element::snappedBounds, p,
                  hasPressure() ? p.z / 2.0 : this->width / 2.0);
+    boundsChanged();
+    geometryChanged();
+}
+
+void Stroke::setPoints(StrokePoints points) {
+    this->points = std::move(points);
+    this->sizeCalculated = false;
+    boundsChanged();
+    geometryChanged();
 }
 
 auto Stroke::getPointCount() const -> int { return this->points.size(); }
 
-auto Stroke::getPointVector() const -> std::vector<Point> const& { return points; }
+auto Stroke::getPointVector() const -> std::vector<Point> { return this->points.toVector(); }
+
+auto Stroke::getStrokePoints() const -> const StrokePoints& { return this->points; }
 
 void Stroke::deletePointsFrom(int index) {
     points.resize(std::min(size_t(index), points.size()));
     this->sizeCalculated = false;
+    boundsChanged();
+    geometryChanged();
 }
 
 void Stroke::deletePoint(int index) {
-    this->points.erase(std::next(begin(this->points), index));
+    this->points.erase(static_cast<size_t>(index));
     this->sizeCalculated = false;
+    boundsChanged();
+    geometryChanged();
 }
 
 auto Stroke::getPoint(int index) const -> Point {
@@ -195,29 +225,32 @@ auto Stroke::getPoint(int index) const -> Point {
         g_warning("Stroke::getPoint(%i) out of bounds!", index);
         return Point(0, 0, Point::NO_PRESSURE);
     }
-    return points.at(index);
+    return this->points.get(static_cast<size_t>(index));
 }
 
-auto Stroke::getPoints() const -> const Point* { return this->points.data(); }
-
-void Stroke::freeUnusedPointItems() { this->points = {begin(this->points), end(this->points)}; }
+void Stroke::freeUnusedPointItems() { this->points.shrink_to_fit(); }
 
-void Stroke::setToolType(StrokeTool type) { this->toolType = type; }
+void Stroke::setToolType(StrokeTool type) {
+    this->toolType = type;
+    contentChanged();
+}
 
 auto Stroke::getToolType() const -> StrokeTool { return this->toolType; }
 
-void Stroke::setLineStyle(const LineStyle& style) { this->lineStyle = style; }
+void Stroke::setLineStyle(const LineStyle& style) {
+    this->lineStyle = style;
+    geometryChanged();
+}
 
 auto Stroke::getLineStyle() const -> const LineStyle& { return this->lineStyle; }
 
 void Stroke::move(double dx, double dy) {
-    for (auto&& point: points) {
-        point.x += dx;
-        point.y += dy;
-    }
+    geometry::translate(this->points.xData(), this->points.yData(), this->points.size(), dx, dy);
     Element::x += dx;
     Element::y += dy;
     Element::snappedBounds = Element::snappedBounds.translated(dx, dy);
+    boundsChanged();
+    geometryChanged();
 }
 
 void Stroke::rotate(double x0, double y0, double th) {
@@ -227,8 +260,10 @@ void Stroke::rotate(double x0, double y0, double th) {
     cairo_matrix_rotate(&rotMatrix, th);
     cairo_matrix_translate(&rotMatrix, -x0, -y0);
 
-    for (auto&& p: points) { cairo_matrix_transform_point(&rotMatrix, &p.x, &p.y); }
+    transformPoints(rotMatrix);
     this->sizeCalculated = false;
+    boundsChanged();
+    geometryChanged();
     // Width and Height will likely be changed after this operation
 }
 
@@ -242,52 +277,67 @@ void Stroke::scale(double x0, double y0, double fx, double fy, double rotation,
     cairo_matrix_rotate(&scaleMatrix, -rotation);
     cairo_matrix_translate(&scaleMatrix, -x0, -y0);
 
-    for (auto&& p: points) {
-        cairo_matrix_transform_point(&scaleMatrix, &p.x, &p.y);
-
-        if (p.z != Point::NO_PRESSURE) {
-            p.z *= fz;
+    transformPoints(scaleMatrix);
+    if (double* zs = this->points.pressureData()) {
+        for (size_t i = 0; i < this->points.size(); i++) {
+            if (zs[i] != Point::NO_PRESSURE) {
+                zs[i] *= fz;
+            }
         }
     }
     this->width *= fz;
 
     this->sizeCalculated = false;
+    boundsChanged();
+    geometryChanged();
+}
+
+void Stroke::transformPoints(const cairo_matrix_t& matrix) {
+    geometry::transform(this->points.xData(), this->points.yData(), this->points.size(), matrix.xx, matrix.yx,
+                        matrix.xy, matrix.yy, matrix.x0, matrix.y0);
 }
 
 auto Stroke::hasPressure() const -> bool {
     if (!this->points.empty()) {
-        return this->points[0].z != Point::NO_PRESSURE;
+        return this->points.pressure(0) != Point::NO_PRESSURE;
     }
     return false;
 }
 
 auto Stroke::getAvgPressure() const -> double {
-    return std::accumulate(begin(this->points), end(this->points), 0.0,
-                           [](double l, Point const& p) { return l + p.z; }) /
-           this->points.size();
+    const double* zs = this->points.pressureData();
+    if (zs == nullptr) {
+        return Point::NO_PRESSURE;
+    }
+    return std::accumulate(zs, zs + this->points.size(), 0.0) / static_cast<double>(this->points.size());
 }
 
 void Stroke::scalePressure(double factor) {
     if (!hasPressure()) {
         return;
     }
-    for (auto&& p: this->points) { p.z *= factor; }
+    double* zs = this->points.pressureData();
+    for (size_t i = 0; i < this->points.size(); i++) { zs[i] *= factor; }
+    geometryChanged();
 }
 
 void Stroke::clearPressure() {
-    for (auto&& p: points) { p.z = Point::NO_PRESSURE; }
+    this->points.clearPressure();
+    geometryChanged();
 }
 
 void Stroke::setLastPressure(double pressure) {
     if (!this->points.empty()) {
-        this->points.back().z = pressure;
+        this->points.setPressure(this->points.size() - 1, pressure);
+        geometryChanged();
     }
 }
 
 void Stroke::setSecondToLastPressure(double pressure) {
-    auto const pointCount = this->getPointCount();
+    auto const pointCount = this->points.size();
     if (pointCount >= 2) {
-        this->points[pointCount - 2].z = pressure;
+        this->points.setPressure(pointCount - 2, pressure);
+        geometryChanged();
     }
 }
 
@@ -299,7 +349,8 @@ void Stroke::setPressure(const std::vector<double>& pressure) {
     }
 
     auto max_size = std::min(pressure.size(), this->points.size() - 1);
-    for (size_t i = 0U; i != max_size; ++i) { this->points[i].z = pressure[i]; }
+    for (size_t i = 0U; i != max_size; ++i) { this->points.setPressure(i, pressure[i]); }
+    geometryChanged();
 }
 
 /**
@@ -313,66 +364,24 @@ auto Stroke::intersects(double x, double y, double halfEraserSize) -> bool {
  * checks if the stroke is intersected by the eraser rectangle
  */
 auto Stroke::intersects(double x, double y, double halfEraserSize, double* gap) -> bool {
-    if (this->points.empty()) {
+    const double* xs = this->points.xData();
+    const double* ys = this->points.yData();
+    const size_t count = this->points.size();
+
+    size_t i = geometry::findHit(xs, ys, count, x, y, halfEraserSize);
+    if (i == count) {
         return false;
     }
 
-    double x1 = x - halfEraserSize;
-    double x2 = x + halfEraserSize;
-    double y1 = y - halfEraserSize;
-    double y2 = y + halfEraserSize;
-
-    double lastX = points[0].x;
-    double lastY = points[0].y;
-    for (auto&& point: points) {
-        double px = point.x;
-        double py = point.y;
-
-        if (px >= x1 && py >= y1 && px <= x2 && py <= y2) {
-            if (gap) {
-                *gap = 0;
-            }
-            return true;
-        }
-
-        double len = hypot(px - lastX, py - lastY);
-        if (len >= halfEraserSize) {
-            /**
-             * The distance of the center of the eraser box to the line passing through (lastx, lasty) and (px, py)
-             */
-            double p = std::abs((x - lastX) * (lastY - py) + (y - lastY) * (px - lastX)) / len;
-
-            // If the distance p of the center of the eraser box to the (full) line is in the range,
-            // we check whether the eraser box is not too far from the line segment through the two points.
-
-            if (p <= halfEraserSize) {
-                double centerX = (lastX + px) / 2;
-                double centerY = (lastY + py) / 2;
-                double distance = hypot(x - centerX, y - centerY);
-
-                // For the above check we imagine a circle whose center is the mid point of the two points of the stroke
-                // and whose radius is half the length of the line segment plus half the diameter of the eraser box
-                // plus some small padding
-                // If the center of the eraser box lies within that circle then we consider it to be close enough
-
-                distance -= halfEraserSize * std::sqrt(2);
-
-                constexpr double PADDING = 0.1;
-
-                if (distance <= len / 2 + PADDING) {
-                    if (gap) {
-                        *gap = distance;
-                    }
-                    return true;
-                }
-            }
+    if (gap) {
+        *gap = 0;
+        // The point itself is not inside the eraser box, so the segment to it was hit
+        if (i > 0 && !(xs[i] >= x - halfEraserSize && ys[i] >= y - halfEraserSize && xs[i] <= x + halfEraserSize &&
+                       ys[i] <= y + halfEraserSize)) {
+            geometry::segmentHit(xs[i - 1], ys[i - 1], xs[i], ys[i], x, y, halfEraserSize, gap);
         }
-
-        lastX = px;
-        lastY = py;
     }
-
-    return false;
+    return true;
 }
 
 /**
@@ -392,26 +401,17 @@ void Stroke::calcSize() const {
 
         // used for snapping
         Element::snappedBounds = Rectangle<double>{};
+        return;
     }
 
-    double minSnapX = DBL_MAX;
-    double maxSnapX = DBL_MIN;
-    double minSnapY = DBL_MAX;
-    double maxSnapY = DBL_MIN;
-
-    auto halfThick = 0.0;
+    const size_t count = this->points.size();
+    auto [minSnapX, minSnapY, maxSnapX, maxSnapY] = geometry::bounds(this->points.xData(), this->points.yData(), count);
 
-    //#pragma omp parralel
-    for (auto&& p: points) {
-        halfThick = std::max(halfThick, p.z);
-        minSnapX = std::min(minSnapX, p.x);
-        minSnapY = std::min(minSnapY, p.y);
-        maxSnapX = std::max(maxSnapX, p.x);
-        maxSnapY = std::max(maxSnapY, p.y);
+    auto halfThick = this->width / 2.0;
+    if (hasPressure()) {
+        halfThick = geometry::maxValue(this->points.pressureData(), count, 0.0) / 2.0;
     }
 
-    halfThick = points[0].z != Point::NO_PRESSURE ? halfThick / 2.0 : this->width / 2.0;
-
     auto minX = minSnapX - halfThick;
     auto minY = minSnapY - halfThick;
     auto maxX = maxSnapX + halfThick;
@@ -426,16 +426,35 @@ void Stroke::calcSize() const {
 
 auto Stroke::getErasable() -> ErasableStroke* { return this->eraseable; }
 
-void Stroke::setErasable(ErasableStroke* eraseable) { this->eraseable = eraseable; }
+void Stroke::setErasable(ErasableStroke* eraseable) {
+    this->eraseable = eraseable;
+    contentChanged();
+}
 
 auto Stroke::getStrokeCapStyle() const -> StrokeCapStyle { return this->capStyle; }
 
-void Stroke::setStrokeCapStyle(const StrokeCapStyle capStyle) { this->capStyle = capStyle; }
+void Stroke::setStrokeCapStyle(const StrokeCapStyle capStyle) {
+    this->capStyle = capStyle;
+    geometryChanged();
+}
+
+void Stroke::geometryChanged() {
+    std::atomic_store(&this->renderCache, std::shared_ptr<const StrokeRenderCache>());
+    contentChanged();
+}
+
+auto Stroke::getRenderCache() const -> std::shared_ptr<const StrokeRenderCache> {
+    return std::atomic_load(&this->renderCache);
+}
+
+void Stroke::setRenderCache(std::shared_ptr<const StrokeRenderCache> cache) const {
+    std::atomic_store(&this->renderCache, std::move(cache));
+}
 
 void Stroke::debugPrint() {
     g_message("%s", FC(FORMAT_STR("Stroke {1} / hasPressure() = {2}") % (uint64_t)this % this->hasPressure()));
 
-    for (auto&& p: points) { g_message("%lf / %lf", p.x, p.y); }
+    for (size_t i = 0; i < this->points.size(); i++) { g_message("%lf / %lf", this->points.x(i), this->points.y(i)); }
 
     g_message("\n");
 }
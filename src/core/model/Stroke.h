@@ -11,19 +11,24 @@
 
 #pragma once
 
+#include <memory>
+
 #include "AudioElement.h"
 #include "Element.h"
 #include "LineStyle.h"
 #include "Point.h"
+#include "StrokePoints.h"
 
 enum StrokeTool { STROKE_TOOL_PEN, STROKE_TOOL_ERASER, STROKE_TOOL_HIGHLIGHTER };
 enum StrokeCapStyle { ROUND, BUTT, SQUARE };
 
 class ErasableStroke;
+class StrokeRenderCache;
 
 class Stroke: public AudioElement {
 public:
     Stroke();
+    // A copy is not part of the layers of the original, see Element(const Element&)
     Stroke(Stroke const&) = default;
     Stroke(Stroke&&) = default;
 
@@ -62,14 +67,22 @@ public:
     void setFill(int fill);
 
     void addPoint(const Point& p);
+
+    /**
+     * Replaces all points at once, e.g. while loading a document
+     */
+    void setPoints(StrokePoints points);
     void setLastPoint(double x, double y);
     void setFirstPoint(double x, double y);
     void setLastPoint(const Point& p);
     int getPointCount() const;
     void freeUnusedPointItems();
-    std::vector<Point> const& getPointVector() const;
+    /**
+     * @return A copy of the points, use getStrokePoints() to iterate without copying
+     */
+    std::vector<Point> getPointVector() const;
+    const StrokePoints& getStrokePoints() const;
     Point getPoint(int index) const;
-    const Point* getPoints() const;
 
     void deletePoint(int index);
     void deletePointsFrom(int index);
@@ -106,6 +119,13 @@ public:
 
     [[maybe_unused]] void debugPrint();
 
+    /**
+     * The geometry prepared for drawing, see StrokeRenderCache. It is reset when the stroke changes.
+     * Can be called by several render threads at the same time.
+     */
+    std::shared_ptr<const StrokeRenderCache> getRenderCache() const;
+    void setRenderCache(std::shared_ptr<const StrokeRenderCache> cache) const;
+
 public:
     // Serialize interface
     void serialize(ObjectOutputStream& out) const override;
@@ -116,13 +136,21 @@ public:
 protected:
     void calcSize() const override;
 
+private:
+    void transformPoints(const cairo_matrix_t& matrix);
+
+    /**
+     * The points, the width or the style changed, drops the render cache and notifies the layer
+     */
+    void geometryChanged();
+
 private:
     // The stroke width cannot be inherited from Element
     double width = 0;
     StrokeTool toolType = STROKE_TOOL_PEN;
 
-    // The array with the points
-    std::vector<Point> points{};
+    // The points, stored as separate coordinate arrays
+    StrokePoints points{};
 
     /**
      * Dashed line
@@ -141,4 +169,6 @@ private:
     int fill = -1;
 
     StrokeCapStyle capStyle = StrokeCapStyle::ROUND;
+
+    mutable std::shared_ptr<const StrokeRenderCache> renderCache;
 };
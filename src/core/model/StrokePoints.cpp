@@ -0,0 +1,80 @@
+#include "StrokePoints.h"
+
+#include <algorithm>
+#include <iterator>
+
+StrokePoints::StrokePoints(const Point* points, size_t count) {
+    reserve(count);
+    for (size_t i = 0; i < count; i++) { push_back(points[i]); }
+}
+
+void StrokePoints::allocatePressure() { this->zs.assign(this->xs.size(), Point::NO_PRESSURE); }
+
+void StrokePoints::push_back(const Point& p) {
+    if (this->zs.empty() && p.z != Point::NO_PRESSURE) {
+        allocatePressure();
+    }
+
+    this->xs.push_back(p.x);
+    this->ys.push_back(p.y);
+    if (!this->zs.empty()) {
+        this->zs.push_back(p.z);
+    }
+}
+
+void StrokePoints::set(size_t index, const Point& p) {
+    this->xs[index] = p.x;
+    this->ys[index] = p.y;
+    setPressure(index, p.z);
+}
+
+void StrokePoints::setPosition(size_t index, double x, double y) {
+    this->xs[index] = x;
+    this->ys[index] = y;
+}
+
+void StrokePoints::setPressure(size_t index, double pressure) {
+    if (this->zs.empty()) {
+        if (pressure == Point::NO_PRESSURE) {
+            return;
+        }
+        allocatePressure();
+    }
+    this->zs[index] = pressure;
+}
+
+void StrokePoints::clearPressure() { std::vector<double>().swap(this->zs); }
+
+void StrokePoints::resize(size_t count) {
+    this->xs.resize(count);
+    this->ys.resize(count);
+    if (!this->zs.empty()) {
+        this->zs.resize(count, Point::NO_PRESSURE);
+    }
+}
+
+void StrokePoints::erase(size_t index) {
+    this->xs.erase(std::next(this->xs.begin(), static_cast<std::ptrdiff_t>(index)));
+    this->ys.erase(std::next(this->ys.begin(), static_cast<std::ptrdiff_t>(index)));
+    if (!this->zs.empty()) {
+        this->zs.erase(std::next(this->zs.begin(), static_cast<std::ptrdiff_t>(index)));
+    }
+}
+
+void StrokePoints::reserve(size_t count) {
+    this->xs.reserve(count);
+    this->ys.reserve(count);
+}
+
+void StrokePoints::shrink_to_fit() {
+    this->xs.shrink_to_fit();
+    this->ys.shrink_to_fit();
+    this->zs.shrink_to_fit();
+}
+
+auto StrokePoints::toVector() const -> std::vector<Point> {
+    std::vector<Point> points;
+    points.reserve(size());
+    for (size_t i = 0; i < size(); i++) { points.push_back(get(i)); }
+    return points;
+}
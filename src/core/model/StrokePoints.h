@@ -0,0 +1,101 @@
+/*
+ * Xournal++
+ *
+ * The points of a stroke, stored as separate coordinate arrays
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "Point.h"
+
+/**
+ * Structure of arrays storage for the points of a stroke.
+ *
+ * The x and y coordinates are kept in contiguous arrays, so loops over all points
+ * (bounding box, transformations, hit tests) can be vectorized by the compiler.
+ * The pressure array is only allocated once a point with pressure is added, strokes
+ * without pressure need two thirds of the memory of std::vector<Point>.
+ */
+class StrokePoints {
+public:
+    StrokePoints() = default;
+
+    /**
+     * Copies count points
+     */
+    StrokePoints(const Point* points, size_t count);
+
+public:
+    size_t size() const { return xs.size(); }
+    bool empty() const { return xs.empty(); }
+
+    /**
+     * @return The point at index, with NO_PRESSURE if the stroke has no pressure array
+     */
+    Point get(size_t index) const {
+        return Point(xs[index], ys[index], zs.empty() ? Point::NO_PRESSURE : zs[index]);
+    }
+
+    Point front() const { return get(0); }
+    Point back() const { return get(size() - 1); }
+
+    double x(size_t index) const { return xs[index]; }
+    double y(size_t index) const { return ys[index]; }
+    double pressure(size_t index) const { return zs.empty() ? Point::NO_PRESSURE : zs[index]; }
+
+    /**
+     * @return true if the pressure array is allocated. Single points may still have NO_PRESSURE
+     */
+    bool hasPressureArray() const { return !zs.empty(); }
+
+    const double* xData() const { return xs.data(); }
+    const double* yData() const { return ys.data(); }
+    double* xData() { return xs.data(); }
+    double* yData() { return ys.data(); }
+
+    /**
+     * @return The pressure values, or nullptr if the stroke has no pressure array
+     */
+    const double* pressureData() const { return zs.empty() ? nullptr : zs.data(); }
+    double* pressureData() { return zs.empty() ? nullptr : zs.data(); }
+
+    void push_back(const Point& p);
+    void set(size_t index, const Point& p);
+    void setPosition(size_t index, double x, double y);
+    void setPressure(size_t index, double pressure);
+
+    /**
+     * Releases the pressure array
+     */
+    void clearPressure();
+
+    void resize(size_t count);
+    void erase(size_t index);
+    void reserve(size_t count);
+    void shrink_to_fit();
+
+    /**
+     * @return A copy of the points in the layout of Point
+     */
+    std::vector<Point> toVector() const;
+
+private:
+    void allocatePressure();
+
+private:
+    std::vector<double> xs;
+    std::vector<double> ys;
+
+    /**
+     * Empty if no point has pressure
+     */
+    std::vector<double> zs;
+};
@@ -47,11 +47,13 @@ auto TexImage::clone() -> Element* {
 void TexImage::setWidth(double width) {
     this->width = width;
     this->calcSize();
+    boundsChanged();
 }
 
 void TexImage::setHeight(double height) {
     this->height = height;
     this->calcSize();
+    boundsChanged();
 }
 
 auto TexImage::cairoReadFunction(TexImage* image, unsigned char* data, unsigned int length) -> cairo_status_t {
@@ -70,12 +72,16 @@ auto TexImage::cairoReadFunction(TexImage* image, unsigned char* data, unsigned
  */
 auto TexImage::getBinaryData() const -> std::string const& { return this->binaryData; }
 
-void TexImage::setText(std::string text) { this->text = std::move(text); }
+void TexImage::setText(std::string text) {
+    this->text = std::move(text);
+    contentChanged();
+}
 
 auto TexImage::getText() const -> std::string { return this->text; }
 
 auto TexImage::loadData(std::string&& bytes, GError** err) -> bool {
     this->freeImageAndPdf();
+    contentChanged();
     this->binaryData = bytes;
     if (this->binaryData.length() < 4) {
         return false;
@@ -116,6 +122,7 @@ void TexImage::scale(double x0, double y0, double fx, double fy, double rotation
     this->width *= fx;
     this->height *= fy;
     this->calcSize();
+    boundsChanged();
 }
 
 void TexImage::rotate(double x0, double y0, double th) {
@@ -29,13 +29,18 @@ auto Text::clone() -> Element* {
     text->snappedBounds = this->snappedBounds;
     text->sizeCalculated = this->sizeCalculated;
     text->inEditing = this->inEditing;
+    text->setLayoutCache(getLayoutCache());
 
     return text;
 }
 
 auto Text::getFont() -> XojFont& { return font; }
 
-void Text::setFont(const XojFont& font) { this->font = font; }
+void Text::setFont(const XojFont& font) {
+    this->font = font;
+    setLayoutCache(nullptr);
+    contentChanged();
+}
 
 auto Text::getFontSize() const -> double { return font.getSize(); }
 
@@ -45,8 +50,10 @@ auto Text::getText() const -> std::string { return this->text; }
 
 void Text::setText(std::string text) {
     this->text = std::move(text);
+    setLayoutCache(nullptr);
 
     calcSize();
+    boundsChanged();
 }
 
 void Text::calcSize() const {
@@ -57,14 +64,19 @@ void Text::calcSize() const {
 void Text::setWidth(double width) {
     this->width = width;
     this->updateSnapping();
+    boundsChanged();
 }
 
 void Text::setHeight(double height) {
     this->height = height;
     this->updateSnapping();
+    boundsChanged();
 }
 
-void Text::setInEditing(bool inEditing) { this->inEditing = inEditing; }
+void Text::setInEditing(bool inEditing) {
+    this->inEditing = inEditing;
+    contentChanged();
+}
 
 void Text::scale(double x0, double y0, double fx, double fy, double rotation,
                  bool) {  // line width scaling option is not used
@@ -83,8 +95,10 @@ void Text::scale(double x0, double y0, double fx, double fy, double rotation,
 
     double size = this->font.getSize() * fx;
     this->font.setSize(size);
+    setLayoutCache(nullptr);
 
     calcSize();
+    boundsChanged();
 }
 
 void Text::rotate(double x0, double y0, double th) {}
@@ -93,6 +107,14 @@ auto Text::isInEditing() const -> bool { return this->inEditing; }
 
 auto Text::rescaleOnlyAspectRatio() -> bool { return true; }
 
+auto Text::getLayoutCache() const -> std::shared_ptr<const TextLayoutCache> {
+    return std::atomic_load(&this->layoutCache);
+}
+
+void Text::setLayoutCache(std::shared_ptr<const TextLayoutCache> cache) const {
+    std::atomic_store(&this->layoutCache, std::move(cache));
+}
+
 auto Text::intersects(double x, double y, double halfEraserSize) -> bool {
     return intersects(x, y, halfEraserSize, nullptr);
 }
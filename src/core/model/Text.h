@@ -11,12 +11,16 @@
 
 #pragma once
 
+#include <memory>
+
 #include <gtk/gtk.h>
 
 #include "AudioElement.h"
 #include "Element.h"
 #include "Font.h"
 
+class TextLayoutCache;
+
 class Text: public AudioElement {
 public:
     Text();
@@ -42,6 +46,13 @@ public:
 
     bool rescaleOnlyAspectRatio() override;
 
+    /**
+     * The measured size of the text, see TextLayoutCache. It is reset when the text or the font changes.
+     * Can be called by several render threads at the same time.
+     */
+    std::shared_ptr<const TextLayoutCache> getLayoutCache() const;
+    void setLayoutCache(std::shared_ptr<const TextLayoutCache> cache) const;
+
     /**
      * @overwrite
      */
@@ -65,4 +76,6 @@ private:
     std::string text;
 
     bool inEditing = false;
+
+    mutable std::shared_ptr<const TextLayoutCache> layoutCache;
 };
@@ -24,6 +24,12 @@ XojPage::XojPage(XojPage const& page):
         bgType(page.bgType),
         pdfBackgroundPage(page.pdfBackgroundPage),
         backgroundColor(page.backgroundColor) {
+    std::lock_guard<std::mutex> lock(page.contentMutex);
+    // Layers which were not loaded yet are loaded by the copy from the same source
+    this->contentLoader = page.contentLoader;
+    this->contentPending = page.contentPending.load();
+    this->contentError = page.contentError.load();
+
     this->layer.reserve(page.layer.size());
     std::transform(begin(page.layer), end(page.layer), std::back_inserter(this->layer),
                    [](auto* layer) { return layer->clone(); });
@@ -31,25 +37,113 @@ XojPage::XojPage(XojPage const& page):
 
 auto XojPage::clone() -> XojPage* { return new XojPage(*this); }
 
+auto XojPage::createSnapshot(const PageRef& page, const SkipContent& skipContent) -> PageRef {
+    std::shared_lock<std::shared_mutex> pageLock(page->pageMutex);
+
+    auto snapshot = std::make_shared<XojPage>(page->width, page->height);
+    snapshot->backgroundImage = page->backgroundImage;
+    snapshot->currentLayer = page->currentLayer;
+    snapshot->bgType = page->bgType;
+    snapshot->pdfBackgroundPage = page->pdfBackgroundPage;
+    snapshot->backgroundColor = page->backgroundColor;
+    snapshot->backgroundVisible = page->backgroundVisible;
+    snapshot->backgroundName = page->backgroundName;
+    snapshot->snapshotSource = page;
+
+    // A render job may load the layers meanwhile, while it holds the page lock shared as well
+    std::lock_guard<std::mutex> lock(page->contentMutex);
+    snapshot->snapshotRevision = page->getContentRevisionUnlocked();
+    if (skipContent && skipContent(page, snapshot->snapshotRevision)) {
+        snapshot->contentSkipped = true;
+        return snapshot;
+    }
+
+    if (page->contentPending) {
+        // The loader only reads the file content, it can be shared instead of parsing the layers now
+        snapshot->contentLoader = page->contentLoader;
+        snapshot->contentPending = true;
+    }
+    snapshot->contentError = page->contentError.load();
+
+    snapshot->layer.reserve(page->layer.size());
+    for (Layer* l: page->layer) {
+        Layer* copy = l->clone();
+        copy->setVisible(l->isVisible());
+        snapshot->layer.push_back(copy);
+    }
+    return snapshot;
+}
+
+auto XojPage::getSnapshotSource() const -> PageRef { return this->snapshotSource; }
+
+auto XojPage::getSnapshotRevision() const -> const Revision& { return this->snapshotRevision; }
+
+auto XojPage::isContentSkipped() const -> bool { return this->contentSkipped; }
+
+void XojPage::lock() { this->pageMutex.lock(); }
+
+void XojPage::unlock() { this->pageMutex.unlock(); }
+
+void XojPage::lockShared() { this->pageMutex.lock_shared(); }
+
+void XojPage::unlockShared() { this->pageMutex.unlock_shared(); }
+
+void XojPage::setContentLoader(ContentLoader loader) {
+    std::lock_guard<std::mutex> lock(this->contentMutex);
+    this->contentLoader = std::move(loader);
+    this->contentPending = true;
+}
+
+auto XojPage::isContentLoaded() const -> bool { return !this->contentPending; }
+
+void XojPage::ensureContentLoaded() {
+    if (!this->contentPending.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(this->contentMutex);
+    if (!this->contentPending) {
+        // Loaded by another thread in the meantime
+        return;
+    }
+
+    std::vector<Layer*> loaded;
+    if (!this->contentLoader(loaded)) {
+        this->contentError = true;
+    }
+    this->layer.insert(this->layer.begin(), loaded.begin(), loaded.end());
+    this->layersRevision++;
+    this->contentLoader = nullptr;
+    this->contentPending.store(false, std::memory_order_release);
+}
+
+auto XojPage::hasContentError() const -> bool { return this->contentError; }
+
 void XojPage::addLayer(Layer* layer) {
+    ensureContentLoaded();
     this->layer.push_back(layer);
+    this->layersRevision++;
     this->currentLayer = npos;
 }
 
 void XojPage::insertLayer(Layer* layer, int index) {
+    ensureContentLoaded();
     if (index >= static_cast<int>(this->layer.size())) {
         addLayer(layer);
         return;
     }
 
     this->layer.insert(this->layer.begin() + index, layer);
+    this->layersRevision++;
     this->currentLayer = index + 1;
 }
 
 void XojPage::removeLayer(Layer* layer) {
+    ensureContentLoaded();
     for (unsigned int i = 0; i < this->layer.size(); i++) {
         if (layer == this->layer[i]) {
             this->layer.erase(this->layer.begin() + i);
+            this->layersRevision++;
             break;
         }
     }
@@ -58,22 +152,27 @@ void XojPage::removeLayer(Layer* layer) {
 
 void XojPage::setSelectedLayerId(int id) { this->currentLayer = id; }
 
-auto XojPage::getLayers() -> std::vector<Layer*>* { return &this->layer; }
+auto XojPage::getLayers() -> std::vector<Layer*>* {
+    ensureContentLoaded();
+    return &this->layer;
+}
 
-auto XojPage::getLayerCount() -> size_t { return this->layer.size(); }
+auto XojPage::getLayerCount() -> size_t {
+    ensureContentLoaded();
+    return this->layer.size();
+}
 
 /**
  * Layer ID 0 = Background, Layer ID 1 = Layer 1
  */
 auto XojPage::getSelectedLayerId() -> int {
-    if (this->currentLayer == npos) {
-        this->currentLayer = this->layer.size();
-    }
-
-    return this->currentLayer;
+    ensureContentLoaded();
+    // Without a selection the top layer is selected. Not stored, the page may be read by several render jobs.
+    return static_cast<int>(this->currentLayer == npos ? this->layer.size() : this->currentLayer);
 }
 
 void XojPage::setLayerVisible(int layerId, bool visible) {
+    ensureContentLoaded();
     if (layerId < 0) {
         return;
     }
@@ -92,6 +191,7 @@ void XojPage::setLayerVisible(int layerId, bool visible) {
 }
 
 auto XojPage::isLayerVisible(int layerId) -> bool {
+    ensureContentLoaded();
     if (layerId < 0) {
         return false;
     }
@@ -114,15 +214,20 @@ void XojPage::setBackgroundPdfPageNr(size_t page) {
     this->pdfBackgroundPage = page;
     this->bgType.format = PageTypeFormat::Pdf;
     this->bgType.config = "";
+    this->backgroundRevision++;
 }
 
-void XojPage::setBackgroundColor(Color color) { this->backgroundColor = color; }
+void XojPage::setBackgroundColor(Color color) {
+    this->backgroundColor = color;
+    this->backgroundRevision++;
+}
 
 auto XojPage::getBackgroundColor() const -> Color { return this->backgroundColor; }
 
 void XojPage::setSize(double width, double height) {
     this->width = width;
     this->height = height;
+    this->backgroundRevision++;
 }
 
 auto XojPage::getWidth() const -> double { return this->width; }
@@ -132,6 +237,7 @@ auto XojPage::getHeight() const -> double { return this->height; }
 auto XojPage::getPdfPageNr() const -> size_t { return this->pdfBackgroundPage; }
 
 auto XojPage::isAnnotated() -> bool {
+    ensureContentLoaded();
     for (Layer* l: this->layer) {
         if (l->isAnnotated()) {
             return true;
@@ -149,15 +255,20 @@ void XojPage::setBackgroundType(const PageType& bgType) {
     if (!bgType.isImagePage()) {
         this->backgroundImage.free();
     }
+    this->backgroundRevision++;
 }
 
 auto XojPage::getBackgroundType() -> PageType { return this->bgType; }
 
 auto XojPage::getBackgroundImage() -> BackgroundImage& { return this->backgroundImage; }
 
-void XojPage::setBackgroundImage(BackgroundImage img) { this->backgroundImage = std::move(img); }
+void XojPage::setBackgroundImage(BackgroundImage img) {
+    this->backgroundImage = std::move(img);
+    this->backgroundRevision++;
+}
 
 auto XojPage::getSelectedLayer() -> Layer* {
+    ensureContentLoaded();
     if (this->layer.empty()) {
         addLayer(new Layer());
     }
@@ -174,4 +285,23 @@ auto XojPage::getBackgroundName() const -> std::string { return backgroundName.v
 
 auto XojPage::backgroundHasName() const -> bool { return backgroundName.has_value(); }
 
-void XojPage::setBackgroundName(const std::string& newName) { backgroundName = newName; }
+void XojPage::setBackgroundName(const std::string& newName) {
+    backgroundName = newName;
+    this->backgroundRevision++;
+}
+
+auto XojPage::getBackgroundRevision() const -> uint64_t { return this->backgroundRevision; }
+
+auto XojPage::getContentRevision() const -> Revision {
+    // The layers may be loaded by another thread, which only holds the page lock shared
+    std::lock_guard<std::mutex> lock(this->contentMutex);
+    return getContentRevisionUnlocked();
+}
+
+auto XojPage::getContentRevisionUnlocked() const -> Revision {
+    // The layers which are not loaded yet did not change, loading them changes the layers revision
+    Revision revision{this->backgroundRevision, this->layersRevision};
+    revision.reserve(this->layer.size() + 2);
+    for (Layer* l: this->layer) { revision.push_back(l->getRevision()); }
+    return revision;
+}
@@ -11,6 +11,11 @@
 
 #pragma once
 
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <vector>
 
@@ -21,6 +26,9 @@
 #include "PageHandler.h"
 #include "PageType.h"
 
+class XojPage;
+using PageRef = std::shared_ptr<XojPage>;
+
 template <class T>
 using optional = std::optional<T>;
 
@@ -63,6 +71,10 @@ public:
 
     std::vector<Layer*>* getLayers();
     size_t getLayerCount();
+
+    /**
+     * @return The ID of the selected layer, the top layer if none was selected. Only reads the page.
+     */
     int getSelectedLayerId();
     void setSelectedLayerId(int id);
     static bool isLayerVisible(Layer* layer);
@@ -77,11 +89,105 @@ public:
     bool backgroundHasName() const;
     void setBackgroundName(const std::string& newName);
 
+    /**
+     * @return A counter which changes whenever the background (type, color, image, PDF page, name or size) changes
+     */
+    uint64_t getBackgroundRevision() const;
+
+    /**
+     * The revisions of the background, of the layer list and of each layer, see getContentRevision
+     */
+    using Revision = std::vector<uint64_t>;
+
+    /**
+     * @return The revision of all saved content of the page. The content did not change as long as the revision
+     *         is equal. The page needs to be locked, see lockShared. Layers which are loaded lazily by another
+     *         thread meanwhile are waited for.
+     */
+    Revision getContentRevision() const;
+
     /**
      * Copies this page an all it's contents to a new page
      */
     XojPage* clone();
 
+    /**
+     * Decides if the layers of a page are not needed in a snapshot, called with the page and its content revision
+     */
+    using SkipContent = std::function<bool(const PageRef& page, const Revision& revision)>;
+
+    /**
+     * Copies the page for a document snapshot, see Document::createSnapshot. The copy is not changed by
+     * the user. If the layers of page were not loaded yet they are not copied, the snapshot loads them
+     * from the same source when they are accessed.
+     *
+     * @param skipContent If it returns true the layers are not copied, see isContentSkipped. It is called while
+     *                    the layers are locked, so it must not access them.
+     */
+    static PageRef createSnapshot(const PageRef& page, const SkipContent& skipContent = nullptr);
+
+    /**
+     * @return true if this is a snapshot without the layers of its source, because they were not needed
+     */
+    bool isContentSkipped() const;
+
+    /**
+     * @return The page of the document this page is a snapshot of, or nullptr if it is no snapshot
+     */
+    PageRef getSnapshotSource() const;
+
+    /**
+     * @return The content revision of the snapshot source when the snapshot was created
+     */
+    const Revision& getSnapshotRevision() const;
+
+    /**
+     * Creates the layers of a page which is loaded lazily
+     *
+     * @return false if the layers could not be loaded completely, layers contains the part which was loaded
+     */
+    using ContentLoader = std::function<bool(std::vector<Layer*>& layers)>;
+
+    /**
+     * Defers the creation of the layers until they are accessed for the first time
+     */
+    void setContentLoader(ContentLoader loader);
+
+    /**
+     * @return false if the layers were deferred and not created yet
+     */
+    bool isContentLoaded() const;
+
+    /**
+     * Creates the layers now, if they were deferred. Called by all methods accessing the layers.
+     */
+    void ensureContentLoaded();
+
+    /**
+     * @return true if the deferred layers could not be loaded completely. The page must not be saved, the
+     *         content which could not be loaded would be lost.
+     */
+    bool hasContentError() const;
+
+    /**
+     * Locks the page exclusive, for changes of this page only. The document needs to be locked shared
+     * before, see Document::lockShared.
+     */
+    void lock();
+    void unlock();
+
+    /**
+     * Locks the page to read it while the document is locked shared
+     */
+    void lockShared();
+    void unlockShared();
+
+private:
+    /**
+     * See getContentRevision, contentMutex needs to be locked
+     */
+    Revision getContentRevisionUnlocked() const;
+
 private:
     /**
      * The Background image if any
@@ -94,11 +200,42 @@ private:
     double width = 0;
     double height = 0;
 
+    std::atomic<uint64_t> backgroundRevision{0};
+
+    /**
+     * Changes whenever a layer is added or removed
+     */
+    std::atomic<uint64_t> layersRevision{0};
+
     /**
      * The layer list
      */
     std::vector<Layer*> layer;
 
+    /**
+     * Creates the layers of a lazily loaded page, see setContentLoader
+     */
+    ContentLoader contentLoader;
+    std::atomic<bool> contentPending{false};
+    std::atomic<bool> contentError{false};
+    bool contentSkipped = false;
+
+    /**
+     * Guards the loader, also while the page is copied
+     */
+    mutable std::mutex contentMutex;
+
+    /**
+     * The lock of the page, see lock()
+     */
+    std::shared_mutex pageMutex;
+
+    /**
+     * The page this page was copied from by createSnapshot
+     */
+    PageRef snapshotSource;
+    Revision snapshotRevision;
+
     /**
      * The current selected layer ID
      */
@@ -84,6 +84,15 @@ bool ErasableStroke::erase(double x, double y, double halfEraserSize, PartList::
         return false;
     }
 
+    // The eraser can only hit the part if its center is close to the bounding box of the part. This skips
+    // the distance computations for all far away parts of long strokes.
+    double margin = halfEraserSize * 2 + 0.1;
+    if (x < partIter->getX() - margin || y < partIter->getY() - margin ||
+        x > partIter->getX() + partIter->getElementWidth() + margin ||
+        y > partIter->getY() + partIter->getElementHeight() + margin) {
+        return false;
+    }
+
     Point eraser(x, y);
 
     Point a = partIter->getPoints().front();
@@ -259,6 +268,7 @@ auto ErasableStroke::erasePart(double x, double y, double halfEraserSize, PartLi
             // Push the other subparts
             PartList::iterator newPart = list.emplace(insertPos, partIter->getWidth());
             newPart->getPoints() = std::move(*it);
+            newPart->calcSize();
         }
     } else {
         // no parts, all deleted
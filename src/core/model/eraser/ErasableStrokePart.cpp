@@ -53,9 +53,9 @@ auto ErasableStrokePart::getElementWidth() const -> double { return this->elemen
 auto ErasableStrokePart::getElementHeight() const -> double { return this->elementHeight; }
 
 void ErasableStrokePart::addPoint(Point p) {
-    calcSize();
-
     points.emplace_back(std::move(p));
+
+    calcSize();
 }
 
 auto ErasableStrokePart::getWidth() const -> double { return this->width; }
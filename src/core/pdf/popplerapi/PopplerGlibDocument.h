@@ -11,6 +11,9 @@
 
 #pragma once
 
+#include <memory>
+#include <mutex>
+
 #include <poppler.h>
 
 #include "pdf/base/XojPdfDocumentInterface.h"
@@ -39,4 +42,10 @@ public:
 
 private:
     PopplerDocument* document = nullptr;
+
+    /**
+     * Poppler documents are not thread safe, the pages of one document are rendered one at a time.
+     * Shared by all copies of the document and by its pages.
+     */
+    std::shared_ptr<std::mutex> renderMutex;
 };
@@ -1,6 +1,7 @@
 #include "PopplerGlibPage.h"
 
 #include <sstream>
+#include <utility>
 
 #include <poppler-page.h>
 #include <poppler.h>
@@ -11,13 +12,14 @@
 #include "cairo.h"
 
 
-PopplerGlibPage::PopplerGlibPage(PopplerPage* page): page(page) {
+PopplerGlibPage::PopplerGlibPage(PopplerPage* page, std::shared_ptr<std::mutex> renderMutex):
+        page(page), renderMutex(std::move(renderMutex)) {
     if (page != nullptr) {
         g_object_ref(page);
     }
 }
 
-PopplerGlibPage::PopplerGlibPage(const PopplerGlibPage& other): page(other.page) {
+PopplerGlibPage::PopplerGlibPage(const PopplerGlibPage& other): page(other.page), renderMutex(other.renderMutex) {
     if (page != nullptr) {
         g_object_ref(page);
     }
@@ -40,6 +42,7 @@ PopplerGlibPage& PopplerGlibPage::operator=(const PopplerGlibPage& other) {
     }
 
     page = other.page;
+    renderMutex = other.renderMutex;
     if (page != nullptr) {
         g_object_ref(page);
     }
@@ -62,6 +65,7 @@ auto PopplerGlibPage::getHeight() -> double {
 
 void PopplerGlibPage::render(cairo_t* cr, bool forPrinting)  // NOLINT(google-default-arguments)
 {
+    std::lock_guard lock{*this->renderMutex};
     if (forPrinting) {
         poppler_page_render_for_printing(page, cr);
     } else {
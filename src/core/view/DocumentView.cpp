@@ -1,11 +1,16 @@
 #include "DocumentView.h"
 
+#include <algorithm>
+#include <cmath>
+
+#include "control/RenderStatistics.h"
 #include "control/tools/EditSelection.h"
 #include "control/tools/Selection.h"
 #include "model/Layer.h"
 #include "model/eraser/ErasableStroke.h"
 #include "view/background/MainBackgroundPainter.h"
 
+#include "StrokeRenderCache.h"
 #include "StrokeView.h"
 #include "TextView.h"
 
@@ -47,11 +52,29 @@ void DocumentView::drawStroke(cairo_t* cr, Stroke* s, bool noColor) const {
         return;
     }
 
-    StrokeView sv(cr, s);
+    StrokeView sv(cr, s, levelOfDetailScale(cr));
 
     sv.paint(this->dontRenderEditingStroke, this->markAudioStroke, noColor);
 }
 
+auto DocumentView::levelOfDetailScale(cairo_t* cr) -> double {
+    cairo_surface_t* target = cairo_get_target(cr);
+    if (cairo_surface_get_type(target) != CAIRO_SURFACE_TYPE_IMAGE) {
+        // Vector output (PDF export, printing) keeps every point
+        return 1;
+    }
+
+    cairo_matrix_t matrix;
+    cairo_get_matrix(cr, &matrix);
+    double deviceScaleX = 1;
+    double deviceScaleY = 1;
+    cairo_surface_get_device_scale(target, &deviceScaleX, &deviceScaleY);
+
+    double scale = std::sqrt(std::abs(matrix.xx * matrix.yy - matrix.xy * matrix.yx)) *
+                   std::max(deviceScaleX, deviceScaleY);
+    return scale < StrokeRenderCache::LOD_MAX_SCALE ? scale : 1;
+}
+
 void DocumentView::drawText(cairo_t* cr, Text* t) const {
     cairo_matrix_t defaultMatrix = {0};
     cairo_get_matrix(cr, &defaultMatrix);
@@ -186,7 +209,16 @@ void DocumentView::drawLayer(cairo_t* cr, Layer* l) {
     int drawn = 0;
     int notDrawn = 0;
 #endif  // DEBUG_SHOW_REPAINT_BOUNDS
-    for (Element* e: l->getElements()) {
+
+    // With a limited area, only the elements found by the spatial index of the layer are checked
+    std::vector<Element*> elementsInArea;
+    if (this->lX != -1) {
+        elementsInArea = l->getElementsInArea({this->lX, this->lY, this->width, this->height});
+    }
+    const std::vector<Element*>& elements = this->lX != -1 ? elementsInArea : l->getElements();
+    size_t elementsDrawn = 0;
+
+    for (Element* e: elements) {
 #ifdef DEBUG_SHOW_ELEMENT_BOUNDS
         cairo_set_source_rgb(cr, 0, 1, 0);
         cairo_set_line_width(cr, 1);
@@ -198,6 +230,7 @@ void DocumentView::drawLayer(cairo_t* cr, Layer* l) {
         if (this->lX != -1) {
             if (e->intersectsArea(this->lX, this->lY, this->width, this->height)) {
                 drawElement(cr, e);
+                elementsDrawn++;
 #ifdef DEBUG_SHOW_REPAINT_BOUNDS
                 drawn++;
 #endif  // DEBUG_SHOW_REPAINT_BOUNDS
@@ -213,9 +246,13 @@ void DocumentView::drawLayer(cairo_t* cr, Layer* l) {
             drawn++;
 #endif  // DEBUG_SHOW_REPAINT_BOUNDS
             drawElement(cr, e);
+            elementsDrawn++;
         }
     }
 
+    // Elements outside of the area are culled, most of them already by the spatial index
+    RenderStatistics::getInstance().countElements(elementsDrawn, l->getElements().size() - elementsDrawn);
+
 #ifdef DEBUG_SHOW_REPAINT_BOUNDS
     g_message("DBG:DocumentView: draw %i / not draw %i", drawn, notDrawn);
 #endif  // DEBUG_SHOW_REPAINT_BOUNDS
@@ -103,6 +103,12 @@ private:
 
     void drawElement(cairo_t* cr, Element* e) const;
 
+    /**
+     * @return The scale from page coordinates to device pixels of cr, if strokes should be drawn simplified
+     *         (small scale on a raster target, e.g. sidebar previews and zoomed out views), otherwise 1
+     */
+    static double levelOfDetailScale(cairo_t* cr);
+
     void paintBackgroundImage();
 
 private:
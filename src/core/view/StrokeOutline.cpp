@@ -0,0 +1,274 @@
+#include "StrokeOutline.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+constexpr double EPSILON = 1e-9;
+
+struct Vec {
+    double x;
+    double y;
+
+    Vec operator+(Vec o) const { return {x + o.x, y + o.y}; }
+    Vec operator-(Vec o) const { return {x - o.x, y - o.y}; }
+    Vec operator*(double f) const { return {x * f, y * f}; }
+
+    /**
+     * Rotated by 90 degrees, in the positive direction
+     */
+    Vec perp() const { return {-y, x}; }
+
+    double dot(Vec o) const { return x * o.x + y * o.y; }
+    double cross(Vec o) const { return x * o.y - y * o.x; }
+};
+
+/**
+ * Writes the subpaths. All of them are closed and have a positive orientation.
+ */
+class OutlineWriter {
+public:
+    explicit OutlineWriter(std::vector<cairo_path_data_t>& path): path(path) {}
+
+    /**
+     * The rectangle from s to e with the half width h, u is the unit direction from s to e
+     */
+    void rectangle(Vec s, Vec e, Vec u, double h) {
+        Vec n = u.perp() * h;
+        moveTo(s - n);
+        lineTo(e - n);
+        lineTo(e + n);
+        lineTo(s + n);
+        close();
+    }
+
+    void circle(Vec c, double r) {
+        if (r <= 0) {
+            return;
+        }
+        moveTo(c + Vec{r, 0});
+        arc(c, r, {1, 0}, M_PI * 2);
+        close();
+    }
+
+    /**
+     * The circular sector around c, starting in the direction a and turning by angle in the positive direction
+     */
+    void sector(Vec c, double r, Vec a, double angle) {
+        moveTo(c);
+        lineTo(c + a * r);
+        arc(c, r, a, angle);
+        close();
+    }
+
+private:
+    void arc(Vec c, double r, Vec from, double angle) {
+        // At most 90 degrees per bezier curve
+        int pieces = std::max(1, static_cast<int>(std::ceil(angle / (M_PI / 2) - EPSILON)));
+        double step = angle / pieces;
+        double k = 4.0 / 3.0 * std::tan(step / 4) * r;
+        double cosStep = std::cos(step);
+        double sinStep = std::sin(step);
+
+        Vec v0 = from;
+        for (int i = 0; i < pieces; i++) {
+            Vec v1{v0.x * cosStep - v0.y * sinStep, v0.x * sinStep + v0.y * cosStep};
+            Vec p0 = c + v0 * r;
+            Vec p3 = c + v1 * r;
+            curveTo(p0 + v0.perp() * k, p3 - v1.perp() * k, p3);
+            v0 = v1;
+        }
+    }
+
+    void moveTo(Vec p) { point(CAIRO_PATH_MOVE_TO, {p}); }
+    void lineTo(Vec p) { point(CAIRO_PATH_LINE_TO, {p}); }
+
+    void curveTo(Vec p1, Vec p2, Vec p3) {
+        cairo_path_data_t header;
+        header.header.type = CAIRO_PATH_CURVE_TO;
+        header.header.length = 4;
+        path.push_back(header);
+        for (Vec p: {p1, p2, p3}) { append(p); }
+    }
+
+    void close() {
+        cairo_path_data_t header;
+        header.header.type = CAIRO_PATH_CLOSE_PATH;
+        header.header.length = 1;
+        path.push_back(header);
+    }
+
+    void point(cairo_path_data_type_t type, Vec p) {
+        cairo_path_data_t header;
+        header.header.type = type;
+        header.header.length = 2;
+        path.push_back(header);
+        append(p);
+    }
+
+    void append(Vec p) {
+        cairo_path_data_t data;
+        data.point.x = p.x;
+        data.point.y = p.y;
+        path.push_back(data);
+    }
+
+    std::vector<cairo_path_data_t>& path;
+};
+
+class OutlineBuilder {
+public:
+    OutlineBuilder(StrokeCapStyle cap, std::vector<cairo_path_data_t>& path): cap(cap), out(path) {}
+
+    /**
+     * Adds the part of a segment from s to e, which is covered by one dash
+     *
+     * @param startsDash The piece starts a dash or the stroke, else it continues the last piece
+     * @param endsDash The dash ends at e
+     */
+    void piece(Vec s, Vec e, Vec u, double h, bool startsDash, bool endsDash) {
+        if (startsDash) {
+            capAt(s, u * -1.0, h);
+        } else {
+            join(s, this->lastU, this->lastH, u, h);
+        }
+
+        bool hasLength = (e - s).dot(u) > 0;
+        if (hasLength) {
+            out.rectangle(s, e, u, h);
+        }
+
+        // A dash of length 0 is a dot, which needs the round cap only once
+        if (endsDash && (hasLength || !startsDash || cap != StrokeCapStyle::ROUND)) {
+            capAt(e, u, h);
+        }
+
+        this->lastU = u;
+        this->lastH = h;
+    }
+
+    /**
+     * Ends the stroke at p, if the last dash is still open
+     */
+    void end(Vec p) { capAt(p, this->lastU, this->lastH); }
+
+    /**
+     * A stroke without any length, drawn like cairo draws a degenerated line
+     */
+    void dot(Vec p, double h) {
+        if (cap == StrokeCapStyle::ROUND) {
+            out.circle(p, h);
+        } else if (cap == StrokeCapStyle::SQUARE) {
+            out.rectangle(p - Vec{h, 0}, p + Vec{h, 0}, {1, 0}, h);
+        }
+    }
+
+private:
+    /**
+     * The cap of a stroke or dash end at p, u points away from the stroke
+     */
+    void capAt(Vec p, Vec u, double h) {
+        if (cap == StrokeCapStyle::ROUND) {
+            out.circle(p, h);
+        } else if (cap == StrokeCapStyle::SQUARE) {
+            out.rectangle(p, p + u * h, u, h);
+        }
+    }
+
+    /**
+     * The round join at p, between the pieces with the directions u1 and u2
+     */
+    void join(Vec p, Vec u1, double h1, Vec u2, double h2) {
+        double r = std::max(h1, h2);
+        double cosAngle = std::clamp(u1.dot(u2), -1.0, 1.0);
+
+        // The gap at the outer side of the turn
+        double gap = r * (1 - std::sqrt((1 + cosAngle) / 2));
+        if (gap < StrokeOutline::JOIN_TOLERANCE) {
+            return;
+        }
+        if (cosAngle < -0.99) {
+            // Turned back, the outer side is not defined
+            out.circle(p, r);
+            return;
+        }
+
+        // Fill the gap between the rectangles at the outer side, in the positive direction
+        Vec a = u1.cross(u2) > 0 ? u1.perp() * -1.0 : u2.perp();
+        out.sector(p, r, a, std::acos(cosAngle));
+    }
+
+    StrokeCapStyle cap;
+    OutlineWriter out;
+
+    Vec lastU{1, 0};
+    double lastH = 0;
+};
+
+}  // namespace
+
+void StrokeOutline::build(const double* xs, const double* ys, const double* widths, size_t count,
+                          StrokeCapStyle cap, const double* dashes, int dashCount,
+                          std::vector<cairo_path_data_t>& path) {
+    if (count == 0) {
+        return;
+    }
+
+    double dashLength = 0;
+    for (int i = 0; i < dashCount; i++) { dashLength += std::max(0.0, dashes[i]); }
+    const bool dashed = dashes != nullptr && dashCount > 0 && dashLength > 0;
+
+    OutlineBuilder builder(cap, path);
+
+    // The state of the dash pattern, a solid stroke is one endless dash
+    int dashIndex = 0;
+    double remaining = dashed ? std::max(0.0, dashes[0]) : std::numeric_limits<double>::infinity();
+    bool on = true;
+    bool inDash = false;
+    bool hasLength = false;
+    Vec last{xs[0], ys[0]};
+
+    for (size_t i = 0; i + 1 < count; i++) {
+        Vec a{xs[i], ys[i]};
+        Vec b{xs[i + 1], ys[i + 1]};
+        double len = std::hypot(b.x - a.x, b.y - a.y);
+        if (len <= EPSILON) {
+            continue;
+        }
+        hasLength = true;
+        Vec u = (b - a) * (1 / len);
+        double h = widths[i] / 2;
+
+        double pos = 0;
+        while (true) {
+            double step = std::min(remaining, len - pos);
+            bool dashEnds = dashed && remaining - step <= EPSILON;
+            if (on) {
+                builder.piece(a + u * pos, a + u * (pos + step), u, h, !inDash, dashEnds);
+                inDash = !dashEnds;
+                last = a + u * (pos + step);
+            }
+
+            pos += step;
+            if (dashed) {
+                remaining -= step;
+                if (remaining <= EPSILON) {
+                    dashIndex = (dashIndex + 1) % dashCount;
+                    remaining = std::max(0.0, dashes[dashIndex]);
+                    on = !on;
+                }
+            }
+            if (pos >= len - EPSILON && !(on && dashed && remaining <= EPSILON)) {
+                break;
+            }
+        }
+    }
+
+    if (inDash) {
+        builder.end(last);
+    } else if (!hasLength) {
+        builder.dot(last, widths[0] / 2);
+    }
+}
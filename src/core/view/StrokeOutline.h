@@ -0,0 +1,44 @@
+/*
+ * Xournal++
+ *
+ * Outline of a stroke with a width per segment
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <cairo.h>
+
+#include "model/Stroke.h"
+
+/**
+ * Builds the area covered by a stroke with pressure as one path, so it is filled with a single cairo_fill
+ * instead of stroking every segment with its own line width.
+ *
+ * The path is the union of one rectangle per segment, round joins and the caps of the stroke. All subpaths
+ * have the same orientation, filled with CAIRO_FILL_RULE_WINDING their union has no holes and no overlaps
+ * which are painted twice.
+ */
+class StrokeOutline {
+public:
+    /**
+     * Appends the outline to path
+     *
+     * @param widths The width of every segment, widths[i] is used from point i to point i + 1
+     * @param dashes The dash pattern like cairo_set_dash, nullptr for a solid stroke
+     */
+    static void build(const double* xs, const double* ys, const double* widths, size_t count, StrokeCapStyle cap,
+                      const double* dashes, int dashCount, std::vector<cairo_path_data_t>& path);
+
+    /**
+     * Joins with a gap below this size (in document coordinates) are not drawn
+     */
+    static constexpr double JOIN_TOLERANCE = 0.005;
+};
@@ -0,0 +1,114 @@
+#include "StrokeRenderCache.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "util/GeometryKernels.h"
+
+#include "StrokeOutline.h"
+
+namespace geometry = xoj::util::geometry;
+
+StrokeRenderCache::StrokeRenderCache(const Stroke& s): cap(s.getStrokeCapStyle()) {
+    const StrokePoints& points = s.getStrokePoints();
+    this->xs.assign(points.xData(), points.xData() + points.size());
+    this->ys.assign(points.yData(), points.yData() + points.size());
+
+    if (s.hasPressure()) {
+        this->widths.resize(points.size());
+        for (size_t i = 0; i < points.size(); i++) {
+            double pressure = points.pressure(i);
+            this->widths[i] = pressure != Point::NO_PRESSURE ? pressure : s.getWidth();
+        }
+    }
+
+    const double* dashes = nullptr;
+    int dashCount = 0;
+    if (s.getLineStyle().getDashes(dashes, dashCount)) {
+        this->dashes.assign(dashes, dashes + dashCount);
+    }
+
+    build(this->full, nullptr);
+}
+
+StrokeRenderCache::~StrokeRenderCache() = default;
+
+void StrokeRenderCache::build(Geometry& g, const std::vector<size_t>* indices) const {
+    size_t count = indices ? indices->size() : this->xs.size();
+    auto index = [indices](size_t k) { return indices ? (*indices)[k] : k; };
+
+    // Each element is a header followed by its point
+    g.pathData.resize(2 * count);
+    for (size_t k = 0; k < count; k++) {
+        cairo_path_data_t* data = &g.pathData[2 * k];
+        data[0].header.type = k == 0 ? CAIRO_PATH_MOVE_TO : CAIRO_PATH_LINE_TO;
+        data[0].header.length = 2;
+        data[1].point.x = this->xs[index(k)];
+        data[1].point.y = this->ys[index(k)];
+    }
+
+    g.path.status = CAIRO_STATUS_SUCCESS;
+    g.path.data = g.pathData.data();
+    g.path.num_data = static_cast<int>(g.pathData.size());
+
+    if (!this->widths.empty()) {
+        const double* dashes = this->dashes.empty() ? nullptr : this->dashes.data();
+        int dashCount = static_cast<int>(this->dashes.size());
+
+        if (indices) {
+            std::vector<double> xs(count);
+            std::vector<double> ys(count);
+            std::vector<double> widths(count);
+            for (size_t k = 0; k < count; k++) {
+                xs[k] = this->xs[index(k)];
+                ys[k] = this->ys[index(k)];
+                // A simplified segment is as wide as the widest segment it replaces
+                size_t end = k + 1 < count ? index(k + 1) : index(k) + 1;
+                widths[k] = *std::max_element(this->widths.begin() + index(k), this->widths.begin() + end);
+            }
+            StrokeOutline::build(xs.data(), ys.data(), widths.data(), count, this->cap, dashes, dashCount,
+                                 g.outlineData);
+        } else {
+            StrokeOutline::build(this->xs.data(), this->ys.data(), this->widths.data(), count, this->cap, dashes,
+                                 dashCount, g.outlineData);
+        }
+    }
+
+    g.outline.status = CAIRO_STATUS_SUCCESS;
+    g.outline.data = g.outlineData.data();
+    g.outline.num_data = static_cast<int>(g.outlineData.size());
+}
+
+auto StrokeRenderCache::forScale(double scale) const -> const Geometry& {
+    if (scale <= 0 || scale >= LOD_MAX_SCALE || this->xs.size() <= 2) {
+        return this->full;
+    }
+
+    // All scales within a power of two share the geometry, built for the largest scale of the bucket
+    int bucket = static_cast<int>(std::floor(std::log2(scale)));
+
+    std::lock_guard<std::mutex> lock(this->levelsOfDetailMutex);
+    std::unique_ptr<Geometry>& lod = this->levelsOfDetail[bucket];
+    if (!lod) {
+        double tolerance = LOD_TOLERANCE / std::exp2(bucket + 1);
+        std::vector<size_t> indices = geometry::simplify(this->xs.data(), this->ys.data(), this->xs.size(), tolerance);
+
+        lod = std::make_unique<Geometry>();
+        build(*lod, &indices);
+    }
+    return *lod;
+}
+
+auto StrokeRenderCache::get(const Stroke* s) -> std::shared_ptr<const StrokeRenderCache> {
+    std::shared_ptr<const StrokeRenderCache> cache = s->getRenderCache();
+    if (!cache) {
+        // Two threads drawing the same stroke may both build it, both results are equal
+        cache = std::make_shared<const StrokeRenderCache>(*s);
+        s->setRenderCache(cache);
+    }
+    return cache;
+}
+
+auto StrokeRenderCache::getPath(double scale) const -> const cairo_path_t* { return &forScale(scale).path; }
+
+auto StrokeRenderCache::getOutline(double scale) const -> const cairo_path_t* { return &forScale(scale).outline; }
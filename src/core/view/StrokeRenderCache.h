@@ -0,0 +1,108 @@
+/*
+ * Xournal++
+ *
+ * Geometry of a stroke, prepared for drawing
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <cairo.h>
+
+#include "model/Stroke.h"
+
+/**
+ * The cairo path of a stroke, built once and reused by every repaint until the stroke changes.
+ * Appending a prepared path is a lot faster than issuing cairo_move_to / cairo_line_to for every point.
+ *
+ * For small scales (thumbnails, zoomed out views) simplified versions of the path are built on demand, one per
+ * zoom bucket, which drop the points that are not visible at that scale.
+ *
+ * The cache is kept by the stroke, which drops it when its geometry changes, see Stroke::getRenderCache.
+ * It does not depend on the stroke after it was built.
+ */
+class StrokeRenderCache {
+public:
+    explicit StrokeRenderCache(const Stroke& s);
+    ~StrokeRenderCache();
+    StrokeRenderCache(const StrokeRenderCache&) = delete;
+    StrokeRenderCache& operator=(const StrokeRenderCache&) = delete;
+
+public:
+    /**
+     * @return The cache of s, which is created if the stroke has none yet. Thread safe.
+     */
+    static std::shared_ptr<const StrokeRenderCache> get(const Stroke* s);
+
+    /**
+     * The polyline through the points of the stroke, in page coordinates.
+     * Use cairo_append_path, the path must not be destroyed with cairo_path_destroy.
+     *
+     * @param scale The scale from page coordinates to device pixels. Below LOD_MAX_SCALE a simplified
+     *              polyline is returned. Thread safe.
+     */
+    const cairo_path_t* getPath(double scale = 1) const;
+
+    /**
+     * The area covered by a stroke with pressure, see StrokeOutline. Fill it with CAIRO_FILL_RULE_WINDING.
+     * Empty for strokes without pressure.
+     *
+     * @param scale See getPath
+     */
+    const cairo_path_t* getOutline(double scale = 1) const;
+
+    /**
+     * The simplified geometry is used below this scale
+     */
+    static constexpr double LOD_MAX_SCALE = 0.5;
+
+    /**
+     * The maximum error of the simplified geometry, in device pixels
+     */
+    static constexpr double LOD_TOLERANCE = 0.5;
+
+private:
+    struct Geometry {
+        std::vector<cairo_path_data_t> pathData;
+        cairo_path_t path{};
+
+        std::vector<cairo_path_data_t> outlineData;
+        cairo_path_t outline{};
+    };
+
+    /**
+     * Builds the geometry through the given points, all of them if indices is nullptr
+     */
+    void build(Geometry& g, const std::vector<size_t>* indices) const;
+
+    const Geometry& forScale(double scale) const;
+
+private:
+    std::vector<double> xs;
+    std::vector<double> ys;
+
+    /**
+     * The width of every segment, empty without pressure
+     */
+    std::vector<double> widths;
+
+    StrokeCapStyle cap;
+    std::vector<double> dashes;
+
+    Geometry full;
+
+    /**
+     * The simplified geometry by zoom bucket (the binary logarithm of the scale)
+     */
+    mutable std::map<int, std::unique_ptr<Geometry>> levelsOfDetail;
+    mutable std::mutex levelsOfDetailMutex;
+};
@@ -1,21 +1,25 @@
 #include "StrokeView.h"
 
 #include <cmath>
+#include <memory>
 
 #include "model/Stroke.h"
 #include "model/eraser/ErasableStroke.h"
-#include "util/LoopUtil.h"
 
 #include "DocumentView.h"
+#include "StrokeRenderCache.h"
 
 using xoj::util::Rectangle;
 
-StrokeView::StrokeView(cairo_t* cr, Stroke* s): cr(cr), crEffective(cr), s(s) {}
+StrokeView::StrokeView(cairo_t* cr, Stroke* s, double scale): cr(cr), crEffective(cr), s(s), scale(scale) {}
 
 void StrokeView::pathToCairo() const {
-    for_first_then_each(
-            s->getPointVector(), [this](auto const& first) { cairo_move_to(this->crEffective, first.x, first.y); },
-            [this](auto const& other) { cairo_line_to(this->crEffective, other.x, other.y); });
+    if (s->getStrokePoints().empty()) {
+        return;
+    }
+
+    std::shared_ptr<const StrokeRenderCache> cache = StrokeRenderCache::get(s);
+    cairo_append_path(this->crEffective, cache->getPath(this->scale));
 }
 
 void StrokeView::drawErasableStroke(cairo_t* cr, Stroke* s) {
@@ -40,27 +44,18 @@ void StrokeView::drawNoPressure() const {
 }
 
 /**
- * Draw a stroke with pressure, for this multiple lines with different widths needs to be drawn
+ * Draw a stroke with pressure: the outline of the whole stroke, with the width of every segment, is filled at once
  */
 void StrokeView::drawWithPressure() const {
-    double dashOffset = 0;
-    const double* dashes = nullptr;
-    int dashCount = 0;
-    s->getLineStyle().getDashes(dashes, dashCount);
-    assert((dashCount == 0 && dashes == nullptr) || (dashCount != 0 && dashes != nullptr));
-
-    for (auto p1i = begin(s->getPointVector()), p2i = std::next(p1i), endi = end(s->getPointVector());
-         p1i != endi && p2i != endi; ++p1i, ++p2i) {
-        auto width = p1i->z != Point::NO_PRESSURE ? p1i->z : s->getWidth();
-        cairo_set_line_width(crEffective, width);
-        if (dashes) {
-            cairo_set_dash(crEffective, dashes, dashCount, dashOffset);
-            dashOffset += p1i->lineLengthTo(*p2i);
-        }
-        cairo_move_to(crEffective, p1i->x, p1i->y);
-        cairo_line_to(crEffective, p2i->x, p2i->y);
-        cairo_stroke(crEffective);
+    if (s->getStrokePoints().empty()) {
+        return;
     }
+
+    std::shared_ptr<const StrokeRenderCache> cache = StrokeRenderCache::get(s);
+    cairo_set_fill_rule(crEffective, CAIRO_FILL_RULE_WINDING);
+    cairo_new_path(crEffective);
+    cairo_append_path(crEffective, cache->getOutline(this->scale));
+    cairo_fill(crEffective);
 }
 
 void StrokeView::paint(bool dontRenderEditingStroke, bool markAudioStroke, bool noColor) const {
@@ -19,7 +19,11 @@ class Stroke;
 
 class StrokeView {
 public:
-    StrokeView(cairo_t* cr, Stroke* s);
+    /**
+     * @param scale The scale from page coordinates to device pixels, used to draw a simplified stroke
+     *              at small scales (see StrokeRenderCache). 1 to always draw every point.
+     */
+    StrokeView(cairo_t* cr, Stroke* s, double scale = 1);
     ~StrokeView() = default;
 
 public:
@@ -42,8 +46,8 @@ private:
     void drawNoPressure() const;
 
     /**
-     * Draw a stroke with pressure, for this multiple
-     * lines with different widths needs to be drawn
+     * Draw a stroke with pressure, by filling its outline
+     * with the width of every segment
      */
     void drawWithPressure() const;
 
@@ -52,6 +56,7 @@ private:
     cairo_t* cr;
     mutable cairo_t* crEffective;
     Stroke* s;
+    double scale;
 
 public:
     static constexpr uint8_t HIGHLIGHTER_ALPHA = 120;
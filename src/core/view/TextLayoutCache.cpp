@@ -0,0 +1,42 @@
+#include "TextLayoutCache.h"
+
+#include "model/Text.h"
+
+#include "TextView.h"
+
+TextLayoutCache::TextLayoutCache(const Text& t, int dpi):
+        text(t.getText()), fontName(t.getFontName()), fontSize(t.getFontSize()), dpi(dpi) {
+    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 1, 1);
+    cairo_t* cr = cairo_create(surface);
+
+    // The layout is only used on this thread
+    PangoLayout* layout = TextView::initPango(cr, &t);
+    pango_layout_set_text(layout, this->text.c_str(), static_cast<int>(this->text.length()));
+    pango_layout_get_size(layout, &this->width, &this->height);
+    g_object_unref(layout);
+
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface);
+}
+
+auto TextLayoutCache::get(const Text* t) -> std::shared_ptr<const TextLayoutCache> {
+    int dpi = TextView::getDpi();
+    std::shared_ptr<const TextLayoutCache> cache = t->getLayoutCache();
+
+    // The font of a text can be changed in place (Text::getFont), the cache is checked against it
+    if (!cache || !cache->isValidFor(*t, dpi)) {
+        cache = std::make_shared<const TextLayoutCache>(*t, dpi);
+        t->setLayoutCache(cache);
+    }
+    return cache;
+}
+
+auto TextLayoutCache::isValidFor(const Text& t, int dpi) const -> bool {
+    return this->dpi == dpi && this->fontSize == t.getFontSize() && this->fontName == t.getFontName() &&
+           this->text == t.getText();
+}
+
+void TextLayoutCache::getSize(double& width, double& height) const {
+    width = static_cast<double>(this->width) / PANGO_SCALE;
+    height = static_cast<double>(this->height) / PANGO_SCALE;
+}
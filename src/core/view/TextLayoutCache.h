@@ -0,0 +1,56 @@
+/*
+ * Xournal++
+ *
+ * Measured layout of a text
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+class Text;
+
+/**
+ * The size of a text element, measured once and reused until the text, its font or the text resolution
+ * changes.
+ *
+ * No PangoLayout is kept: a layout belongs to the font map of the thread which created it, and font maps
+ * are not thread safe. Texts are drawn with a layout of the drawing thread, see TextView::drawText.
+ *
+ * The cache is kept by the text, which drops it when its text or font changes, see Text::getLayoutCache.
+ */
+class TextLayoutCache {
+public:
+    TextLayoutCache(const Text& t, int dpi);
+    TextLayoutCache(const TextLayoutCache&) = delete;
+    TextLayoutCache& operator=(const TextLayoutCache&) = delete;
+
+public:
+    /**
+     * @return The cache of t, which is created if the text has none yet or if it is outdated. Thread safe.
+     */
+    static std::shared_ptr<const TextLayoutCache> get(const Text* t);
+
+    /**
+     * The size of the text, in page coordinates
+     */
+    void getSize(double& width, double& height) const;
+
+private:
+    bool isValidFor(const Text& t, int dpi) const;
+
+private:
+    std::string text;
+    std::string fontName;
+    double fontSize = 0;
+    int dpi = 0;
+
+    int width = 0;
+    int height = 0;
+};
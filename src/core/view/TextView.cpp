@@ -1,11 +1,17 @@
 #include "TextView.h"
 
+#include <map>
+#include <memory>
+#include <mutex>
+
 #include "control/settings/Settings.h"
 #include "model/Text.h"
 #include "pdf/base/XojPdfPage.h"
 #include "util/StringUtils.h"
 #include "util/Util.h"
 
+#include "TextLayoutCache.h"
+
 using std::string;
 
 TextView::TextView() = default;
@@ -16,6 +22,30 @@ static int textDpi = 72;
 
 void TextView::setDpi(int dpi) { textDpi = dpi; }
 
+auto TextView::getDpi() -> int { return textDpi; }
+
+namespace {
+/**
+ * Parsed font descriptions by font name, shared by all texts. A document only uses a few fonts.
+ */
+std::mutex fontDescriptionMutex;
+std::map<std::string, std::unique_ptr<PangoFontDescription, decltype(&pango_font_description_free)>>
+        fontDescriptions;
+
+auto copyFontDescription(const string& name) -> PangoFontDescription* {
+    std::lock_guard lock{fontDescriptionMutex};
+    auto it = fontDescriptions.find(name);
+    if (it == fontDescriptions.end()) {
+        it = fontDescriptions
+                     .emplace(name, std::unique_ptr<PangoFontDescription, decltype(&pango_font_description_free)>(
+                                            pango_font_description_from_string(name.c_str()),
+                                            &pango_font_description_free))
+                     .first;
+    }
+    return pango_font_description_copy(it->second.get());
+}
+}  // namespace
+
 auto TextView::initPango(cairo_t* cr, const Text* t) -> PangoLayout* {
     PangoLayout* layout = pango_cairo_create_layout(cr);
 
@@ -32,7 +62,7 @@ auto TextView::initPango(cairo_t* cr, const Text* t) -> PangoLayout* {
 }
 
 void TextView::updatePangoFont(PangoLayout* layout, const Text* t) {
-    PangoFontDescription* desc = pango_font_description_from_string(t->getFontName().c_str());
+    PangoFontDescription* desc = copyFontDescription(t->getFontName());
     pango_font_description_set_absolute_size(desc, t->getFontSize() * PANGO_SCALE);
 
 #if PANGO_VERSION_CHECK(1, 48, 5)  // see https://gitlab.gnome.org/GNOME/pango/-/issues/499
@@ -100,19 +130,5 @@ auto TextView::findText(const Text* t, string& search) -> std::vector<XojPdfRect
 }
 
 void TextView::calcSize(const Text* t, double& width, double& height) {
-    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 1, 1);
-    cairo_t* cr = cairo_create(surface);
-
-    PangoLayout* layout = initPango(cr, t);
-    string str = t->getText();
-    pango_layout_set_text(layout, str.c_str(), str.length());
-    int w = 0;
-    int h = 0;
-    pango_layout_get_size(layout, &w, &h);
-    width = (static_cast<double>(w)) / PANGO_SCALE;
-    height = (static_cast<double>(h)) / PANGO_SCALE;
-    g_object_unref(layout);
-
-    cairo_surface_destroy(surface);
-    cairo_destroy(cr);
+    TextLayoutCache::get(t)->getSize(width, height);
 }
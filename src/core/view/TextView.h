@@ -24,6 +24,7 @@ private:
 
 public:
     static void setDpi(int dpi);
+    static int getDpi();
 
     /**
      * Calculates the size of a Text model
@@ -0,0 +1,113 @@
+#include "BackgroundTileCache.h"
+
+#include <algorithm>
+#include <cmath>
+
+auto BackgroundTileCache::Key::operator==(const Key& other) const -> bool {
+    return name == other.name && periodX == other.periodX && periodY == other.periodY &&
+           lineWidth == other.lineWidth && color1 == other.color1 && color2 == other.color2 && scale == other.scale;
+}
+
+BackgroundTileCache::~BackgroundTileCache() {
+    for (Tile& tile: this->tiles) { cairo_surface_destroy(tile.surface); }
+}
+
+auto BackgroundTileCache::getInstance() -> BackgroundTileCache& {
+    static BackgroundTileCache instance;
+    return instance;
+}
+
+auto BackgroundTileCache::tileScale(cairo_t* cr) -> double {
+    cairo_surface_t* target = cairo_get_target(cr);
+    if (cairo_surface_get_type(target) != CAIRO_SURFACE_TYPE_IMAGE) {
+        // Vector output (PDF export, printing) keeps the lines
+        return 0;
+    }
+
+    cairo_matrix_t matrix;
+    cairo_get_matrix(cr, &matrix);
+    double deviceScaleX = 1;
+    double deviceScaleY = 1;
+    cairo_surface_get_device_scale(target, &deviceScaleX, &deviceScaleY);
+
+    double scaleX = matrix.xx * deviceScaleX;
+    double scaleY = matrix.yy * deviceScaleY;
+    if (matrix.xy != 0 || matrix.yx != 0 || scaleX <= 0 || scaleX != scaleY) {
+        return 0;
+    }
+    return scaleX;
+}
+
+auto BackgroundTileCache::createTile(const Key& key, const DrawFunction& draw) -> Tile {
+    auto periods = [&key](double period) {
+        return std::max(1, static_cast<int>(std::ceil(MIN_TILE_PIXELS / (period * key.scale))));
+    };
+    const int periodsX = periods(key.periodX);
+    const int periodsY = periods(key.periodY);
+
+    Tile tile;
+    tile.key = key;
+    tile.width = periodsX * key.periodX;
+    tile.height = periodsY * key.periodY;
+
+    const int pixelsX = std::max(1, static_cast<int>(std::lround(tile.width * key.scale)));
+    const int pixelsY = std::max(1, static_cast<int>(std::lround(tile.height * key.scale)));
+    tile.surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, pixelsX, pixelsY);
+
+    cairo_t* cr = cairo_create(tile.surface);
+    cairo_scale(cr, pixelsX / tile.width, pixelsY / tile.height);
+    for (int i = 0; i < periodsX; i++) {
+        for (int j = 0; j < periodsY; j++) {
+            cairo_save(cr);
+            cairo_translate(cr, i * key.periodX, j * key.periodY);
+            draw(cr);
+            cairo_restore(cr);
+        }
+    }
+    cairo_destroy(cr);
+
+    return tile;
+}
+
+void BackgroundTileCache::paint(cairo_t* cr, const Key& key, double x, double y, double width, double height,
+                                const DrawFunction& draw) {
+    cairo_surface_t* surface = nullptr;
+    double tileWidth = 0;
+    double tileHeight = 0;
+    {
+        std::lock_guard lock{this->mutex};
+        auto it = std::find_if(this->tiles.begin(), this->tiles.end(), [&key](const Tile& t) { return t.key == key; });
+        if (it != this->tiles.end()) {
+            this->tiles.splice(this->tiles.begin(), this->tiles, it);
+        } else {
+            this->tiles.push_front(createTile(key, draw));
+            if (this->tiles.size() > MAX_TILES) {
+                cairo_surface_destroy(this->tiles.back().surface);
+                this->tiles.pop_back();
+            }
+        }
+
+        const Tile& tile = this->tiles.front();
+        surface = cairo_surface_reference(tile.surface);
+        tileWidth = tile.width;
+        tileHeight = tile.height;
+    }
+
+    cairo_pattern_t* pattern = cairo_pattern_create_for_surface(surface);
+    cairo_pattern_set_extend(pattern, CAIRO_EXTEND_REPEAT);
+
+    cairo_matrix_t matrix;
+    cairo_matrix_init_scale(&matrix, cairo_image_surface_get_width(surface) / tileWidth,
+                            cairo_image_surface_get_height(surface) / tileHeight);
+    cairo_matrix_translate(&matrix, -x, -y);
+    cairo_pattern_set_matrix(pattern, &matrix);
+
+    cairo_save(cr);
+    cairo_set_source(cr, pattern);
+    cairo_rectangle(cr, x, y, width, height);
+    cairo_fill(cr);
+    cairo_restore(cr);
+
+    cairo_pattern_destroy(pattern);
+    cairo_surface_destroy(surface);
+}
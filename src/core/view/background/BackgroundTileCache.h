@@ -0,0 +1,107 @@
+/*
+ * Xournal++
+ *
+ * Rasterized tiles of the background patterns
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+
+#include <cairo.h>
+
+#include "util/Color.h"
+
+/**
+ * Keeps the periodic part of the ruled, graph, dotted and staves backgrounds rasterized, so a page background
+ * is painted with one repeating pattern instead of drawing every line or dot.
+ *
+ * A tile contains one or more periods of a pattern, enough to be at least MIN_TILE_PIXELS large. Its pixel size
+ * is rounded, the pattern matrix maps it back to the exact period, so the repetitions do not drift.
+ *
+ * The tiles are shared by all pages and render jobs, the least recently used ones are dropped.
+ */
+class BackgroundTileCache {
+public:
+    struct Key {
+        /**
+         * The pattern. Together with the other values it has to determine the drawing.
+         */
+        std::string name;
+
+        double periodX = 0;
+        double periodY = 0;
+        double lineWidth = 0;
+        Color color1{0U};
+        Color color2{0U};
+
+        /**
+         * Device pixel per page unit
+         */
+        double scale = 0;
+
+        bool operator==(const Key& other) const;
+    };
+
+    /**
+     * Draws one period of the pattern into the cell from (0, 0) to (periodX, periodY)
+     */
+    using DrawFunction = std::function<void(cairo_t* cr)>;
+
+private:
+    BackgroundTileCache() = default;
+    ~BackgroundTileCache();
+
+public:
+    BackgroundTileCache(const BackgroundTileCache&) = delete;
+    BackgroundTileCache& operator=(const BackgroundTileCache&) = delete;
+
+    static BackgroundTileCache& getInstance();
+
+    /**
+     * Fills the area with the pattern, repeated from the origin of the area
+     *
+     * @param draw Called to rasterize the tile, if it is not cached
+     */
+    void paint(cairo_t* cr, const Key& key, double x, double y, double width, double height, const DrawFunction& draw);
+
+    /**
+     * @return The scale of cr in device pixel per page unit, if it can be painted with rasterized tiles,
+     *         else 0 (vector output, rotations)
+     */
+    static double tileScale(cairo_t* cr);
+
+    static constexpr int MIN_TILE_PIXELS = 32;
+    static constexpr size_t MAX_TILES = 32;
+
+private:
+    struct Tile {
+        Key key;
+        cairo_surface_t* surface = nullptr;
+
+        /**
+         * The size in page units, a whole number of periods
+         */
+        double width = 0;
+        double height = 0;
+    };
+
+    Tile createTile(const Key& key, const DrawFunction& draw);
+
+private:
+    std::mutex mutex;
+
+    /**
+     * Most recently used first
+     */
+    std::list<Tile> tiles;
+};
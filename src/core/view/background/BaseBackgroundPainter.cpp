@@ -1,5 +1,7 @@
 #include "BaseBackgroundPainter.h"
 
+#include <algorithm>
+
 #include "util/Util.h"
 
 BaseBackgroundPainter::BaseBackgroundPainter() { resetConfig(); }
@@ -71,6 +73,31 @@ void BaseBackgroundPainter::paint(cairo_t* cr, PageRef page, BackgroundConfig* c
     this->config = nullptr;
 }
 
+auto BaseBackgroundPainter::paintRepeated(const std::string& name, double x, double y, double width, double height,
+                                          double periodX, double periodY,
+                                          const BackgroundTileCache::DrawFunction& draw) -> bool {
+    BackgroundTileCache::Key key;
+    key.scale = BackgroundTileCache::tileScale(cr);
+    key.lineWidth = lineWidth * lineWidthFactor;
+
+    // The antialiasing of a line may not reach into the next period
+    if (key.scale <= 0 || key.lineWidth + 2 / key.scale >= std::min(periodX, periodY)) {
+        return false;
+    }
+    if (width <= 0 || height <= 0) {
+        return true;
+    }
+
+    key.name = name;
+    key.periodX = periodX;
+    key.periodY = periodY;
+    key.color1 = this->foregroundColor1;
+    key.color2 = this->foregroundColor2;
+
+    BackgroundTileCache::getInstance().paint(cr, key, x, y, width, height, draw);
+    return true;
+}
+
 void BaseBackgroundPainter::paint() { paintBackgroundColor(); }
 
 void BaseBackgroundPainter::paintBackgroundColor() {
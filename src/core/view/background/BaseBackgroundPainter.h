@@ -11,12 +11,15 @@
 
 #pragma once
 
+#include <string>
+
 #include <gtk/gtk.h>
 
 #include "model/PageRef.h"
 #include "util/Color.h"
 
 #include "BackgroundConfig.h"
+#include "BackgroundTileCache.h"
 
 class BaseBackgroundPainter {
 public:
@@ -64,6 +67,19 @@ protected:
      */
     Color getForegroundColor2() const;
 
+    /**
+     * Fills the area with a pattern which repeats from its origin, using a cached tile (see BackgroundTileCache).
+     * The tile is shared by all pages with the same pattern, periods, line width, colors and zoom.
+     *
+     * @param name Identifies the pattern of the painter
+     * @param draw Draws one period into the cell from (0, 0) to (periodX, periodY). The lines must keep a
+     *             distance of half the line width to the border of the cell, unless they run across it.
+     * @return false if the pattern has to be drawn directly: vector output, or periods which are too small
+     *         for the line width
+     */
+    bool paintRepeated(const std::string& name, double x, double y, double width, double height, double periodX,
+                       double periodY, const BackgroundTileCache::DrawFunction& draw);
+
 private:
 protected:
     BackgroundConfig* config = nullptr;
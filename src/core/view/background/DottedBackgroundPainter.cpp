@@ -25,6 +25,26 @@ void DottedBackgroundPainter::paintBackgroundDotted() {
     cairo_set_line_cap(cr, CAIRO_LINE_CAP_ROUND);
 
     auto pos = [dr1 = drawRaster1](int i) { return dr1 + i * dr1; };
+
+    int columns = 0;
+    while (pos(columns) < width) { columns++; }
+    int rows = 0;
+    while (pos(rows) < height) { rows++; }
+
+    // One dot in the middle of each period
+    const double r = drawRaster1;
+    bool repeated = paintRepeated("dotted", r / 2, r / 2, columns * r, rows * r, r, r, [this, r](cairo_t* tile) {
+        Util::cairo_set_source_rgbi(tile, this->foregroundColor1);
+        cairo_set_line_width(tile, lineWidth * lineWidthFactor);
+        cairo_set_line_cap(tile, CAIRO_LINE_CAP_ROUND);
+        cairo_move_to(tile, r / 2, r / 2);
+        cairo_line_to(tile, r / 2, r / 2);
+        cairo_stroke(tile);
+    });
+    if (repeated) {
+        return;
+    }
+
     for (int x = 0; pos(x) < width; ++x) {
         for (int y = 0; pos(y) < height; ++y) {
             cairo_move_to(cr, pos(x), pos(y));
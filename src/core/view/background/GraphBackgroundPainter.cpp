@@ -44,6 +44,10 @@ void GraphBackgroundPainter::paintBackgroundGraph() {
 
     auto pos = [dr1 = drawRaster1](int i) { return dr1 + i * dr1; };
 
+    if (paintGraphRepeated(marginLeftRight, marginTopBottom, snappingOffset)) {
+        return;
+    }
+
     for (int x = 0; pos(x) < width; ++x) {
         if (pos(x) < margin1 || pos(x) > (width - margin1)) {
             continue;
@@ -63,3 +67,40 @@ void GraphBackgroundPainter::paintBackgroundGraph() {
 
     cairo_stroke(cr);
 }
+
+auto GraphBackgroundPainter::paintGraphRepeated(double marginLeftRight, double marginTopBottom, double snappingOffset)
+        -> bool {
+    auto pos = [dr1 = drawRaster1](int i) { return dr1 + i * dr1; };
+
+    // The lines which are drawn are consecutive, between the margins
+    int firstX = 0;
+    while (pos(firstX) < width && pos(firstX) < margin1) { firstX++; }
+    int endX = firstX;
+    while (pos(endX) < width && pos(endX) <= width - margin1) { endX++; }
+
+    int firstY = 0;
+    while (pos(firstY) < height && pos(firstY) < margin1) { firstY++; }
+    int endY = firstY;
+    while (pos(endY) < height && pos(endY) <= height - marginTopBottom) { endY++; }
+
+    // One line in the middle of each period, which runs across the cell so the repetitions have no seams
+    const double r = drawRaster1;
+    auto tileLine = [this, r](double x1, double y1, double x2, double y2) {
+        return [=](cairo_t* tile) {
+            Util::cairo_set_source_rgbi(tile, this->foregroundColor1);
+            cairo_set_line_width(tile, lineWidth * lineWidthFactor);
+            cairo_move_to(tile, x1, y1);
+            cairo_line_to(tile, x2, y2);
+            cairo_stroke(tile);
+        };
+    };
+
+    if (!paintRepeated("graph-vertical", pos(firstX) - r / 2, marginTopBottom - snappingOffset, (endX - firstX) * r,
+                       height - 2 * marginTopBottom, r, r, tileLine(r / 2, -r, r / 2, 2 * r))) {
+        return false;
+    }
+    // Same periods and line width, this can not fail anymore
+    paintRepeated("graph-horizontal", marginLeftRight, pos(firstY) - r / 2, width - 2 * marginLeftRight,
+                  (endY - firstY) * r, r, r, tileLine(-r, r / 2, 2 * r, r / 2));
+    return true;
+}
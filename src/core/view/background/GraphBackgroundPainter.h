@@ -30,4 +30,12 @@ public:
      * Reset all used configuration values
      */
     void resetConfig() override;
+
+private:
+    /**
+     * Paints the lines with cached tiles
+     *
+     * @return false if they have to be drawn directly
+     */
+    bool paintGraphRepeated(double marginLeftRight, double marginTopBottom, double snappingOffset);
 };
@@ -35,6 +35,19 @@ void LineBackgroundPainter::paintBackgroundRuled() {
 
     int numLines = static_cast<int>((height - headerSize - footerSize) / (rulingSize + lineWidth * lineWidthFactor));
 
+    // One line in the middle of each period, it runs across the cell so the repetitions have no seams
+    bool repeated = paintRepeated("ruled", 0, headerSize - rulingSize / 2, width, numLines * rulingSize, rulingSize,
+                                  rulingSize, [this](cairo_t* tile) {
+                                      Util::cairo_set_source_rgbi(tile, this->foregroundColor1);
+                                      cairo_set_line_width(tile, lineWidth * lineWidthFactor);
+                                      cairo_move_to(tile, -rulingSize, rulingSize / 2);
+                                      cairo_line_to(tile, 2 * rulingSize, rulingSize / 2);
+                                      cairo_stroke(tile);
+                                  });
+    if (repeated) {
+        return;
+    }
+
     double offset = headerSize;
 
     for (int i = 0; i < numLines; i++) {
@@ -22,29 +22,40 @@ void StavesBackgroundPainter::paint() {
 
     int numStaves = static_cast<int>((height - headerSize - footerSize + lineDistance) / (lineSize));
 
+    // One stave per period, with some space around it
+    const double padding = staveDistance;
+    const double cellWidth = this->width - 2 * this->borderSize + 2 * padding;
+    bool repeated = paintRepeated("staves", this->borderSize - padding, offset - lineDistance / 2, cellWidth,
+                                  numStaves * lineSize, cellWidth, lineSize, [&](cairo_t* tile) {
+                                      paintBackgroundStaves(tile, padding, cellWidth - padding, lineDistance / 2);
+                                  });
+    if (repeated) {
+        return;
+    }
+
     for (int line = 0; line < numStaves; line++) {
-        paintBackgroundStaves(offset);
+        paintBackgroundStaves(this->cr, this->borderSize, this->width - this->borderSize, offset);
         offset += lineSize;
     }
 }
 
 
-void StavesBackgroundPainter::paintBackgroundStaves(double offset) {
+void StavesBackgroundPainter::paintBackgroundStaves(cairo_t* cr, double left, double right, double offset) {
     Util::cairo_set_source_rgbi(cr, this->foregroundColor1);
     cairo_set_line_width(cr, lineWidth * lineWidthFactor);
 
     double staveOffset = offset;
     for (int j = 0; j < 5; j++) {
-        cairo_move_to(cr, this->borderSize, staveOffset);
-        cairo_line_to(cr, this->width - this->borderSize, staveOffset);
+        cairo_move_to(cr, left, staveOffset);
+        cairo_line_to(cr, right, staveOffset);
         staveOffset += this->staveDistance;
     }
 
-    cairo_move_to(cr, this->borderSize, offset - (lineWidth * lineWidthFactor) / 2);
-    cairo_line_to(cr, this->borderSize, offset + 4 * staveDistance + (lineWidth * lineWidthFactor) / 2);
+    cairo_move_to(cr, left, offset - (lineWidth * lineWidthFactor) / 2);
+    cairo_line_to(cr, left, offset + 4 * staveDistance + (lineWidth * lineWidthFactor) / 2);
 
-    cairo_move_to(cr, this->width - this->borderSize, offset - (lineWidth * lineWidthFactor) / 2);
-    cairo_line_to(cr, this->width - this->borderSize, offset + 4 * staveDistance + (lineWidth * lineWidthFactor) / 2);
+    cairo_move_to(cr, right, offset - (lineWidth * lineWidthFactor) / 2);
+    cairo_line_to(cr, right, offset + 4 * staveDistance + (lineWidth * lineWidthFactor) / 2);
 
     cairo_stroke(cr);
 }
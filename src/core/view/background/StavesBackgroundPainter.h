@@ -31,7 +31,10 @@ public:
     void resetConfig() override;
 
 
-    void paintBackgroundStaves(double offset);
+    /**
+     * Draws one stave, from left to right with its top line at offset
+     */
+    void paintBackgroundStaves(cairo_t* cr, double left, double right, double offset);
 
 private:
     const double headerSize = 80;
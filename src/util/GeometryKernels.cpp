@@ -0,0 +1,557 @@
+#include "util/GeometryKernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define XOJ_GEOMETRY_X86
+#include <immintrin.h>
+#endif
+
+namespace xoj::util::geometry {
+
+constexpr double SQRT2 = 1.41421356237309504880;
+
+/**
+ * Tolerance added to the allowed distance of the eraser from a segment
+ */
+constexpr double PADDING = 0.1;
+
+////////////////////////////////////////////////////////////////////////////////
+// Scalar implementation, also used for the remainders of the vectorized loops
+////////////////////////////////////////////////////////////////////////////////
+
+static inline bool inRect(double px, double py, double x1, double y1, double x2, double y2) {
+    return px >= x1 && py >= y1 && px <= x2 && py <= y2;
+}
+
+bool segmentHit(double ax, double ay, double bx, double by, double x, double y, double halfSize, double* distance) {
+    double dx = bx - ax;
+    double dy = by - ay;
+    double len = std::sqrt(dx * dx + dy * dy);
+    if (!(len >= halfSize && len > 0)) {
+        return false;
+    }
+
+    // The distance of the center of the square to the line through a and b is |cross| / len
+    double cross = std::abs((x - ax) * (ay - by) + (y - ay) * (bx - ax));
+    if (cross > halfSize * len) {
+        return false;
+    }
+
+    // The center of the square has to lie in a circle around the middle of the segment, whose radius is half
+    // the length of the segment plus half the diagonal of the square
+    double cx = x - (ax + bx) / 2;
+    double cy = y - (ay + by) / 2;
+    double dist = std::sqrt(cx * cx + cy * cy) - halfSize * SQRT2;
+    if (dist > len / 2 + PADDING) {
+        return false;
+    }
+
+    if (distance) {
+        *distance = dist;
+    }
+    return true;
+}
+
+static Bounds boundsScalar(const double* xs, const double* ys, size_t begin, size_t count, Bounds b) {
+    for (size_t i = begin; i < count; i++) {
+        b.minX = std::min(b.minX, xs[i]);
+        b.maxX = std::max(b.maxX, xs[i]);
+        b.minY = std::min(b.minY, ys[i]);
+        b.maxY = std::max(b.maxY, ys[i]);
+    }
+    return b;
+}
+
+static double maxScalar(const double* values, size_t begin, size_t count, double max) {
+    for (size_t i = begin; i < count; i++) { max = std::max(max, values[i]); }
+    return max;
+}
+
+static size_t findPointInRectScalar(const double* xs, const double* ys, size_t begin, size_t count, double x1,
+                                    double y1, double x2, double y2) {
+    for (size_t i = begin; i < count; i++) {
+        if (inRect(xs[i], ys[i], x1, y1, x2, y2)) {
+            return i;
+        }
+    }
+    return count;
+}
+
+/**
+ * @param begin The first point to check, has to be > 0
+ */
+static size_t findHitScalar(const double* xs, const double* ys, size_t begin, size_t count, double x, double y,
+                            double halfSize) {
+    for (size_t i = begin; i < count; i++) {
+        if (inRect(xs[i], ys[i], x - halfSize, y - halfSize, x + halfSize, y + halfSize) ||
+            segmentHit(xs[i - 1], ys[i - 1], xs[i], ys[i], x, y, halfSize, nullptr)) {
+            return i;
+        }
+    }
+    return count;
+}
+
+static void transformScalar(double* xs, double* ys, size_t begin, size_t count, double xx, double yx, double xy,
+                            double yy, double x0, double y0) {
+    for (size_t i = begin; i < count; i++) {
+        double px = xs[i];
+        double py = ys[i];
+        xs[i] = xx * px + xy * py + x0;
+        ys[i] = yx * px + yy * py + y0;
+    }
+}
+
+#ifdef XOJ_GEOMETRY_X86
+
+////////////////////////////////////////////////////////////////////////////////
+// AVX2, 4 points per iteration
+////////////////////////////////////////////////////////////////////////////////
+
+static bool hasAvx2() {
+    static const bool avx2 = [] {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+    }();
+    return avx2;
+}
+
+__attribute__((target("avx2"))) static Bounds boundsAvx2(const double* xs, const double* ys, size_t count) {
+    __m256d minX = _mm256_set1_pd(xs[0]);
+    __m256d maxX = minX;
+    __m256d minY = _mm256_set1_pd(ys[0]);
+    __m256d maxY = minY;
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256d px = _mm256_loadu_pd(xs + i);
+        __m256d py = _mm256_loadu_pd(ys + i);
+        minX = _mm256_min_pd(minX, px);
+        maxX = _mm256_max_pd(maxX, px);
+        minY = _mm256_min_pd(minY, py);
+        maxY = _mm256_max_pd(maxY, py);
+    }
+
+    alignas(32) double lanes[4][4];
+    _mm256_store_pd(lanes[0], minX);
+    _mm256_store_pd(lanes[1], maxX);
+    _mm256_store_pd(lanes[2], minY);
+    _mm256_store_pd(lanes[3], maxY);
+
+    Bounds b{xs[0], ys[0], xs[0], ys[0]};
+    for (int l = 0; l < 4; l++) {
+        b.minX = std::min(b.minX, lanes[0][l]);
+        b.maxX = std::max(b.maxX, lanes[1][l]);
+        b.minY = std::min(b.minY, lanes[2][l]);
+        b.maxY = std::max(b.maxY, lanes[3][l]);
+    }
+    return boundsScalar(xs, ys, i, count, b);
+}
+
+__attribute__((target("avx2"))) static double maxAvx2(const double* values, size_t count, double init) {
+    __m256d max = _mm256_set1_pd(init);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) { max = _mm256_max_pd(max, _mm256_loadu_pd(values + i)); }
+
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, max);
+    double result = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+    return maxScalar(values, i, count, result);
+}
+
+__attribute__((target("avx2"))) static __m256d inRectAvx2(__m256d px, __m256d py, __m256d x1, __m256d y1,
+                                                          __m256d x2, __m256d y2) {
+    __m256d m = _mm256_and_pd(_mm256_cmp_pd(px, x1, _CMP_GE_OQ), _mm256_cmp_pd(py, y1, _CMP_GE_OQ));
+    return _mm256_and_pd(m, _mm256_and_pd(_mm256_cmp_pd(px, x2, _CMP_LE_OQ), _mm256_cmp_pd(py, y2, _CMP_LE_OQ)));
+}
+
+__attribute__((target("avx2"))) static size_t findPointInRectAvx2(const double* xs, const double* ys, size_t count,
+                                                                  double x1, double y1, double x2, double y2) {
+    __m256d vx1 = _mm256_set1_pd(x1);
+    __m256d vy1 = _mm256_set1_pd(y1);
+    __m256d vx2 = _mm256_set1_pd(x2);
+    __m256d vy2 = _mm256_set1_pd(y2);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256d m = inRectAvx2(_mm256_loadu_pd(xs + i), _mm256_loadu_pd(ys + i), vx1, vy1, vx2, vy2);
+        if (int bits = _mm256_movemask_pd(m)) {
+            return i + static_cast<size_t>(__builtin_ctz(static_cast<unsigned>(bits)));
+        }
+    }
+    return findPointInRectScalar(xs, ys, i, count, x1, y1, x2, y2);
+}
+
+__attribute__((target("avx2"))) static size_t findHitAvx2(const double* xs, const double* ys, size_t count, double x,
+                                                          double y, double halfSize) {
+    const __m256d vx = _mm256_set1_pd(x);
+    const __m256d vy = _mm256_set1_pd(y);
+    const __m256d h = _mm256_set1_pd(halfSize);
+    const __m256d x1 = _mm256_set1_pd(x - halfSize);
+    const __m256d y1 = _mm256_set1_pd(y - halfSize);
+    const __m256d x2 = _mm256_set1_pd(x + halfSize);
+    const __m256d y2 = _mm256_set1_pd(y + halfSize);
+    const __m256d hDiagonal = _mm256_set1_pd(halfSize * SQRT2);
+    const __m256d half = _mm256_set1_pd(0.5);
+    const __m256d padding = _mm256_set1_pd(PADDING);
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d signMask = _mm256_set1_pd(-0.0);
+
+    size_t i = 1;
+    for (; i + 4 <= count; i += 4) {
+        __m256d ax = _mm256_loadu_pd(xs + i - 1);
+        __m256d ay = _mm256_loadu_pd(ys + i - 1);
+        __m256d bx = _mm256_loadu_pd(xs + i);
+        __m256d by = _mm256_loadu_pd(ys + i);
+
+        __m256d hit = inRectAvx2(bx, by, x1, y1, x2, y2);
+
+        __m256d dx = _mm256_sub_pd(bx, ax);
+        __m256d dy = _mm256_sub_pd(by, ay);
+        __m256d len = _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)));
+        __m256d seg = _mm256_and_pd(_mm256_cmp_pd(len, h, _CMP_GE_OQ), _mm256_cmp_pd(len, zero, _CMP_GT_OQ));
+
+        __m256d cross = _mm256_add_pd(_mm256_mul_pd(_mm256_sub_pd(vx, ax), _mm256_sub_pd(ay, by)),
+                                      _mm256_mul_pd(_mm256_sub_pd(vy, ay), dx));
+        cross = _mm256_andnot_pd(signMask, cross);
+        seg = _mm256_and_pd(seg, _mm256_cmp_pd(cross, _mm256_mul_pd(h, len), _CMP_LE_OQ));
+
+        __m256d cx = _mm256_sub_pd(vx, _mm256_mul_pd(_mm256_add_pd(ax, bx), half));
+        __m256d cy = _mm256_sub_pd(vy, _mm256_mul_pd(_mm256_add_pd(ay, by), half));
+        __m256d dist = _mm256_sub_pd(_mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(cx, cx), _mm256_mul_pd(cy, cy))),
+                                     hDiagonal);
+        seg = _mm256_and_pd(seg,
+                            _mm256_cmp_pd(dist, _mm256_add_pd(_mm256_mul_pd(len, half), padding), _CMP_LE_OQ));
+
+        if (int bits = _mm256_movemask_pd(_mm256_or_pd(hit, seg))) {
+            return i + static_cast<size_t>(__builtin_ctz(static_cast<unsigned>(bits)));
+        }
+    }
+    return findHitScalar(xs, ys, i, count, x, y, halfSize);
+}
+
+__attribute__((target("avx2"))) static void transformAvx2(double* xs, double* ys, size_t count, double xx, double yx,
+                                                          double xy, double yy, double x0, double y0) {
+    const __m256d vxx = _mm256_set1_pd(xx);
+    const __m256d vyx = _mm256_set1_pd(yx);
+    const __m256d vxy = _mm256_set1_pd(xy);
+    const __m256d vyy = _mm256_set1_pd(yy);
+    const __m256d vx0 = _mm256_set1_pd(x0);
+    const __m256d vy0 = _mm256_set1_pd(y0);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256d px = _mm256_loadu_pd(xs + i);
+        __m256d py = _mm256_loadu_pd(ys + i);
+        _mm256_storeu_pd(xs + i, _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(vxx, px), _mm256_mul_pd(vxy, py)), vx0));
+        _mm256_storeu_pd(ys + i, _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(vyx, px), _mm256_mul_pd(vyy, py)), vy0));
+    }
+    transformScalar(xs, ys, i, count, xx, yx, xy, yy, x0, y0);
+}
+
+#endif  // XOJ_GEOMETRY_X86
+
+#if defined(XOJ_GEOMETRY_X86) && defined(__SSE2__)
+
+////////////////////////////////////////////////////////////////////////////////
+// SSE2, 2 points per iteration
+////////////////////////////////////////////////////////////////////////////////
+
+static Bounds boundsSse2(const double* xs, const double* ys, size_t count) {
+    __m128d minX = _mm_set1_pd(xs[0]);
+    __m128d maxX = minX;
+    __m128d minY = _mm_set1_pd(ys[0]);
+    __m128d maxY = minY;
+
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m128d px = _mm_loadu_pd(xs + i);
+        __m128d py = _mm_loadu_pd(ys + i);
+        minX = _mm_min_pd(minX, px);
+        maxX = _mm_max_pd(maxX, px);
+        minY = _mm_min_pd(minY, py);
+        maxY = _mm_max_pd(maxY, py);
+    }
+
+    alignas(16) double lanes[4][2];
+    _mm_store_pd(lanes[0], minX);
+    _mm_store_pd(lanes[1], maxX);
+    _mm_store_pd(lanes[2], minY);
+    _mm_store_pd(lanes[3], maxY);
+
+    Bounds b{std::min(lanes[0][0], lanes[0][1]), std::min(lanes[2][0], lanes[2][1]),
+             std::max(lanes[1][0], lanes[1][1]), std::max(lanes[3][0], lanes[3][1])};
+    return boundsScalar(xs, ys, i, count, b);
+}
+
+static double maxSse2(const double* values, size_t count, double init) {
+    __m128d max = _mm_set1_pd(init);
+
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) { max = _mm_max_pd(max, _mm_loadu_pd(values + i)); }
+
+    alignas(16) double lanes[2];
+    _mm_store_pd(lanes, max);
+    return maxScalar(values, i, count, std::max(lanes[0], lanes[1]));
+}
+
+static inline __m128d inRectSse2(__m128d px, __m128d py, __m128d x1, __m128d y1, __m128d x2, __m128d y2) {
+    __m128d m = _mm_and_pd(_mm_cmpge_pd(px, x1), _mm_cmpge_pd(py, y1));
+    return _mm_and_pd(m, _mm_and_pd(_mm_cmple_pd(px, x2), _mm_cmple_pd(py, y2)));
+}
+
+static size_t findPointInRectSse2(const double* xs, const double* ys, size_t count, double x1, double y1, double x2,
+                                  double y2) {
+    __m128d vx1 = _mm_set1_pd(x1);
+    __m128d vy1 = _mm_set1_pd(y1);
+    __m128d vx2 = _mm_set1_pd(x2);
+    __m128d vy2 = _mm_set1_pd(y2);
+
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m128d m = inRectSse2(_mm_loadu_pd(xs + i), _mm_loadu_pd(ys + i), vx1, vy1, vx2, vy2);
+        if (int bits = _mm_movemask_pd(m)) {
+            return i + ((bits & 1) ? 0 : 1);
+        }
+    }
+    return findPointInRectScalar(xs, ys, i, count, x1, y1, x2, y2);
+}
+
+static size_t findHitSse2(const double* xs, const double* ys, size_t count, double x, double y, double halfSize) {
+    const __m128d vx = _mm_set1_pd(x);
+    const __m128d vy = _mm_set1_pd(y);
+    const __m128d h = _mm_set1_pd(halfSize);
+    const __m128d x1 = _mm_set1_pd(x - halfSize);
+    const __m128d y1 = _mm_set1_pd(y - halfSize);
+    const __m128d x2 = _mm_set1_pd(x + halfSize);
+    const __m128d y2 = _mm_set1_pd(y + halfSize);
+    const __m128d hDiagonal = _mm_set1_pd(halfSize * SQRT2);
+    const __m128d half = _mm_set1_pd(0.5);
+    const __m128d padding = _mm_set1_pd(PADDING);
+    const __m128d zero = _mm_setzero_pd();
+    const __m128d signMask = _mm_set1_pd(-0.0);
+
+    size_t i = 1;
+    for (; i + 2 <= count; i += 2) {
+        __m128d ax = _mm_loadu_pd(xs + i - 1);
+        __m128d ay = _mm_loadu_pd(ys + i - 1);
+        __m128d bx = _mm_loadu_pd(xs + i);
+        __m128d by = _mm_loadu_pd(ys + i);
+
+        __m128d hit = inRectSse2(bx, by, x1, y1, x2, y2);
+
+        __m128d dx = _mm_sub_pd(bx, ax);
+        __m128d dy = _mm_sub_pd(by, ay);
+        __m128d len = _mm_sqrt_pd(_mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy)));
+        __m128d seg = _mm_and_pd(_mm_cmpge_pd(len, h), _mm_cmpgt_pd(len, zero));
+
+        __m128d cross =
+                _mm_add_pd(_mm_mul_pd(_mm_sub_pd(vx, ax), _mm_sub_pd(ay, by)), _mm_mul_pd(_mm_sub_pd(vy, ay), dx));
+        cross = _mm_andnot_pd(signMask, cross);
+        seg = _mm_and_pd(seg, _mm_cmple_pd(cross, _mm_mul_pd(h, len)));
+
+        __m128d cx = _mm_sub_pd(vx, _mm_mul_pd(_mm_add_pd(ax, bx), half));
+        __m128d cy = _mm_sub_pd(vy, _mm_mul_pd(_mm_add_pd(ay, by), half));
+        __m128d dist = _mm_sub_pd(_mm_sqrt_pd(_mm_add_pd(_mm_mul_pd(cx, cx), _mm_mul_pd(cy, cy))), hDiagonal);
+        seg = _mm_and_pd(seg, _mm_cmple_pd(dist, _mm_add_pd(_mm_mul_pd(len, half), padding)));
+
+        if (int bits = _mm_movemask_pd(_mm_or_pd(hit, seg))) {
+            return i + ((bits & 1) ? 0 : 1);
+        }
+    }
+    return findHitScalar(xs, ys, i, count, x, y, halfSize);
+}
+
+static void transformSse2(double* xs, double* ys, size_t count, double xx, double yx, double xy, double yy, double x0,
+                          double y0) {
+    const __m128d vxx = _mm_set1_pd(xx);
+    const __m128d vyx = _mm_set1_pd(yx);
+    const __m128d vxy = _mm_set1_pd(xy);
+    const __m128d vyy = _mm_set1_pd(yy);
+    const __m128d vx0 = _mm_set1_pd(x0);
+    const __m128d vy0 = _mm_set1_pd(y0);
+
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m128d px = _mm_loadu_pd(xs + i);
+        __m128d py = _mm_loadu_pd(ys + i);
+        _mm_storeu_pd(xs + i, _mm_add_pd(_mm_add_pd(_mm_mul_pd(vxx, px), _mm_mul_pd(vxy, py)), vx0));
+        _mm_storeu_pd(ys + i, _mm_add_pd(_mm_add_pd(_mm_mul_pd(vyx, px), _mm_mul_pd(vyy, py)), vy0));
+    }
+    transformScalar(xs, ys, i, count, xx, yx, xy, yy, x0, y0);
+}
+
+#define XOJ_GEOMETRY_SSE2
+#endif  // XOJ_GEOMETRY_X86 && __SSE2__
+
+////////////////////////////////////////////////////////////////////////////////
+// Dispatch
+////////////////////////////////////////////////////////////////////////////////
+
+Bounds bounds(const double* xs, const double* ys, size_t count) {
+#ifdef XOJ_GEOMETRY_X86
+    if (hasAvx2()) {
+        return boundsAvx2(xs, ys, count);
+    }
+#endif
+#ifdef XOJ_GEOMETRY_SSE2
+    return boundsSse2(xs, ys, count);
+#else
+    return boundsScalar(xs, ys, 0, count, Bounds{xs[0], ys[0], xs[0], ys[0]});
+#endif
+}
+
+double maxValue(const double* values, size_t count, double init) {
+#ifdef XOJ_GEOMETRY_X86
+    if (hasAvx2()) {
+        return maxAvx2(values, count, init);
+    }
+#endif
+#ifdef XOJ_GEOMETRY_SSE2
+    return maxSse2(values, count, init);
+#else
+    return maxScalar(values, 0, count, init);
+#endif
+}
+
+size_t findPointInRect(const double* xs, const double* ys, size_t count, double x1, double y1, double x2, double y2) {
+#ifdef XOJ_GEOMETRY_X86
+    if (hasAvx2()) {
+        return findPointInRectAvx2(xs, ys, count, x1, y1, x2, y2);
+    }
+#endif
+#ifdef XOJ_GEOMETRY_SSE2
+    return findPointInRectSse2(xs, ys, count, x1, y1, x2, y2);
+#else
+    return findPointInRectScalar(xs, ys, 0, count, x1, y1, x2, y2);
+#endif
+}
+
+size_t findHit(const double* xs, const double* ys, size_t count, double x, double y, double halfSize) {
+    if (count == 0) {
+        return 0;
+    }
+    if (inRect(xs[0], ys[0], x - halfSize, y - halfSize, x + halfSize, y + halfSize)) {
+        return 0;
+    }
+
+#ifdef XOJ_GEOMETRY_X86
+    if (hasAvx2()) {
+        return findHitAvx2(xs, ys, count, x, y, halfSize);
+    }
+#endif
+#ifdef XOJ_GEOMETRY_SSE2
+    return findHitSse2(xs, ys, count, x, y, halfSize);
+#else
+    return findHitScalar(xs, ys, 1, count, x, y, halfSize);
+#endif
+}
+
+void transform(double* xs, double* ys, size_t count, double xx, double yx, double xy, double yy, double x0,
+               double y0) {
+#ifdef XOJ_GEOMETRY_X86
+    if (hasAvx2()) {
+        transformAvx2(xs, ys, count, xx, yx, xy, yy, x0, y0);
+        return;
+    }
+#endif
+#ifdef XOJ_GEOMETRY_SSE2
+    transformSse2(xs, ys, count, xx, yx, xy, yy, x0, y0);
+#else
+    transformScalar(xs, ys, 0, count, xx, yx, xy, yy, x0, y0);
+#endif
+}
+
+void translate(double* xs, double* ys, size_t count, double dx, double dy) {
+    for (size_t i = 0; i < count; i++) { xs[i] += dx; }
+    for (size_t i = 0; i < count; i++) { ys[i] += dy; }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Simplification
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @return The squared distance of p to the segment a - b
+ */
+static double segmentDistanceSq(double ax, double ay, double bx, double by, double px, double py) {
+    double dx = bx - ax;
+    double dy = by - ay;
+    double lenSq = dx * dx + dy * dy;
+    double t = lenSq > 0 ? std::clamp(((px - ax) * dx + (py - ay) * dy) / lenSq, 0.0, 1.0) : 0.0;
+    double ex = ax + t * dx - px;
+    double ey = ay + t * dy - py;
+    return ex * ex + ey * ey;
+}
+
+std::vector<size_t> simplify(const double* xs, const double* ys, size_t count, double tolerance) {
+    std::vector<size_t> kept;
+    if (count == 0) {
+        return kept;
+    }
+
+    // Radial pass, linear time. Usually most points are dropped here, which keeps the quadratic worst case
+    // of Ramer-Douglas-Peucker cheap.
+    const double toleranceSq = tolerance * tolerance;
+    std::vector<size_t> candidates;
+    candidates.push_back(0);
+    for (size_t i = 1; i + 1 < count; i++) {
+        size_t last = candidates.back();
+        double dx = xs[i] - xs[last];
+        double dy = ys[i] - ys[last];
+        if (dx * dx + dy * dy > toleranceSq) {
+            candidates.push_back(i);
+        }
+    }
+    if (count > 1) {
+        candidates.push_back(count - 1);
+    }
+
+    // Ramer-Douglas-Peucker on the candidates, without recursion
+    std::vector<bool> keep(candidates.size(), false);
+    keep.front() = true;
+    keep.back() = true;
+    std::vector<std::pair<size_t, size_t>> ranges;
+    if (candidates.size() > 2) {
+        ranges.emplace_back(0, candidates.size() - 1);
+    }
+    while (!ranges.empty()) {
+        auto [first, last] = ranges.back();
+        ranges.pop_back();
+
+        size_t a = candidates[first];
+        size_t b = candidates[last];
+        double maxDistanceSq = -1;
+        size_t farthest = first;
+        for (size_t k = first + 1; k < last; k++) {
+            size_t i = candidates[k];
+            double distanceSq = segmentDistanceSq(xs[a], ys[a], xs[b], ys[b], xs[i], ys[i]);
+            if (distanceSq > maxDistanceSq) {
+                maxDistanceSq = distanceSq;
+                farthest = k;
+            }
+        }
+
+        if (maxDistanceSq > toleranceSq) {
+            keep[farthest] = true;
+            if (farthest - first > 1) {
+                ranges.emplace_back(first, farthest);
+            }
+            if (last - farthest > 1) {
+                ranges.emplace_back(farthest, last);
+            }
+        }
+    }
+
+    for (size_t k = 0; k < candidates.size(); k++) {
+        if (keep[k]) {
+            kept.push_back(candidates[k]);
+        }
+    }
+    return kept;
+}
+
+}  // namespace xoj::util::geometry
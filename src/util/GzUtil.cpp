@@ -9,3 +9,22 @@ auto GzUtil::openPath(const fs::path& path, const std::string& flags) -> gzFile
     return gzopen(path.c_str(), flags.c_str());
 #endif
 }
+
+auto GzUtil::compress(const std::string& input, std::string& output, int level) -> bool {
+    z_stream strm{};
+    // 16 + max window bits: write a gzip header and trailer
+    if (deflateInit2(&strm, level, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return false;
+    }
+
+    output.resize(deflateBound(&strm, static_cast<uLong>(input.size())));
+    strm.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+    strm.avail_in = static_cast<uInt>(input.size());
+    strm.next_out = reinterpret_cast<Bytef*>(&output[0]);
+    strm.avail_out = static_cast<uInt>(output.size());
+
+    bool success = deflate(&strm, Z_FINISH) == Z_STREAM_END;
+    output.resize(strm.total_out);
+    deflateEnd(&strm);
+    return success;
+}
@@ -0,0 +1,87 @@
+#include "util/InstrumentedSharedMutex.h"
+
+#include <chrono>
+#include <sstream>
+
+using std::chrono::steady_clock;
+
+static auto nanosecondsSince(steady_clock::time_point start) -> uint64_t {
+    return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(steady_clock::now() - start).count());
+}
+
+auto LockStatistics::toString() const -> std::string {
+    std::ostringstream out;
+    out << "exclusive: " << exclusiveLocks << " locks, " << exclusiveContended << " contended, "
+        << exclusiveWaitNs / 1000000.0 << " ms waited; shared: " << sharedLocks << " locks, " << sharedContended
+        << " contended, " << sharedWaitNs / 1000000.0 << " ms waited";
+    return out.str();
+}
+
+InstrumentedSharedMutex::InstrumentedSharedMutex() = default;
+
+InstrumentedSharedMutex::~InstrumentedSharedMutex() = default;
+
+void InstrumentedSharedMutex::lock() {
+    this->exclusiveLocks.fetch_add(1, std::memory_order_relaxed);
+    if (this->mutex.try_lock()) {
+        return;
+    }
+
+    auto start = steady_clock::now();
+    this->mutex.lock();
+    this->exclusiveContended.fetch_add(1, std::memory_order_relaxed);
+    this->exclusiveWaitNs.fetch_add(nanosecondsSince(start), std::memory_order_relaxed);
+}
+
+auto InstrumentedSharedMutex::try_lock() -> bool {
+    if (!this->mutex.try_lock()) {
+        return false;
+    }
+    this->exclusiveLocks.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void InstrumentedSharedMutex::unlock() { this->mutex.unlock(); }
+
+void InstrumentedSharedMutex::lock_shared() {
+    this->sharedLocks.fetch_add(1, std::memory_order_relaxed);
+    if (this->mutex.try_lock_shared()) {
+        return;
+    }
+
+    auto start = steady_clock::now();
+    this->mutex.lock_shared();
+    this->sharedContended.fetch_add(1, std::memory_order_relaxed);
+    this->sharedWaitNs.fetch_add(nanosecondsSince(start), std::memory_order_relaxed);
+}
+
+auto InstrumentedSharedMutex::try_lock_shared() -> bool {
+    if (!this->mutex.try_lock_shared()) {
+        return false;
+    }
+    this->sharedLocks.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void InstrumentedSharedMutex::unlock_shared() { this->mutex.unlock_shared(); }
+
+auto InstrumentedSharedMutex::getStatistics() const -> LockStatistics {
+    LockStatistics stats;
+    stats.exclusiveLocks = this->exclusiveLocks.load(std::memory_order_relaxed);
+    stats.sharedLocks = this->sharedLocks.load(std::memory_order_relaxed);
+    stats.exclusiveContended = this->exclusiveContended.load(std::memory_order_relaxed);
+    stats.sharedContended = this->sharedContended.load(std::memory_order_relaxed);
+    stats.exclusiveWaitNs = this->exclusiveWaitNs.load(std::memory_order_relaxed);
+    stats.sharedWaitNs = this->sharedWaitNs.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void InstrumentedSharedMutex::resetStatistics() {
+    this->exclusiveLocks = 0;
+    this->sharedLocks = 0;
+    this->exclusiveContended = 0;
+    this->sharedContended = 0;
+    this->exclusiveWaitNs = 0;
+    this->sharedWaitNs = 0;
+}
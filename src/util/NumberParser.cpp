@@ -0,0 +1,78 @@
+#include "util/NumberParser.h"
+
+#include <charconv>
+#include <cstring>
+
+#include <glib.h>
+
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+#define XOJ_HAS_FLOAT_FROM_CHARS
+#endif
+
+namespace xoj::util {
+
+static inline bool isSpace(char c) { return c == ' ' || c == '\n' || c == '\t' || c == '\r'; }
+
+/**
+ * Parses one number starting at start with g_ascii_strtod
+ *
+ * @return Pointer behind the number, or p if there is no number
+ */
+static const char* parseDoubleStrtod(const char* p, const char* start, const char* end, double& value) {
+    // Copy the token, g_ascii_strtod needs a null terminated string
+    char buffer[64];
+    size_t len = 0;
+    while (start + len != end && !isSpace(start[len]) && len < sizeof(buffer) - 1) { len++; }
+    std::memcpy(buffer, start, len);
+    buffer[len] = 0;
+
+    char* endPtr = nullptr;
+    value = g_ascii_strtod(buffer, &endPtr);
+    return endPtr == buffer ? p : start + (endPtr - buffer);
+}
+
+/**
+ * Parses one number starting at p
+ *
+ * @return Pointer behind the number, or p if there is no number
+ */
+static const char* parseDouble(const char* p, const char* end, double& value) {
+    const char* start = p;
+    // from_chars does not accept a leading plus sign
+    if (*p == '+' && p + 1 != end) {
+        start++;
+    }
+
+#ifdef XOJ_HAS_FLOAT_FROM_CHARS
+    auto [ptr, ec] = std::from_chars(start, end, value);
+    if (ec == std::errc()) {
+        return ptr;
+    }
+    if (ec != std::errc::result_out_of_range) {
+        return p;
+    }
+    // from_chars does not return a value for huge and tiny numbers, strtod returns +-HUGE_VAL, the denormal
+    // value or 0 as the file parser did before
+#endif
+    return parseDoubleStrtod(p, start, end, value);
+}
+
+auto parseDoubles(const char* begin, const char* end, std::vector<double>& out) -> const char* {
+    const char* p = begin;
+    while (true) {
+        while (p != end && isSpace(*p)) { p++; }
+        if (p == end) {
+            return p;
+        }
+
+        double value = 0;
+        const char* next = parseDouble(p, end, value);
+        if (next == p) {
+            return p;
+        }
+        out.push_back(value);
+        p = next;
+    }
+}
+
+}  // namespace xoj::util
@@ -1,5 +1,7 @@
 #include "util/OutputStream.h"
 
+#include <algorithm>
+
 #include <glib.h>
 
 #include "util/GzUtil.h"
@@ -17,11 +19,34 @@ void OutputStream::write(const char* str) { write(str, strlen(str)); }
 /// GzOutputStream /////////////////////////////////////
 ////////////////////////////////////////////////////////
 
-GzOutputStream::GzOutputStream(fs::path file): file(std::move(file)) {
-    this->fp = GzUtil::openPath(this->file, "w");
+/**
+ * Size of the uncompressed blocks. Each block is a separate gzip member with its own dictionary,
+ * larger blocks compress slightly better.
+ */
+constexpr size_t GZ_BLOCK_SIZE = 1024 * 1024;
+
+/**
+ * Upper limit of compression threads
+ */
+constexpr unsigned int GZ_MAX_WORKERS = 8;
+
+struct GzOutputStream::Block {
+    std::string input;
+    std::string output;
+    bool compressed = false;
+    bool failed = false;
+};
+
+GzOutputStream::GzOutputStream(fs::path file, int level): level(level), file(std::move(file)) {
+    // The members are compressed here, zlib only writes them to the file
+    this->fp = GzUtil::openPath(this->file, "wbT");
     if (this->fp == nullptr) {
         this->error = FS(_F("Error opening file: \"{1}\"") % this->file.u8string());
+        return;
     }
+
+    this->buffer.reserve(GZ_BLOCK_SIZE);
+    this->workerCount = std::min(std::thread::hardware_concurrency(), GZ_MAX_WORKERS);
 }
 
 GzOutputStream::~GzOutputStream() {
@@ -33,11 +58,163 @@ GzOutputStream::~GzOutputStream() {
 
 auto GzOutputStream::getLastError() -> std::string& { return this->error; }
 
-void GzOutputStream::write(const char* data, int len) { gzwrite(this->fp, data, len); }
+void GzOutputStream::write(const char* data, int len) {
+    if (this->fp == nullptr) {
+        return;
+    }
+
+    size_t remaining = static_cast<size_t>(len);
+    while (remaining > 0) {
+        size_t count = std::min(remaining, GZ_BLOCK_SIZE - this->buffer.size());
+        this->buffer.append(data, count);
+        data += count;
+        remaining -= count;
+
+        if (this->buffer.size() == GZ_BLOCK_SIZE) {
+            submitBuffer();
+        }
+    }
+}
+
+void GzOutputStream::submitBuffer() {
+    auto block = std::make_shared<Block>();
+    block->input.swap(this->buffer);
+    this->buffer.reserve(GZ_BLOCK_SIZE);
+    this->blockSubmitted = true;
+
+    if (this->workerCount <= 1) {
+        block->failed = !GzUtil::compress(block->input, block->output, this->level);
+        writeBlock(*block);
+        return;
+    }
+
+    if (this->workers.empty()) {
+        startWorkers();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(this->blockMutex);
+        this->pending.push_back(block);
+        this->queue.push_back(block);
+    }
+    this->blockQueued.notify_one();
+
+    // Limit the memory used by blocks waiting to be written
+    writeFinishedBlocks(2 * this->workerCount);
+}
+
+void GzOutputStream::writeFinishedBlocks(size_t maxPending) {
+    std::unique_lock<std::mutex> lock(this->blockMutex);
+    while (!this->pending.empty()) {
+        std::shared_ptr<Block> block = this->pending.front();
+        if (!block->compressed) {
+            if (this->pending.size() <= maxPending) {
+                return;
+            }
+            this->blockCompressed.wait(lock, [&block]() { return block->compressed; });
+        }
+        this->pending.pop_front();
+
+        lock.unlock();
+        writeBlock(*block);
+        lock.lock();
+    }
+}
+
+void GzOutputStream::writeBlock(const Block& block) {
+    if (block.failed && this->error.empty()) {
+        this->error = FS(_F("Error writing file: \"{1}\"") % this->file.u8string());
+    }
+    writeData(block.output);
+}
+
+void GzOutputStream::writeData(const std::string& data) {
+    if (!this->error.empty() || data.empty()) {
+        return;
+    }
+
+    if (gzwrite(this->fp, data.data(), static_cast<unsigned int>(data.size())) <= 0) {
+        this->error = FS(_F("Error writing file: \"{1}\"") % this->file.u8string());
+    }
+}
+
+void GzOutputStream::writeCompressed(const std::string& member) {
+    if (this->fp == nullptr) {
+        return;
+    }
+
+    if (!this->buffer.empty()) {
+        submitBuffer();
+    }
+    this->blockSubmitted = true;
+
+    // Write all blocks before, then the member can be written without a copy
+    writeFinishedBlocks(0);
+    writeData(member);
+}
+
+void GzOutputStream::startWorkers() {
+    this->stopping = false;
+    for (unsigned int i = 0; i < this->workerCount; i++) { this->workers.emplace_back([this]() { workerLoop(); }); }
+}
+
+void GzOutputStream::stopWorkers() {
+    {
+        std::lock_guard<std::mutex> lock(this->blockMutex);
+        this->stopping = true;
+    }
+    this->blockQueued.notify_all();
+
+    for (std::thread& t: this->workers) { t.join(); }
+    this->workers.clear();
+}
+
+void GzOutputStream::workerLoop() {
+    std::unique_lock<std::mutex> lock(this->blockMutex);
+    while (true) {
+        this->blockQueued.wait(lock, [this]() { return this->stopping || !this->queue.empty(); });
+        if (this->queue.empty()) {
+            return;
+        }
+
+        std::shared_ptr<Block> block = this->queue.front();
+        this->queue.pop_front();
+
+        lock.unlock();
+        bool failed = !GzUtil::compress(block->input, block->output, this->level);
+        block->input = std::string();
+        lock.lock();
+
+        block->failed = failed;
+        block->compressed = true;
+        this->blockCompressed.notify_all();
+    }
+}
 
 void GzOutputStream::close() {
-    if (this->fp) {
-        gzclose(this->fp);
-        this->fp = nullptr;
+    if (this->fp == nullptr) {
+        return;
+    }
+
+    // An empty file still needs one gzip member
+    if (!this->buffer.empty() || !this->blockSubmitted) {
+        submitBuffer();
+    }
+    writeFinishedBlocks(0);
+    stopWorkers();
+
+    if (gzclose(this->fp) != Z_OK && this->error.empty()) {
+        this->error = FS(_F("Error writing file: \"{1}\"") % this->file.u8string());
     }
+    this->fp = nullptr;
 }
+
+////////////////////////////////////////////////////////
+/// StringOutputStream /////////////////////////////////
+////////////////////////////////////////////////////////
+
+void StringOutputStream::write(const char* data, int len) { this->str.append(data, static_cast<size_t>(len)); }
+
+void StringOutputStream::close() {}
+
+auto StringOutputStream::getString() const -> const std::string& { return this->str; }
@@ -0,0 +1,82 @@
+/*
+ * Xournal++
+ *
+ * Vectorized loops over point coordinate arrays
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Kernels over separate x and y coordinate arrays, as stored by strokes.
+ *
+ * On x86 the kernels use AVX2 if the CPU supports it (checked at runtime), otherwise SSE2.
+ * Other platforms use the scalar implementation, which gives the same results.
+ */
+namespace xoj::util::geometry {
+
+struct Bounds {
+    double minX;
+    double minY;
+    double maxX;
+    double maxY;
+};
+
+/**
+ * @return The bounding box of the points, count has to be > 0
+ */
+Bounds bounds(const double* xs, const double* ys, size_t count);
+
+/**
+ * @return The maximum of the values and init
+ */
+double maxValue(const double* values, size_t count, double init);
+
+/**
+ * @return The index of the first point inside the rectangle [x1, x2] x [y1, y2], or count if there is none
+ */
+size_t findPointInRect(const double* xs, const double* ys, size_t count, double x1, double y1, double x2, double y2);
+
+/**
+ * Hit test of the segment (ax, ay) - (bx, by) with the square of half edge length halfSize around (x, y),
+ * not considering the end points. The segment is hit if the center of the square is close to the
+ * line through the points and not too far from the segment.
+ *
+ * @param distance Is set to the distance of the square to the segment, if it is hit
+ */
+bool segmentHit(double ax, double ay, double bx, double by, double x, double y, double halfSize, double* distance);
+
+/**
+ * @return The index of the first point i, for which the point lies in the square of half edge length
+ *         halfSize around (x, y), or the segment (i - 1, i) is hit (see segmentHit). count if there is none.
+ */
+size_t findHit(const double* xs, const double* ys, size_t count, double x, double y, double halfSize);
+
+/**
+ * Applies the affine transformation x' = xx * x + xy * y + x0, y' = yx * x + yy * y + y0 to all points
+ */
+void transform(double* xs, double* ys, size_t count, double xx, double yx, double xy, double yy, double x0,
+               double y0);
+
+/**
+ * Moves all points by (dx, dy)
+ */
+void translate(double* xs, double* ys, size_t count, double dx, double dy);
+
+/**
+ * Simplifies the polyline for drawing at a low resolution: points closer than tolerance to the last kept
+ * point are dropped, then the Ramer-Douglas-Peucker algorithm removes the points which are closer than
+ * tolerance to the simplified polyline.
+ *
+ * @return The indices of the kept points in ascending order, the first and the last point are always kept
+ */
+std::vector<size_t> simplify(const double* xs, const double* ys, size_t count, double tolerance);
+
+}  // namespace xoj::util::geometry
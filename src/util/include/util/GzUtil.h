@@ -11,6 +11,8 @@
 
 #pragma once
 
+#include <string>
+
 #include <zlib.h>
 
 #include "filesystem.h"
@@ -22,4 +24,12 @@ private:
 
 public:
     static gzFile openPath(const fs::path& path, const std::string& flags);
+
+    /**
+     * Compresses input to a complete gzip member. Concatenated members are a valid gzip file.
+     *
+     * @param level The zlib compression level
+     * @return false on error
+     */
+    static bool compress(const std::string& input, std::string& output, int level);
 };
@@ -0,0 +1,75 @@
+/*
+ * Xournal++
+ *
+ * A shared mutex which counts how often it was contended
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+
+/**
+ * Counters of an InstrumentedSharedMutex
+ */
+struct LockStatistics {
+    uint64_t exclusiveLocks = 0;
+    uint64_t sharedLocks = 0;
+
+    /**
+     * Locks which had to wait for another thread
+     */
+    uint64_t exclusiveContended = 0;
+    uint64_t sharedContended = 0;
+
+    /**
+     * Total time spent waiting for the lock
+     */
+    uint64_t exclusiveWaitNs = 0;
+    uint64_t sharedWaitNs = 0;
+
+    std::string toString() const;
+};
+
+/**
+ * A std::shared_mutex which records how often it was locked and how long threads waited for it.
+ * Uncontended locks only cost an additional atomic increment.
+ *
+ * Satisfies the SharedMutex requirements, so it can be used with std::unique_lock and std::shared_lock.
+ */
+class InstrumentedSharedMutex {
+public:
+    InstrumentedSharedMutex();
+    ~InstrumentedSharedMutex();
+    InstrumentedSharedMutex(const InstrumentedSharedMutex&) = delete;
+    InstrumentedSharedMutex& operator=(const InstrumentedSharedMutex&) = delete;
+
+public:
+    void lock();
+    bool try_lock();
+    void unlock();
+
+    void lock_shared();
+    bool try_lock_shared();
+    void unlock_shared();
+
+    LockStatistics getStatistics() const;
+    void resetStatistics();
+
+private:
+    std::shared_mutex mutex;
+
+    std::atomic<uint64_t> exclusiveLocks{0};
+    std::atomic<uint64_t> sharedLocks{0};
+    std::atomic<uint64_t> exclusiveContended{0};
+    std::atomic<uint64_t> sharedContended{0};
+    std::atomic<uint64_t> exclusiveWaitNs{0};
+    std::atomic<uint64_t> sharedWaitNs{0};
+};
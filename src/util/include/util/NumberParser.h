@@ -0,0 +1,29 @@
+/*
+ * Xournal++
+ *
+ * Locale independent parsing of number lists
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace xoj::util {
+
+/**
+ * Parses the whitespace separated floating point numbers in [begin, end), as written for the coordinates
+ * and pressures of strokes. The text does not need to be null terminated. Parsing stops at the first token
+ * which is not a number.
+ *
+ * @param out The numbers are appended to this vector
+ * @return Pointer behind the last parsed number
+ */
+const char* parseDoubles(const char* begin, const char* end, std::vector<double>& out);
+
+}  // namespace xoj::util
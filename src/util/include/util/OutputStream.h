@@ -11,7 +11,12 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <zlib.h>
@@ -31,23 +36,95 @@ public:
     virtual void close() = 0;
 };
 
+/**
+ * Writes a gzip file. The data is split into blocks which are compressed on worker threads as independent
+ * gzip members, like pigz does. The concatenated members are a valid gzip file.
+ */
 class GzOutputStream: public OutputStream {
 public:
-    GzOutputStream(fs::path file);
+    /**
+     * @param level The zlib compression level, Z_BEST_SPEED (1) to Z_BEST_COMPRESSION (9) or Z_DEFAULT_COMPRESSION
+     */
+    GzOutputStream(fs::path file, int level = Z_DEFAULT_COMPRESSION);
     ~GzOutputStream() override;
 
 public:
+    using OutputStream::write;
     void write(const char* data, int len) override;
 
+    /**
+     * Writes a complete gzip member, e.g. created by GzUtil::compress, after the data written so far
+     */
+    void writeCompressed(const std::string& member);
+
     void close() override;
 
     std::string& getLastError();
 
+private:
+    struct Block;
+
+    /**
+     * Hands the buffer to the workers, or compresses it directly if there are no workers
+     */
+    void submitBuffer();
+
+    /**
+     * Writes the compressed blocks in order, until at most maxPending blocks are left
+     */
+    void writeFinishedBlocks(size_t maxPending);
+    void writeBlock(const Block& block);
+    void writeData(const std::string& data);
+
+    void startWorkers();
+    void stopWorkers();
+    void workerLoop();
+
 private:
     gzFile fp = nullptr;
+    int level;
 
     std::string error;
 
     std::string target;
     fs::path file;
+
+    /**
+     * Data not yet handed to the workers
+     */
+    std::string buffer;
+    bool blockSubmitted = false;
+
+    std::vector<std::thread> workers;
+    unsigned int workerCount = 0;
+
+    /**
+     * All blocks not yet written, in file order
+     */
+    std::deque<std::shared_ptr<Block>> pending;
+
+    /**
+     * Blocks waiting for a worker
+     */
+    std::deque<std::shared_ptr<Block>> queue;
+
+    bool stopping = false;
+    std::mutex blockMutex;
+    std::condition_variable blockQueued;
+    std::condition_variable blockCompressed;
+};
+
+/**
+ * Collects the written data in memory
+ */
+class StringOutputStream: public OutputStream {
+public:
+    using OutputStream::write;
+    void write(const char* data, int len) override;
+    void close() override;
+
+    const std::string& getString() const;
+
+private:
+    std::string str;
 };
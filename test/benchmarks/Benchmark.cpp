@@ -0,0 +1,273 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal benchmarks
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <numeric>
+
+#include <config.h>
+
+const void* volatile BenchmarkState::sink = nullptr;
+
+BenchmarkState::BenchmarkState(size_t repetitions, size_t warmup): repetitions(repetitions), warmup(warmup) {}
+
+void BenchmarkState::measure(const std::function<void()>& fn) {
+    measure({}, fn);
+}
+
+void BenchmarkState::measure(const std::function<void()>& setup, const std::function<void()>& fn) {
+    using Clock = std::chrono::steady_clock;
+
+    // Runs fn n times, @return the time in nanoseconds
+    auto run = [&](size_t n) {
+        Clock::duration elapsed{};
+        if (setup) {
+            for (size_t i = 0; i < n; i++) {
+                setup();
+                auto start = Clock::now();
+                fn();
+                elapsed += Clock::now() - start;
+            }
+        } else {
+            auto start = Clock::now();
+            for (size_t i = 0; i < n; i++) { fn(); }
+            elapsed = Clock::now() - start;
+        }
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    };
+
+    // The warmup also finds the count of calls which take long enough for one repetition
+    this->iterations = 1;
+    for (size_t i = 0; i < this->warmup; i++) { run(1); }
+    for (int64_t time = run(this->iterations); time < MIN_REPETITION_TIME; time = run(this->iterations)) {
+        size_t factor = time > 0 ? static_cast<size_t>(MIN_REPETITION_TIME / time) + 1 : 10;
+        this->iterations *= std::clamp<size_t>(factor, 2, 10);
+    }
+
+    this->samples.clear();
+    for (size_t i = 0; i < this->repetitions; i++) {
+        this->samples.push_back(static_cast<double>(run(this->iterations)) / static_cast<double>(this->iterations));
+    }
+}
+
+void BenchmarkState::setItemsPerCall(size_t items) { this->itemsPerCall = items; }
+
+void BenchmarkState::setBytesPerCall(size_t bytes) { this->bytesPerCall = bytes; }
+
+auto Benchmarks::add(const char* name, Function function) -> bool {
+    all().push_back({name, function});
+    return true;
+}
+
+auto Benchmarks::all() -> std::vector<Entry>& {
+    static std::vector<Entry> benchmarks;
+    return benchmarks;
+}
+
+namespace {
+
+struct Result {
+    std::string name;
+    size_t iterations;
+    size_t repetitions;
+    double min;
+    double median;
+    double mean;
+    double max;
+    double stddev;
+    double itemsPerSecond;
+    double bytesPerSecond;
+};
+
+auto summarize(const std::string& name, const BenchmarkState& state) -> Result {
+    std::vector<double> sorted = state.samples;
+    std::sort(sorted.begin(), sorted.end());
+    size_t n = sorted.size();
+
+    Result r{name, state.iterations, n, 0, 0, 0, 0, 0, 0, 0};
+    if (n == 0) {
+        return r;
+    }
+    r.min = sorted.front();
+    r.max = sorted.back();
+    r.median = n % 2 ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+    r.mean = std::accumulate(sorted.begin(), sorted.end(), 0.0) / static_cast<double>(n);
+    double variance = 0;
+    for (double s: sorted) { variance += (s - r.mean) * (s - r.mean); }
+    r.stddev = std::sqrt(variance / static_cast<double>(n));
+    if (r.median > 0) {
+        r.itemsPerSecond = static_cast<double>(state.itemsPerCall) * 1e9 / r.median;
+        r.bytesPerSecond = static_cast<double>(state.bytesPerCall) * 1e9 / r.median;
+    }
+    return r;
+}
+
+auto formatTime(double ns) -> std::string {
+    char buffer[32];
+    if (ns >= 1e9) {
+        snprintf(buffer, sizeof(buffer), "%.3f s", ns / 1e9);
+    } else if (ns >= 1e6) {
+        snprintf(buffer, sizeof(buffer), "%.3f ms", ns / 1e6);
+    } else if (ns >= 1e3) {
+        snprintf(buffer, sizeof(buffer), "%.3f us", ns / 1e3);
+    } else {
+        snprintf(buffer, sizeof(buffer), "%.1f ns", ns);
+    }
+    return buffer;
+}
+
+void printResult(const Result& r) {
+    printf("%-40s %12s %12s %12s %7.1f%%", r.name.c_str(), formatTime(r.median).c_str(), formatTime(r.min).c_str(),
+           formatTime(r.max).c_str(), r.mean > 0 ? 100 * r.stddev / r.mean : 0.0);
+    if (r.bytesPerSecond > 0) {
+        printf("  %.1f MiB/s", r.bytesPerSecond / (1024 * 1024));
+    } else if (r.itemsPerSecond > 0) {
+        printf("  %.3g items/s", r.itemsPerSecond);
+    }
+    printf("\n");
+    fflush(stdout);
+}
+
+/**
+ * Writes the results as JSON, one benchmark per line so the file can be diffed and read by readMedians()
+ */
+auto writeJson(const std::string& filename, const std::vector<Result>& results, size_t repetitions) -> bool {
+    std::ofstream out(filename);
+    out.precision(12);
+    out << "{\n";
+    out << "  \"context\": {\"version\": \"" << PROJECT_STRING << "\", \"repetitions\": " << repetitions
+        << ", \"min_repetition_time_ns\": " << BenchmarkState::MIN_REPETITION_TIME << "},\n";
+    out << "  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& r = results[i];
+        out << "    {\"name\": \"" << r.name << "\", \"iterations\": " << r.iterations
+            << ", \"repetitions\": " << r.repetitions << ", \"median_ns\": " << r.median << ", \"min_ns\": " << r.min
+            << ", \"mean_ns\": " << r.mean << ", \"max_ns\": " << r.max << ", \"stddev_ns\": " << r.stddev
+            << ", \"items_per_second\": " << r.itemsPerSecond << ", \"bytes_per_second\": " << r.bytesPerSecond << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+    return static_cast<bool>(out);
+}
+
+/**
+ * Reads the median of each benchmark from a file written by writeJson()
+ */
+auto readMedians(const std::string& filename) -> std::map<std::string, double> {
+    std::map<std::string, double> medians;
+    std::ifstream in(filename);
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t name = line.find("\"name\": \"");
+        size_t median = line.find("\"median_ns\": ");
+        if (name == std::string::npos || median == std::string::npos) {
+            continue;
+        }
+        name += strlen("\"name\": \"");
+        median += strlen("\"median_ns\": ");
+        medians[line.substr(name, line.find('"', name) - name)] = std::strtod(line.c_str() + median, nullptr);
+    }
+    return medians;
+}
+
+void printComparison(const std::vector<Result>& results, const std::map<std::string, double>& baseline) {
+    printf("\n%-40s %12s %12s %8s\n", "Comparison", "Baseline", "Median", "Change");
+    for (const Result& r: results) {
+        auto it = baseline.find(r.name);
+        if (it == baseline.end() || it->second <= 0) {
+            printf("%-40s %12s %12s\n", r.name.c_str(), "-", formatTime(r.median).c_str());
+            continue;
+        }
+        printf("%-40s %12s %12s %+7.1f%%\n", r.name.c_str(), formatTime(it->second).c_str(),
+               formatTime(r.median).c_str(), 100 * (r.median - it->second) / it->second);
+    }
+}
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --list                 List the benchmarks\n"
+              << "  --filter TEXT          Only run the benchmarks whose name contains TEXT\n"
+              << "  --repetitions N        Repetitions of each benchmark (default 10)\n"
+              << "  --warmup N             Untimed calls before the repetitions (default 2)\n"
+              << "  --json FILE            Write the results as JSON\n"
+              << "  --compare FILE         Compare the medians to a JSON file written before\n";
+}
+
+}  // namespace
+
+auto main(int argc, char* argv[]) -> int {
+    std::string filter;
+    std::string jsonFile;
+    std::string compareFile;
+    size_t repetitions = 10;
+    size_t warmup = 2;
+    bool list = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--list") {
+            list = true;
+        } else if (arg == "--filter" && hasValue) {
+            filter = argv[++i];
+        } else if (arg == "--repetitions" && hasValue) {
+            repetitions = std::max<size_t>(1, std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--warmup" && hasValue) {
+            warmup = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--json" && hasValue) {
+            jsonFile = argv[++i];
+        } else if (arg == "--compare" && hasValue) {
+            compareFile = argv[++i];
+        } else {
+            printUsage(argv[0]);
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    std::vector<Benchmarks::Entry> benchmarks = Benchmarks::all();
+    std::sort(benchmarks.begin(), benchmarks.end(), [](auto& a, auto& b) { return a.name < b.name; });
+    benchmarks.erase(std::remove_if(benchmarks.begin(), benchmarks.end(),
+                                    [&](auto& b) { return b.name.find(filter) == std::string::npos; }),
+                     benchmarks.end());
+
+    if (list) {
+        for (auto& b: benchmarks) { std::cout << b.name << "\n"; }
+        return 0;
+    }
+
+    printf("%-40s %12s %12s %12s %8s\n", "Benchmark", "Median", "Min", "Max", "StdDev");
+    std::vector<Result> results;
+    for (auto& b: benchmarks) {
+        BenchmarkState state(repetitions, warmup);
+        b.function(state);
+        results.push_back(summarize(b.name, state));
+        printResult(results.back());
+    }
+
+    if (!compareFile.empty()) {
+        printComparison(results, readMedians(compareFile));
+    }
+
+    if (!jsonFile.empty() && !writeJson(jsonFile, results, repetitions)) {
+        std::cerr << "Could not write " << jsonFile << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,120 @@
+/*
+ * Xournal++
+ *
+ * A small harness for the microbenchmarks
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * Passed to each benchmark, which prepares its data and then calls measure() once with the code to time.
+ *
+ * The measured code is called a few times to warm up caches, then it is repeated: each repetition
+ * runs it often enough to take at least MIN_REPETITION_TIME, and the time per call of the repetitions
+ * is reported (minimum, median, mean, maximum, standard deviation).
+ */
+class BenchmarkState {
+public:
+    /**
+     * A repetition takes at least this long (in nanoseconds), so short calls are timed accurately
+     */
+    static constexpr int64_t MIN_REPETITION_TIME = 10000000;
+
+public:
+    BenchmarkState(size_t repetitions, size_t warmup);
+
+public:
+    /**
+     * Times fn
+     */
+    void measure(const std::function<void()>& fn);
+
+    /**
+     * Times fn, setup is called before each call of fn and is not timed.
+     * Use it if fn changes its input, e.g. erases strokes which need to be restored.
+     */
+    void measure(const std::function<void()>& setup, const std::function<void()>& fn);
+
+    /**
+     * The count of items (e.g. elements or queries) processed by one call, to report the throughput
+     */
+    void setItemsPerCall(size_t items);
+
+    /**
+     * The count of bytes processed by one call, to report the throughput
+     */
+    void setBytesPerCall(size_t bytes);
+
+    /**
+     * Keeps the compiler from optimizing away a result which is not used otherwise
+     */
+    template <typename T>
+    static void keep(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        sink = &value;
+#endif
+    }
+
+public:
+    /**
+     * Time per call of each repetition, in nanoseconds
+     */
+    std::vector<double> samples;
+
+    /**
+     * Calls of the measured code per repetition
+     */
+    size_t iterations = 0;
+
+    size_t itemsPerCall = 0;
+    size_t bytesPerCall = 0;
+
+private:
+    size_t repetitions;
+    size_t warmup;
+
+    static const void* volatile sink;
+};
+
+/**
+ * All benchmarks, registered by XOJ_BENCHMARK
+ */
+class Benchmarks {
+public:
+    using Function = void (*)(BenchmarkState&);
+
+    struct Entry {
+        std::string name;
+        Function function;
+    };
+
+    /**
+     * @return true, to initialize the static variable of XOJ_BENCHMARK
+     */
+    static bool add(const char* name, Function function);
+
+    static std::vector<Entry>& all();
+};
+
+/**
+ * Defines a benchmark with the name "group.name", the body is the function with the parameter
+ * BenchmarkState& state
+ */
+#define XOJ_BENCHMARK(group, name)                                                                             \
+    static void benchmark_##group##_##name(BenchmarkState& state);                                             \
+    [[maybe_unused]] static const bool registered_##group##_##name =                                           \
+            Benchmarks::add(#group "." #name, &benchmark_##group##_##name);                                    \
+    static void benchmark_##group##_##name(BenchmarkState& state)
@@ -0,0 +1,89 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal benchmarks
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <config.h>
+
+#include "model/Layer.h"
+#include "model/Stroke.h"
+#include "util/serializing/BinObjectEncoding.h"
+#include "util/serializing/ObjectInputStream.h"
+#include "util/serializing/ObjectOutputStream.h"
+
+#include "Benchmark.h"
+#include "SyntheticData.h"
+
+namespace {
+constexpr size_t STROKES = 500;
+constexpr size_t POINTS_PER_STROKE = 200;
+
+/**
+ * Serializes the elements like ClipboardHandler::copy, without the EditSelection
+ */
+auto copy(const std::vector<Element*>& elements) -> std::string {
+    ObjectOutputStream out(new BinObjectEncoding);
+    out.writeString(PROJECT_STRING);
+    out.writeInt(static_cast<int>(elements.size()));
+    for (Element* e: elements) { e->serialize(out); }
+    auto str = out.getStr();
+    return {str->str, str->len};
+}
+
+/**
+ * Reads the elements like Control::clipboardPasteXournal
+ */
+auto paste(const std::string& data) -> std::vector<std::unique_ptr<Element>> {
+    ObjectInputStream in;
+    in.read(data.c_str(), static_cast<int>(data.size()));
+    in.readString();
+
+    std::vector<std::unique_ptr<Element>> elements;
+    int count = in.readInt();
+    for (int i = 0; i < count; i++) {
+        if (in.getNextObjectName() != "Stroke") {
+            break;
+        }
+        auto element = std::make_unique<Stroke>();
+        element->readSerialized(in);
+        elements.push_back(std::move(element));
+    }
+    return elements;
+}
+}  // namespace
+
+XOJ_BENCHMARK(Clipboard, copy) {
+    SyntheticData data;
+    Layer layer;
+    data.fillLayer(&layer, STROKES, POINTS_PER_STROKE);
+
+    std::string serialized = copy(layer.getElements());
+    state.setBytesPerCall(serialized.size());
+    state.measure([&]() {
+        std::string str = copy(layer.getElements());
+        BenchmarkState::keep(str);
+    });
+}
+
+XOJ_BENCHMARK(Clipboard, paste) {
+    SyntheticData data;
+    Layer layer;
+    data.fillLayer(&layer, STROKES, POINTS_PER_STROKE);
+
+    std::string serialized = copy(layer.getElements());
+    state.setBytesPerCall(serialized.size());
+    state.measure([&]() {
+        auto elements = paste(serialized);
+        BenchmarkState::keep(elements);
+    });
+}
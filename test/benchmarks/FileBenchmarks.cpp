@@ -0,0 +1,68 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal benchmarks
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <iostream>
+
+#include "control/xojfile/LoadHandler.h"
+#include "control/xojfile/SaveHandler.h"
+#include "model/Document.h"
+
+#include "Benchmark.h"
+#include "SyntheticData.h"
+#include "filesystem.h"
+
+namespace {
+constexpr size_t PAGES = 20;
+constexpr size_t STROKES_PER_PAGE = 300;
+constexpr size_t POINTS_PER_STROKE = 60;
+
+auto tmpFile(const char* name) -> fs::path { return fs::temp_directory_path() / name; }
+}  // namespace
+
+XOJ_BENCHMARK(File, loadXoj) {
+    auto filepath = tmpFile("xournalpp-benchmark-load.xoj");
+    SyntheticData data;
+    size_t size = data.writeDocument(filepath, PAGES, STROKES_PER_PAGE, POINTS_PER_STROKE);
+
+    state.setBytesPerCall(size);
+    state.measure([&]() {
+        LoadHandler handler;
+        Document* doc = handler.loadDocument(filepath);
+        if (doc == nullptr) {
+            std::cerr << "Could not load " << filepath.u8string() << ": " << handler.getLastError() << std::endl;
+        }
+        BenchmarkState::keep(doc);
+    });
+    fs::remove(filepath);
+}
+
+XOJ_BENCHMARK(File, saveXopp) {
+    auto inputPath = tmpFile("xournalpp-benchmark-save.xoj");
+    auto outputPath = tmpFile("xournalpp-benchmark-save.xopp");
+    SyntheticData data;
+    data.writeDocument(inputPath, PAGES, STROKES_PER_PAGE, POINTS_PER_STROKE);
+
+    LoadHandler handler;
+    Document* doc = handler.loadDocument(inputPath);
+    fs::remove(inputPath);
+    if (doc == nullptr) {
+        std::cerr << "Could not load " << inputPath.u8string() << ": " << handler.getLastError() << std::endl;
+        return;
+    }
+
+    state.setItemsPerCall(PAGES * STROKES_PER_PAGE);
+    state.measure([&]() {
+        SaveHandler h;
+        h.prepareSave(doc);
+        h.saveTo(outputPath);
+    });
+    fs::remove(outputPath);
+}
@@ -0,0 +1,165 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal benchmarks
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include <cairo.h>
+
+#include "control/PdfCache.h"
+#include "model/XojPage.h"
+#include "pdf/base/XojPdfPage.h"
+#include "view/DocumentView.h"
+
+#include "Benchmark.h"
+#include "SyntheticData.h"
+
+namespace {
+constexpr double ZOOM = 2;
+constexpr int TILE_SIZE = 256;
+
+/**
+ * A PDF page which paints lines of "text", so the benchmarks do not need a PDF file
+ */
+class SyntheticPdfPage: public XojPdfPage {
+public:
+    explicit SyntheticPdfPage(int pageId): pageId(pageId) {}
+
+    double getWidth() override { return SyntheticData::PAGE_WIDTH; }
+    double getHeight() override { return SyntheticData::PAGE_HEIGHT; }
+
+    void render(cairo_t* cr, bool forPrinting) override {
+        cairo_set_source_rgb(cr, 1, 1, 1);
+        cairo_paint(cr);
+        cairo_set_source_rgb(cr, 0.1, 0.1, 0.1);
+        for (double y = 60; y < getHeight() - 60; y += 14) {
+            for (double x = 60; x < getWidth() - 60; x += 24) { cairo_rectangle(cr, x, y, 20, 9); }
+        }
+        cairo_fill(cr);
+    }
+
+    std::vector<XojPdfRectangle> findText(std::string& text) override { return {}; }
+    std::string selectText(const XojPdfRectangle& rect, XojPdfPageSelectionStyle style) override { return {}; }
+    cairo_region_t* selectTextRegion(const XojPdfRectangle& rect, XojPdfPageSelectionStyle style) override {
+        return cairo_region_create();
+    }
+    TextSelection selectTextLines(const XojPdfRectangle& rect, XojPdfPageSelectionStyle style) override {
+        return {cairo_region_create(), {}};
+    }
+    int getPageId() override { return this->pageId; }
+
+private:
+    int pageId;
+};
+
+/**
+ * A surface for the whole page at the zoom, as used by the page buffers
+ */
+auto createPageSurface() -> cairo_surface_t* {
+    return cairo_image_surface_create(CAIRO_FORMAT_ARGB32,
+                                      static_cast<int>(std::ceil(SyntheticData::PAGE_WIDTH * ZOOM)),
+                                      static_cast<int>(std::ceil(SyntheticData::PAGE_HEIGHT * ZOOM)));
+}
+}  // namespace
+
+XOJ_BENCHMARK(DocumentView, drawDensePage) {
+    SyntheticData data;
+    PageRef page = data.createPage(5000, 60);
+    cairo_surface_t* surface = createPageSurface();
+    DocumentView view;
+
+    state.setItemsPerCall(5000);
+    state.measure([&]() {
+        cairo_t* cr = cairo_create(surface);
+        cairo_scale(cr, ZOOM, ZOOM);
+        view.drawPage(page, cr, true);
+        cairo_destroy(cr);
+        cairo_surface_flush(surface);
+    });
+    cairo_surface_destroy(surface);
+}
+
+/**
+ * One tile of the page, as rendered by the RenderJob after a small change
+ */
+XOJ_BENCHMARK(DocumentView, drawDensePageTile) {
+    SyntheticData data;
+    PageRef page = data.createPage(5000, 60);
+    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, TILE_SIZE, TILE_SIZE);
+    DocumentView view;
+
+    // A tile in the middle of the page, in page coordinates
+    double size = TILE_SIZE / ZOOM;
+    double x = SyntheticData::PAGE_WIDTH / 2 - size / 2;
+    double y = SyntheticData::PAGE_HEIGHT / 2 - size / 2;
+
+    state.measure([&]() {
+        cairo_t* cr = cairo_create(surface);
+        cairo_scale(cr, ZOOM, ZOOM);
+        cairo_translate(cr, -x, -y);
+        cairo_rectangle(cr, x, y, size, size);
+        cairo_clip(cr);
+        view.limitArea(x, y, size, size);
+        view.drawPage(page, cr, true);
+        cairo_destroy(cr);
+        cairo_surface_flush(surface);
+    });
+    cairo_surface_destroy(surface);
+}
+
+/**
+ * Painting a PDF page which is in the cache, as done on each redraw of a PDF background
+ */
+XOJ_BENCHMARK(PdfCache, renderHit) {
+    PdfCache cache(10, 256 * 1024 * 1024);
+    XojPdfPageSPtr pdfPage = std::make_shared<SyntheticPdfPage>(0);
+    cairo_surface_t* surface = createPageSurface();
+
+    auto render = [&]() {
+        cairo_t* cr = cairo_create(surface);
+        cairo_scale(cr, ZOOM, ZOOM);
+        cache.render(cr, pdfPage, ZOOM);
+        cairo_destroy(cr);
+    };
+    // Fills the cache
+    render();
+
+    state.measure(render);
+    cairo_surface_destroy(surface);
+}
+
+/**
+ * Lookups of the cached pages in turn, as while scrolling through a PDF. The pages are drawn to a small surface,
+ * so the lookup and the bookkeeping of the cache are measured rather than the painting.
+ */
+XOJ_BENCHMARK(PdfCache, lookupManyPages) {
+    constexpr int PAGES = 8;
+    PdfCache cache(PAGES, 256 * 1024 * 1024);
+    std::vector<XojPdfPageSPtr> pdfPages;
+    for (int i = 0; i < PAGES; i++) { pdfPages.push_back(std::make_shared<SyntheticPdfPage>(i)); }
+    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 16, 16);
+
+    auto render = [&]() {
+        for (auto& pdfPage: pdfPages) {
+            cairo_t* cr = cairo_create(surface);
+            cairo_scale(cr, ZOOM, ZOOM);
+            cache.render(cr, pdfPage, ZOOM);
+            cairo_destroy(cr);
+        }
+    };
+    // Fills the cache
+    render();
+
+    state.setItemsPerCall(PAGES);
+    state.measure(render);
+    cairo_surface_destroy(surface);
+}
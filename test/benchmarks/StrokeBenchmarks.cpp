@@ -0,0 +1,180 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal benchmarks
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <cmath>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "control/shaperecognizer/ShapeRecognizer.h"
+#include "model/Layer.h"
+#include "model/Point.h"
+#include "model/Stroke.h"
+#include "model/eraser/ErasableStroke.h"
+#include "util/Range.h"
+#include "util/Rectangle.h"
+
+#include "Benchmark.h"
+#include "SyntheticData.h"
+
+namespace {
+constexpr double HALF_ERASER_SIZE = 5;
+
+/**
+ * Eraser positions in a zigzag over the page
+ */
+auto eraserPath(size_t count) -> std::vector<Point> {
+    std::vector<Point> path;
+    for (size_t i = 0; i < count; i++) {
+        double t = static_cast<double>(i) / static_cast<double>(count);
+        path.emplace_back(40 + t * (SyntheticData::PAGE_WIDTH - 80),
+                          SyntheticData::PAGE_HEIGHT / 2 + 300 * std::sin(t * 6 * M_PI));
+    }
+    return path;
+}
+
+/**
+ * A stroke along the polygon, with some noise, as drawn by hand
+ */
+auto polygonStroke(SyntheticData& data, const std::vector<Point>& corners, size_t pointsPerSide) -> Stroke* {
+    std::normal_distribution<double> noise(0, 0.4);
+    auto* stroke = new Stroke();
+    stroke->setWidth(1.41);
+    for (size_t c = 0; c + 1 < corners.size(); c++) {
+        for (size_t i = 0; i < pointsPerSide; i++) {
+            double t = static_cast<double>(i) / static_cast<double>(pointsPerSide);
+            stroke->addPoint(Point(corners[c].x + t * (corners[c + 1].x - corners[c].x) + noise(data.getRandom()),
+                                   corners[c].y + t * (corners[c + 1].y - corners[c].y) + noise(data.getRandom())));
+        }
+    }
+    stroke->addPoint(corners.back());
+    return stroke;
+}
+
+auto recognizerInput(SyntheticData& data) -> std::vector<std::unique_ptr<Stroke>> {
+    std::vector<std::unique_ptr<Stroke>> strokes;
+    // Rectangle
+    strokes.emplace_back(polygonStroke(data, {{100, 100}, {300, 100}, {300, 250}, {100, 250}, {100, 100}}, 40));
+    // Line
+    strokes.emplace_back(polygonStroke(data, {{100, 300}, {400, 310}}, 120));
+    // Triangle
+    strokes.emplace_back(polygonStroke(data, {{100, 500}, {250, 350}, {400, 500}, {100, 500}}, 50));
+    // Circle
+    auto* circle = new Stroke();
+    for (int i = 0; i <= 150; i++) {
+        double angle = 2 * M_PI * i / 150;
+        circle->addPoint(Point(300 + 80 * std::cos(angle), 600 + 80 * std::sin(angle)));
+    }
+    strokes.emplace_back(circle);
+    // Handwriting, which is not recognized
+    for (int i = 0; i < 4; i++) { strokes.emplace_back(data.createStroke(100, 700 + 20 * i, 150, false)); }
+    return strokes;
+}
+}  // namespace
+
+XOJ_BENCHMARK(Stroke, intersects) {
+    SyntheticData data;
+    std::unique_ptr<Stroke> stroke(data.createStroke(100, 400, 10000, true));
+
+    std::uniform_real_distribution<double> x(stroke->getX(), stroke->getX() + stroke->getElementWidth());
+    std::uniform_real_distribution<double> y(stroke->getY(), stroke->getY() + stroke->getElementHeight());
+    std::vector<Point> queries;
+    for (int i = 0; i < 1000; i++) { queries.emplace_back(x(data.getRandom()), y(data.getRandom())); }
+
+    state.setItemsPerCall(queries.size());
+    state.measure([&]() {
+        size_t hits = 0;
+        for (const Point& p: queries) {
+            double gap = 0;
+            hits += stroke->intersects(p.x, p.y, HALF_ERASER_SIZE, &gap);
+        }
+        BenchmarkState::keep(hits);
+    });
+}
+
+/**
+ * The search of EraseHandler::erase for the eraser "Delete stroke", without removing the strokes
+ */
+XOJ_BENCHMARK(Eraser, deleteStrokePass) {
+    SyntheticData data;
+    Layer layer;
+    data.fillLayer(&layer, 3000, 60);
+    std::vector<Point> path = eraserPath(500);
+
+    state.setItemsPerCall(path.size());
+    state.measure([&]() {
+        size_t hits = 0;
+        for (const Point& p: path) {
+            xoj::util::Rectangle<double> area(p.x - HALF_ERASER_SIZE - 1, p.y - HALF_ERASER_SIZE - 1,
+                                              2 * HALF_ERASER_SIZE + 2, 2 * HALF_ERASER_SIZE + 2);
+            for (Element* e: layer.getElementsInArea(area)) {
+                if (e->getType() == ELEMENT_STROKE && e->intersectsArea(area.x, area.y, area.width, area.height) &&
+                    static_cast<Stroke*>(e)->intersects(p.x, p.y, HALF_ERASER_SIZE)) {
+                    hits++;
+                }
+            }
+        }
+        BenchmarkState::keep(hits);
+    });
+}
+
+/**
+ * The standard eraser as done by EraseHandler: the hit strokes are split by their ErasableStroke,
+ * which are converted to the resulting strokes at the end
+ */
+XOJ_BENCHMARK(Eraser, standardPass) {
+    SyntheticData data;
+    Layer layer;
+    data.fillLayer(&layer, 3000, 60);
+    std::vector<Point> path = eraserPath(500);
+
+    state.setItemsPerCall(path.size());
+    state.measure([&]() {
+        std::map<Stroke*, std::unique_ptr<ErasableStroke>> erasable;
+        Range range(0, 0);
+        for (const Point& p: path) {
+            xoj::util::Rectangle<double> area(p.x - HALF_ERASER_SIZE - 1, p.y - HALF_ERASER_SIZE - 1,
+                                              2 * HALF_ERASER_SIZE + 2, 2 * HALF_ERASER_SIZE + 2);
+            for (Element* e: layer.getElementsInArea(area)) {
+                if (e->getType() != ELEMENT_STROKE || !e->intersectsArea(area.x, area.y, area.width, area.height)) {
+                    continue;
+                }
+                auto* s = static_cast<Stroke*>(e);
+                if (!s->intersects(p.x, p.y, HALF_ERASER_SIZE)) {
+                    continue;
+                }
+                auto& eraser = erasable[s];
+                if (!eraser) {
+                    eraser = std::make_unique<ErasableStroke>(s);
+                }
+                eraser->erase(p.x, p.y, HALF_ERASER_SIZE, &range);
+            }
+        }
+        size_t parts = 0;
+        for (auto& [stroke, eraser]: erasable) { parts += eraser->getStroke(stroke).size(); }
+        BenchmarkState::keep(parts);
+    });
+}
+
+XOJ_BENCHMARK(ShapeRecognizer, recognizePatterns) {
+    SyntheticData data;
+    std::vector<std::unique_ptr<Stroke>> strokes = recognizerInput(data);
+
+    state.setItemsPerCall(strokes.size());
+    state.measure([&]() {
+        for (auto& stroke: strokes) {
+            // As in StrokeHandler, each stroke is recognized by a new recognizer
+            ShapeRecognizer reco;
+            std::unique_ptr<Stroke> recognized(reco.recognizePatterns(stroke.get()));
+            BenchmarkState::keep(recognized);
+        }
+    });
+}
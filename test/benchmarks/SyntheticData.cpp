@@ -0,0 +1,102 @@
+#include "SyntheticData.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <memory>
+
+#include "model/Layer.h"
+#include "model/Point.h"
+#include "model/Stroke.h"
+#include "model/XojPage.h"
+
+SyntheticData::SyntheticData(): random(42) {}
+
+auto SyntheticData::getRandom() -> std::mt19937& { return this->random; }
+
+auto SyntheticData::createStroke(double x, double y, size_t pointCount, bool pressure) -> Stroke* {
+    std::uniform_real_distribution<double> turn(-0.6, 0.6);
+    std::uniform_real_distribution<double> step(0.4, 1.2);
+    std::uniform_real_distribution<double> force(0.6, 1.4);
+
+    auto* stroke = new Stroke();
+    stroke->setWidth(1.41);
+    stroke->setColor(Color(0x000000U));
+
+    double angle = 0;
+    for (size_t i = 0; i < pointCount; i++) {
+        if (pressure) {
+            stroke->addPoint(Point(x, y, stroke->getWidth() * force(this->random)));
+        } else {
+            stroke->addPoint(Point(x, y));
+        }
+        // Mostly to the right, like writing
+        angle = std::clamp(angle + turn(this->random), -2.5, 2.5);
+        double length = step(this->random);
+        x += length * std::cos(angle);
+        y += length * std::sin(angle);
+    }
+    return stroke;
+}
+
+void SyntheticData::fillLayer(Layer* layer, size_t strokeCount, size_t pointCount) {
+    constexpr double MARGIN = 40;
+    constexpr double LINE_HEIGHT = 24;
+    constexpr double WORD_WIDTH = 30;
+
+    std::uniform_real_distribution<double> jitter(-3, 3);
+    double x = MARGIN;
+    double y = MARGIN;
+
+    for (size_t i = 0; i < strokeCount; i++) {
+        Stroke* stroke = createStroke(x + jitter(this->random), y + jitter(this->random), pointCount, i % 3 != 0);
+        if (i % 10 == 9) {
+            stroke->setToolType(STROKE_TOOL_HIGHLIGHTER);
+            stroke->setWidth(8.5);
+            stroke->setColor(Color(0xffff00U));
+        }
+        layer->addElement(stroke);
+
+        x += WORD_WIDTH;
+        if (x > PAGE_WIDTH - MARGIN) {
+            x = MARGIN;
+            y += LINE_HEIGHT;
+        }
+        // Dense pages are written over again, as with annotations
+        if (y > PAGE_HEIGHT - MARGIN) {
+            y = MARGIN + LINE_HEIGHT / 2;
+        }
+    }
+}
+
+auto SyntheticData::createPage(size_t strokeCount, size_t pointCount) -> PageRef {
+    auto page = std::make_shared<XojPage>(PAGE_WIDTH, PAGE_HEIGHT);
+    auto* layer = new Layer();
+    fillLayer(layer, strokeCount, pointCount);
+    page->addLayer(layer);
+    return page;
+}
+
+auto SyntheticData::writeDocument(const fs::path& filepath, size_t pageCount, size_t strokeCount, size_t pointCount)
+        -> size_t {
+    std::ofstream out(filepath);
+    out << "<?xml version=\"1.0\" standalone=\"no\"?>\n<xournal creator=\"Xournal++ 1.0.1\" fileversion=\"4\">\n";
+    for (size_t page = 0; page < pageCount; page++) {
+        out << "<page width=\"" << PAGE_WIDTH << "\" height=\"" << PAGE_HEIGHT << "\">\n"
+            << "<background type=\"solid\" color=\"#ffffffff\" style=\"lined\"/>\n<layer>\n";
+        for (size_t i = 0; i < strokeCount; i++) {
+            std::unique_ptr<Stroke> stroke(createStroke(40, 40 + static_cast<double>(i % 30) * 24, pointCount, true));
+            out << "<stroke tool=\"pen\" color=\"#000000ff\" width=\"" << stroke->getWidth();
+            for (int j = 0; j < stroke->getPointCount() - 1; j++) { out << " " << stroke->getPoint(j).z; }
+            out << "\">";
+            for (int j = 0; j < stroke->getPointCount(); j++) {
+                Point p = stroke->getPoint(j);
+                out << (j ? " " : "") << p.x << " " << p.y;
+            }
+            out << "\n</stroke>\n";
+        }
+        out << "</layer>\n</page>\n";
+    }
+    out << "</xournal>\n";
+    return static_cast<size_t>(out.tellp());
+}
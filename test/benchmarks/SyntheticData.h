@@ -0,0 +1,63 @@
+/*
+ * Xournal++
+ *
+ * Synthetic documents for the benchmarks
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <random>
+
+#include "model/PageRef.h"
+
+#include "filesystem.h"
+
+class Layer;
+class Stroke;
+
+/**
+ * Generates handwriting-like content. The generator has a fixed seed, so every run (and every commit which is
+ * compared) works on the same data.
+ */
+class SyntheticData {
+public:
+    static constexpr double PAGE_WIDTH = 595.27;
+    static constexpr double PAGE_HEIGHT = 841.89;
+
+public:
+    SyntheticData();
+
+public:
+    /**
+     * A smooth random walk starting at (x, y), like a handwritten word
+     */
+    Stroke* createStroke(double x, double y, size_t pointCount, bool pressure);
+
+    /**
+     * Fills the layer with strokes in lines of text, every tenth stroke is a highlighter stroke
+     */
+    void fillLayer(Layer* layer, size_t strokeCount, size_t pointCount);
+
+    /**
+     * A page with one layer filled by fillLayer()
+     */
+    PageRef createPage(size_t strokeCount, size_t pointCount);
+
+    /**
+     * Writes an uncompressed .xoj file with stroke pages
+     *
+     * @return The size of the file in bytes
+     */
+    size_t writeDocument(const fs::path& filepath, size_t pageCount, size_t strokeCount, size_t pointCount);
+
+    std::mt19937& getRandom();
+
+private:
+    std::mt19937 random;
+};
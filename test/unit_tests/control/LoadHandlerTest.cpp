@@ -9,14 +9,20 @@
  * @license GNU GPLv2 or later
  */
 
+#include <chrono>
 #include <cmath>
+#include <fstream>
 #include <iostream>
+#include <iterator>
+#include <memory>
 
 #include <config-test.h>
 #include <gtest/gtest.h>
 
+#include "control/jobs/Scheduler.h"
 #include "control/xojfile/LoadHandler.h"
 #include "control/xojfile/SaveHandler.h"
+#include "control/xojfile/SavedPageCache.h"
 #include "util/PathUtil.h"
 
 #include "filesystem.h"
@@ -325,6 +331,321 @@ TEST(ControlLoadHandler, testTextZipped) {
     EXPECT_EQ(Color(0x00f000U), t3->getColor());
 }
 
+/**
+ * Writes an uncompressed document with pageCount pages of width 100 + page index, each with one layer of strokes.
+ * Stroke i has the points (i + j / 8, j) and the pressures 1 + j / 16.
+ *
+ * @return The size of the document in bytes
+ */
+static size_t writeStrokeDocument(fs::path const& filepath, int pageCount, int strokeCount, int pointCount) {
+    std::ofstream out(filepath);
+    out << "<?xml version=\"1.0\" standalone=\"no\"?>\n<xournal creator=\"Xournal++ 1.0.1\" fileversion=\"4\">\n";
+    for (int page = 0; page < pageCount; page++) {
+        out << "<page width=\"" << 100 + page << "\" height=\"841.89\">\n<background type=\"solid\" "
+            << "color=\"#ffffffff\" style=\"plain\"/>\n<layer>\n";
+        for (int i = 0; i < strokeCount; i++) {
+            out << "<stroke tool=\"pen\" color=\"#000000ff\" width=\"1.41";
+            for (int j = 0; j < pointCount - 1; j++) { out << " " << 1 + j / 16.0; }
+            out << "\">";
+            for (int j = 0; j < pointCount; j++) { out << (j ? " " : "") << i + j / 8.0 << " " << j; }
+            out << "\n</stroke>\n";
+        }
+        out << "</layer>\n</page>\n";
+    }
+    out << "</xournal>\n";
+    return static_cast<size_t>(out.tellp());
+}
+
+TEST(ControlLoadHandler, testStrokeCoordinates) {
+    auto filepath = fs::temp_directory_path() / "xournalpp-test-strokes.xoj";
+    writeStrokeDocument(filepath, 1, 3, 17);
+
+    LoadHandler handler;
+    Document* doc = handler.loadDocument(filepath);
+    fs::remove(filepath);
+    ASSERT_NE(nullptr, doc);
+
+    Layer* layer = (*doc->getPage(0)->getLayers())[0];
+    ASSERT_EQ(3U, layer->getElements().size());
+    for (int i = 0; i < 3; i++) {
+        auto* stroke = dynamic_cast<Stroke*>(layer->getElements()[static_cast<size_t>(i)]);
+        ASSERT_NE(nullptr, stroke);
+        EXPECT_DOUBLE_EQ(1.41, stroke->getWidth());
+        ASSERT_EQ(17, stroke->getPointCount());
+        for (int j = 0; j < 17; j++) {
+            Point p = stroke->getPoint(j);
+            EXPECT_DOUBLE_EQ(i + j / 8.0, p.x);
+            EXPECT_DOUBLE_EQ(j, p.y);
+            if (j < 16) {
+                EXPECT_DOUBLE_EQ(1 + j / 16.0, p.z);
+            }
+        }
+    }
+}
+
+static void checkManyPages(Document* doc) {
+    ASSERT_NE(nullptr, doc);
+    ASSERT_EQ(50U, doc->getPageCount());
+    for (size_t i = 0; i < 50; i++) {
+        PageRef page = doc->getPage(i);
+        EXPECT_DOUBLE_EQ(100.0 + static_cast<double>(i), page->getWidth());
+        ASSERT_EQ(1U, page->getLayerCount());
+        EXPECT_EQ(4U, (*page->getLayers())[0]->getElements().size());
+    }
+}
+
+TEST(ControlLoadHandler, testManyPages) {
+    // Large enough to be split into pages parsed in parallel
+    auto filepath = fs::temp_directory_path() / "xournalpp-test-pages.xoj";
+    writeStrokeDocument(filepath, 50, 4, 9);
+
+    Scheduler scheduler;
+    scheduler.setWorkerCount(4);
+    scheduler.start();
+
+    LoadHandler handler;
+    handler.setScheduler(&scheduler);
+    Document* doc = handler.loadDocument(filepath);
+    fs::remove(filepath);
+    checkManyPages(doc);
+}
+
+TEST(ControlLoadHandler, testManyPagesWithComment) {
+    auto filepath = fs::temp_directory_path() / "xournalpp-test-pages-comment.xoj";
+    writeStrokeDocument(filepath, 50, 4, 9);
+
+    // The pages after the comment cannot be split off safely, they are parsed in order with the rest
+    string content;
+    {
+        std::ifstream in(filepath);
+        content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    size_t pos = 0;
+    for (int i = 0; i < 25; i++) { pos = content.find("<page ", pos + 1); }
+    content.insert(pos, "<!-- <page> -->\n");
+    std::ofstream(filepath) << content;
+
+    LoadHandler handler;
+    Document* doc = handler.loadDocument(filepath);
+    fs::remove(filepath);
+    checkManyPages(doc);
+}
+
+TEST(ControlLoadHandler, testLazyPages) {
+    auto filepath = fs::temp_directory_path() / "xournalpp-test-lazy.xoj";
+    writeStrokeDocument(filepath, 5, 3, 9);
+
+    LoadHandler handler;
+    handler.setLazyPageLoading(true);
+    Document* doc = handler.loadDocument(filepath);
+    fs::remove(filepath);
+    ASSERT_NE(nullptr, doc);
+
+    ASSERT_EQ(5U, doc->getPageCount());
+    for (size_t i = 0; i < 5; i++) {
+        PageRef page = doc->getPage(i);
+        EXPECT_FALSE(page->isContentLoaded());
+        EXPECT_DOUBLE_EQ(100.0 + static_cast<double>(i), page->getWidth());
+        EXPECT_EQ(PageTypeFormat::Plain, page->getBackgroundType().format);
+    }
+
+    // The layers are parsed on first access, also after the file is gone
+    PageRef page = doc->getPage(3);
+    ASSERT_EQ(1U, page->getLayerCount());
+    EXPECT_TRUE(page->isContentLoaded());
+    EXPECT_FALSE(doc->getPage(2)->isContentLoaded());
+
+    const auto& elements = (*page->getLayers())[0]->getElements();
+    ASSERT_EQ(3U, elements.size());
+    auto* stroke = dynamic_cast<Stroke*>(elements[2]);
+    ASSERT_NE(nullptr, stroke);
+    ASSERT_EQ(9, stroke->getPointCount());
+    EXPECT_DOUBLE_EQ(2 + 8 / 8.0, stroke->getPoint(8).x);
+}
+
+TEST(ControlLoadHandler, testLazyPagesBroken) {
+    auto filepath = fs::temp_directory_path() / "xournalpp-test-lazy-broken.xoj";
+    auto savePath = fs::temp_directory_path() / "xournalpp-test-lazy-broken-save.xoj";
+    auto writeDocument = [&](const char* secondLayer) {
+        const char* firstLayer = "<layer><stroke tool=\"pen\" color=\"#000000ff\" width=\"1\">1 1 2 2</stroke></layer>";
+        std::ofstream out(filepath);
+        out << "<?xml version=\"1.0\" standalone=\"no\"?>\n<xournal creator=\"Xournal++ 1.0.1\" fileversion=\"4\">\n";
+        for (const char* layer: {firstLayer, secondLayer}) {
+            out << "<page width=\"100\" height=\"100\">\n<background type=\"solid\" color=\"#ffffffff\" "
+                << "style=\"plain\"/>\n" << layer << "\n</page>\n";
+        }
+        out << "</xournal>\n";
+    };
+
+    // Malformed XML is reported when the document is opened, as without lazy loading
+    writeDocument("<layer><stroke tool=\"pen\" color=\"#000000ff\" width=\"1\">1 1 2 2</layer>");
+    {
+        LoadHandler handler;
+        handler.setLazyPageLoading(true);
+        EXPECT_EQ(nullptr, handler.loadDocument(filepath));
+        EXPECT_NE("", handler.getLastError());
+    }
+
+    // Invalid content is only found when the page is loaded, the page must not be saved then
+    writeDocument("<layer><stroke tool=\"pen\" color=\"#000000ff\" width=\"broken\">1 1 2 2</stroke></layer>");
+    LoadHandler handler;
+    handler.setLazyPageLoading(true);
+    Document* doc = handler.loadDocument(filepath);
+    fs::remove(filepath);
+    ASSERT_NE(nullptr, doc);
+    EXPECT_FALSE(doc->getPage(0)->hasContentError());
+
+    SaveHandler h;
+    h.prepareSave(doc);
+    h.saveTo(savePath);
+    EXPECT_NE("", h.getErrorMessage());
+    EXPECT_FALSE(fs::exists(savePath));
+    EXPECT_TRUE(doc->getPage(1)->hasContentError());
+    EXPECT_FALSE(doc->getPage(0)->hasContentError());
+}
+
+TEST(ControlLoadHandler, testIncrementalSave) {
+    auto filepath = fs::temp_directory_path() / "xournalpp-test-incremental.xoj";
+    writeStrokeDocument(filepath, 4, 3, 9);
+
+    LoadHandler handler;
+    Document* doc = handler.loadDocument(filepath);
+    ASSERT_NE(nullptr, doc);
+
+    SavedPageCache cache;
+    auto save = [&]() {
+        SaveHandler h;
+        h.setPageCache(&cache);
+        h.prepareSave(doc);
+        h.saveTo(filepath);
+        EXPECT_EQ("", h.getErrorMessage());
+    };
+    save();
+
+    // The changes are detected from the model, the other pages are taken from the cache
+    doc->getPage(1)->setSize(300, 400);
+    (*doc->getPage(2)->getLayers())[0]->setName("Renamed");
+    EXPECT_NE(nullptr, cache.get(doc->getPage(0), doc->getPage(0)->getContentRevision()));
+    EXPECT_EQ(nullptr, cache.get(doc->getPage(1), doc->getPage(1)->getContentRevision()));
+    EXPECT_EQ(nullptr, cache.get(doc->getPage(2), doc->getPage(2)->getContentRevision()));
+    save();
+
+    LoadHandler handler2;
+    Document* doc2 = handler2.loadDocument(filepath);
+    fs::remove(filepath);
+    ASSERT_NE(nullptr, doc2);
+
+    ASSERT_EQ(4U, doc2->getPageCount());
+    EXPECT_DOUBLE_EQ(100.0, doc2->getPage(0)->getWidth());
+    EXPECT_DOUBLE_EQ(300.0, doc2->getPage(1)->getWidth());
+    EXPECT_DOUBLE_EQ(102.0, doc2->getPage(2)->getWidth());
+    EXPECT_EQ("Renamed", (*doc2->getPage(2)->getLayers())[0]->getName());
+    EXPECT_DOUBLE_EQ(103.0, doc2->getPage(3)->getWidth());
+    for (size_t i = 0; i < 4; i++) { EXPECT_EQ(3U, (*doc2->getPage(i)->getLayers())[0]->getElements().size()); }
+}
+
+TEST(ControlLoadHandler, testSnapshotSave) {
+    auto filepath = fs::temp_directory_path() / "xournalpp-test-snapshot.xoj";
+    writeStrokeDocument(filepath, 3, 3, 9);
+
+    LoadHandler handler;
+    handler.setLazyPageLoading(true);
+    Document* doc = handler.loadDocument(filepath);
+    ASSERT_NE(nullptr, doc);
+    doc->getPage(0)->ensureContentLoaded();
+
+    SavedPageCache cache;
+    auto check = [&](double width, size_t elementCount) {
+        LoadHandler loadHandler;
+        Document* saved = loadHandler.loadDocument(filepath);
+        ASSERT_NE(nullptr, saved);
+        ASSERT_EQ(3U, saved->getPageCount());
+        EXPECT_DOUBLE_EQ(width, saved->getPage(1)->getWidth());
+        EXPECT_EQ(elementCount, (*saved->getPage(0)->getLayers())[0]->getElements().size());
+    };
+
+    // Changes after the snapshot was taken are neither saved nor stored in the page cache
+    SaveHandler h;
+    h.setPageCache(&cache);
+    std::unique_ptr<Document> snapshot = doc->createSnapshot();
+    h.prepareSave(snapshot.get());
+    EXPECT_TRUE(snapshot->getPage(0)->isContentLoaded());
+    EXPECT_FALSE(snapshot->getPage(1)->isContentLoaded());
+
+    Layer* layer = (*doc->getPage(0)->getLayers())[0];
+    layer->removeElement(layer->getElements().back(), true);
+    doc->getPage(1)->setSize(300, 400);
+    h.saveTo(filepath);
+    EXPECT_EQ("", h.getErrorMessage());
+    check(101.0, 3U);
+
+    SaveHandler h2;
+    h2.setPageCache(&cache);
+    snapshot = doc->createSnapshot();
+    h2.prepareSave(snapshot.get());
+    h2.saveTo(filepath);
+    EXPECT_EQ("", h2.getErrorMessage());
+    check(300.0, 2U);
+    fs::remove(filepath);
+}
+
+TEST(ControlLoadHandler, testSnapshotSkipsCachedPages) {
+    auto filepath = fs::temp_directory_path() / "xournalpp-test-snapshot-cached.xoj";
+    writeStrokeDocument(filepath, 3, 3, 9);
+
+    LoadHandler handler;
+    Document* doc = handler.loadDocument(filepath);
+    ASSERT_NE(nullptr, doc);
+
+    SavedPageCache cache;
+    auto save = [&]() {
+        SaveHandler h;
+        h.setPageCache(&cache);
+        std::unique_ptr<Document> snapshot = h.createSnapshot(doc);
+        h.prepareSave(snapshot.get());
+        h.saveTo(filepath);
+        EXPECT_EQ("", h.getErrorMessage());
+        return snapshot;
+    };
+    EXPECT_FALSE(save()->getPage(0)->isContentSkipped());
+
+    // Only the changed page is copied, the others are written from the cache
+    Layer* layer = (*doc->getPage(1)->getLayers())[0];
+    layer->removeElement(layer->getElements().back(), true);
+    std::unique_ptr<Document> snapshot = save();
+    EXPECT_TRUE(snapshot->getPage(0)->isContentSkipped());
+    EXPECT_FALSE(snapshot->getPage(1)->isContentSkipped());
+    EXPECT_TRUE(snapshot->getPage(2)->isContentSkipped());
+
+    LoadHandler loadHandler;
+    Document* saved = loadHandler.loadDocument(filepath);
+    fs::remove(filepath);
+    ASSERT_NE(nullptr, saved);
+    ASSERT_EQ(3U, saved->getPageCount());
+    EXPECT_EQ(3U, (*saved->getPage(0)->getLayers())[0]->getElements().size());
+    EXPECT_EQ(2U, (*saved->getPage(1)->getLayers())[0]->getElements().size());
+    EXPECT_EQ(3U, (*saved->getPage(2)->getLayers())[0]->getElements().size());
+}
+
+#ifdef TEST_CHECK_SPEED
+TEST(ControlLoadHandler, testLoadSpeed) {
+    auto filepath = fs::temp_directory_path() / "xournalpp-test-load-speed.xoj";
+    size_t size = writeStrokeDocument(filepath, 100, 200, 200);
+
+    LoadHandler handler;
+    auto start = std::chrono::steady_clock::now();
+    Document* doc = handler.loadDocument(filepath);
+    std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+    fs::remove(filepath);
+    ASSERT_NE(nullptr, doc);
+
+    double mbPerSecond = static_cast<double>(size) / (1024.0 * 1024.0) / seconds.count();
+    std::cout << "Loaded " << size / 1024 / 1024 << " MB in " << seconds.count() << " s: " << mbPerSecond << " MB/s"
+              << std::endl;
+    RecordProperty("load_mb_per_second", std::to_string(mbPerSecond));
+}
+#endif
+
 TEST(ControlLoadHandler, testLoadStoreLoadDefault) { testLoadStoreLoad(); }
 
 
@@ -0,0 +1,95 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "control/RenderStatistics.h"
+
+TEST(RenderStatistics, testDisabledByDefault) {
+    RenderStatistics& stats = RenderStatistics::getInstance();
+    stats.reset();
+    ASSERT_FALSE(stats.isEnabled());
+
+    {
+        RenderStatistics::Scope scope("render", "RenderJob");
+        EXPECT_FALSE(scope.isActive());
+    }
+    stats.countPdfCache(true);
+    stats.framePainted(RenderStatistics::now(), 100);
+
+    RenderStatistics::Summary summary = stats.getSummary();
+    EXPECT_TRUE(summary.timings.empty());
+    EXPECT_EQ(0, summary.pdfCacheHits);
+    EXPECT_EQ(0, summary.framesPerSecond);
+}
+
+TEST(RenderStatistics, testSummary) {
+    RenderStatistics& stats = RenderStatistics::getInstance();
+    stats.reset();
+    stats.setHudVisible(true);
+
+    stats.addEvent("render", "RenderJob", 0, 300);
+    stats.addEvent("render", "RenderJob", 500, 100);
+    stats.countPdfCache(true);
+    stats.countPdfCache(true);
+    stats.countPdfCache(false);
+    stats.countElements(10, 90);
+
+    int64_t now = RenderStatistics::now();
+    stats.inputReceived();
+    stats.framePainted(now, 2000);
+    // Without new input, the next frame has no latency
+    stats.framePainted(now + 10000, 1000);
+
+    RenderStatistics::Summary summary = stats.getSummary();
+    stats.setHudVisible(false);
+
+    const RenderStatistics::Timing& render = summary.timings["RenderJob"];
+    EXPECT_EQ(2, render.count);
+    EXPECT_EQ(300, render.max);
+    EXPECT_EQ(100, render.last);
+    EXPECT_DOUBLE_EQ(200, render.average());
+
+    EXPECT_EQ(2, summary.timings["Frame"].count);
+    EXPECT_EQ(1, summary.inputLatency.count);
+    EXPECT_GE(summary.inputLatency.last, 2000);
+    EXPECT_EQ(2, summary.framesPerSecond);
+
+    EXPECT_EQ(2, summary.pdfCacheHits);
+    EXPECT_EQ(1, summary.pdfCacheMisses);
+    EXPECT_EQ(10, summary.elementsDrawn);
+    EXPECT_EQ(90, summary.elementsCulled);
+}
+
+TEST(RenderStatistics, testTrace) {
+    RenderStatistics& stats = RenderStatistics::getInstance();
+    stats.reset();
+    stats.startTrace();
+    EXPECT_TRUE(stats.isEnabled());
+
+    {
+        RenderStatistics::Scope scope("render", "RenderJob");
+        ASSERT_TRUE(scope.isActive());
+        scope.addArg("page", 3);
+    }
+
+    std::ostringstream out;
+    stats.writeTrace(out);
+    EXPECT_FALSE(stats.isEnabled());
+
+    std::string json = out.str();
+    EXPECT_EQ(0, json.find("{\"traceEvents\":[\n{\"name\":\"RenderJob\",\"cat\":\"render\",\"ph\":\"X\",\"ts\":"));
+    EXPECT_NE(std::string::npos, json.find("\"pid\":1,\"tid\":1,\"dur\":"));
+    EXPECT_NE(std::string::npos, json.find(",\"args\":{\"page\":3}}\n],\"displayTimeUnit\":\"ms\"}"));
+}
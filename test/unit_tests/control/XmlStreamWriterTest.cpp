@@ -0,0 +1,73 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <string>
+
+#include <glib.h>
+#include <gtest/gtest.h>
+
+#include "control/xml/XmlStreamWriter.h"
+#include "util/OutputStream.h"
+
+TEST(XmlStreamWriter, testElements) {
+    StringOutputStream out;
+    {
+        XmlStreamWriter writer(&out);
+        writer.startElement("layer");
+        writer.attrib("name", std::string{"a \"b\" <c> & d\ne"});
+        writer.startChildren();
+
+        double xs[] = {1.5, -0.25};
+        double ys[] = {2, 1e-9};
+        double pressures[] = {0.5};
+        writer.startElement("stroke");
+        writer.attrib("tool", "pen");
+        writer.attrib("ts", size_t{12});
+        writer.attrib("fill", -1);
+        writer.attrib("width", 1.41, pressures, 1);
+        writer.startContent();
+        writer.coordinates(xs, ys, 2);
+        writer.endElement("stroke");
+
+        writer.startElement("text");
+        writer.startContent();
+        writer.text("1 < 2 & \"3\"");
+        writer.endElement("text");
+
+        writer.startElement("image");
+        writer.endEmptyElement();
+        writer.endElement("layer");
+    }
+
+    EXPECT_EQ("<layer name=\"a &quot;b&quot; &lt;c&gt; &amp; d&#13;e\">\n"
+              "<stroke tool=\"pen\" ts=\"12\" fill=\"-1\" width=\"1.41000000 0.50000000\">"
+              "1.50000000 2.00000000 -0.25000000 0.00000000</stroke>\n"
+              "<text>1 &lt; 2 &amp; \"3\"</text>\n"
+              "<image/>\n"
+              "</layer>\n",
+              out.getString());
+}
+
+TEST(XmlStreamWriter, testBase64) {
+    // Larger than the internal block size and not a multiple of 3
+    std::string data;
+    for (int i = 0; i < 10000; i++) { data.push_back(static_cast<char>(i * 7)); }
+
+    StringOutputStream out;
+    {
+        XmlStreamWriter writer(&out);
+        writer.base64(data.data(), data.size());
+    }
+
+    gchar* expected = g_base64_encode(reinterpret_cast<const guchar*>(data.data()), data.size());
+    EXPECT_EQ(std::string{expected}, out.getString());
+    g_free(expected);
+}
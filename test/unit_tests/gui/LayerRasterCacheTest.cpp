@@ -0,0 +1,143 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <map>
+
+#include <cairo.h>
+#include <gtest/gtest.h>
+
+#include "gui/LayerRasterCache.h"
+
+using xoj::util::Rectangle;
+
+namespace {
+const char BACKGROUND[] = "background";
+const char LAYER1[] = "layer1";
+const char LAYER2[] = "layer2";
+
+struct TestPage {
+    LayerRasterCache::PageState state;
+
+    /**
+     * Complete / partial draws per key
+     */
+    std::map<const void*, int> complete;
+    std::map<const void*, int> partial;
+
+    TestPage() {
+        state.width = 100;
+        state.height = 50;
+        state.layers = {{BACKGROUND, 0, false}, {LAYER1, 0, false}, {LAYER2, 0, true}};
+    }
+
+    bool update(LayerRasterCache& cache, size_t limit = 1024 * 1024) {
+        complete.clear();
+        partial.clear();
+        return cache.update(
+                1, 0, limit, [this]() { return state; },
+                [this](cairo_t*, const void* key, const Rectangle<double>* area) {
+                    (area ? partial : complete)[key]++;
+                });
+    }
+};
+}  // namespace
+
+TEST(LayerRasterCache, testChangedLayersOnly) {
+    LayerCacheBudget budget;
+    LayerRasterCache cache(&budget);
+    TestPage page;
+
+    ASSERT_TRUE(page.update(cache));
+    EXPECT_EQ(3U, page.complete.size());
+    EXPECT_TRUE(cache.isValid(1));
+
+    // Nothing changed
+    cache.pageRerendered();
+    ASSERT_TRUE(page.update(cache));
+    EXPECT_TRUE(page.complete.empty());
+    EXPECT_TRUE(page.partial.empty());
+
+    // Only the changed layer and the layers above it are drawn again
+    page.state.layers[2].revision++;
+    cache.pageRerendered();
+    ASSERT_TRUE(page.update(cache));
+    EXPECT_EQ(0, page.complete[BACKGROUND]);
+    EXPECT_EQ(0, page.complete[LAYER1]);
+    EXPECT_EQ(1, page.complete[LAYER2]);
+
+    page.state.layers[1].revision++;
+    cache.pageRerendered();
+    ASSERT_TRUE(page.update(cache));
+    EXPECT_EQ(1, page.complete[LAYER1]);
+    EXPECT_EQ(1, page.complete[LAYER2]);
+}
+
+TEST(LayerRasterCache, testDamage) {
+    LayerCacheBudget budget;
+    LayerRasterCache cache(&budget);
+    TestPage page;
+    ASSERT_TRUE(page.update(cache));
+
+    // A rectangle is drawn again in the selected layer, unchanged layers below are kept
+    cache.damage(Rectangle<double>(10, 10, 5, 5));
+    ASSERT_TRUE(page.update(cache));
+    EXPECT_TRUE(page.complete.empty());
+    EXPECT_EQ(0, page.partial[LAYER1]);
+    EXPECT_EQ(1, page.partial[LAYER2]);
+
+    // A changed layer below the selected one
+    page.state.layers[1].revision++;
+    cache.damage(Rectangle<double>(10, 10, 5, 5));
+    ASSERT_TRUE(page.update(cache));
+    EXPECT_TRUE(page.complete.empty());
+    EXPECT_EQ(1, page.partial[LAYER1]);
+    EXPECT_EQ(1, page.partial[LAYER2]);
+
+    // Hiding a layer changes the layers above it
+    page.state.layers.erase(page.state.layers.begin() + 1);
+    ASSERT_TRUE(page.update(cache));
+    EXPECT_EQ(1, page.complete[LAYER2]);
+
+    // Too large for the budget
+    page.state.width = 10000;
+    EXPECT_FALSE(page.update(cache));
+    EXPECT_FALSE(cache.isValid(1));
+}
+
+TEST(LayerRasterCache, testSharedBudget) {
+    // Each page needs 3 surfaces of 100 x 50 pixels
+    constexpr size_t pageBytes = 3 * 100 * 50 * 4;
+    LayerCacheBudget budget;
+    LayerRasterCache cache1(&budget);
+    LayerRasterCache cache2(&budget);
+    LayerRasterCache cache3(&budget);
+    TestPage page;
+
+    ASSERT_TRUE(page.update(cache1, 2 * pageBytes));
+    ASSERT_TRUE(page.update(cache2, 2 * pageBytes));
+    EXPECT_EQ(2 * pageBytes, budget.getUsage());
+
+    // The page which was updated least recently is released
+    ASSERT_TRUE(page.update(cache1, 2 * pageBytes));
+    ASSERT_TRUE(page.update(cache3, 2 * pageBytes));
+    EXPECT_EQ(2 * pageBytes, budget.getUsage());
+    EXPECT_TRUE(cache1.isValid(1));
+    EXPECT_FALSE(cache2.isValid(1));
+    EXPECT_TRUE(cache3.isValid(1));
+
+    // A released page is drawn completely again
+    ASSERT_TRUE(page.update(cache2, 2 * pageBytes));
+    EXPECT_EQ(3U, page.complete.size());
+    EXPECT_FALSE(cache1.isValid(1));
+
+    cache3.clear();
+    EXPECT_EQ(pageBytes, budget.getUsage());
+}
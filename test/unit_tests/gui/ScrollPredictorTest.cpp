@@ -0,0 +1,81 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <gtest/gtest.h>
+
+#include "gui/ScrollPredictor.h"
+
+using xoj::util::Rectangle;
+
+namespace {
+const Rectangle<double> VISIBLE(0, 1000, 800, 600);
+}
+
+TEST(ScrollPredictor, testReadingDownByDefault) {
+    ScrollPredictor predictor;
+    Rectangle<double> area = predictor.predict(VISIBLE);
+
+    EXPECT_DOUBLE_EQ(0, area.x);
+    EXPECT_DOUBLE_EQ(1600, area.y);
+    EXPECT_DOUBLE_EQ(800, area.width);
+    EXPECT_DOUBLE_EQ(600, area.height);
+}
+
+TEST(ScrollPredictor, testScrollUp) {
+    ScrollPredictor predictor;
+    predictor.scrolled(0, 1000, 0);
+    predictor.scrolled(0, 990, 100000);
+
+    // Slow scrolling: one viewport ahead
+    Rectangle<double> area = predictor.predict(VISIBLE);
+    EXPECT_DOUBLE_EQ(400, area.y);
+    EXPECT_DOUBLE_EQ(600, area.height);
+}
+
+TEST(ScrollPredictor, testFastScrollLooksFurtherAhead) {
+    ScrollPredictor predictor;
+    predictor.scrolled(0, 0, 0);
+    predictor.scrolled(0, 100, 20000);
+    predictor.scrolled(0, 200, 40000);
+
+    // 5000 px/s
+    EXPECT_DOUBLE_EQ(5000, predictor.getVelocity());
+
+    Rectangle<double> area = predictor.predict(VISIBLE);
+    EXPECT_DOUBLE_EQ(1600, area.y);
+    EXPECT_DOUBLE_EQ(600 * ScrollPredictor::MAX_VIEWPORTS, area.height);
+}
+
+TEST(ScrollPredictor, testHorizontal) {
+    ScrollPredictor predictor;
+    predictor.scrolled(500, 0, 0);
+    predictor.scrolled(300, 10, 100000);
+
+    // 2000 px/s
+    Rectangle<double> area = predictor.predict(VISIBLE);
+    EXPECT_DOUBLE_EQ(-1000, area.x);
+    EXPECT_DOUBLE_EQ(1000, area.y);
+    EXPECT_DOUBLE_EQ(1000, area.width);
+    EXPECT_DOUBLE_EQ(600, area.height);
+}
+
+TEST(ScrollPredictor, testDirectionIsKeptAfterPause) {
+    ScrollPredictor predictor;
+    predictor.scrolled(0, 500, 0);
+    predictor.scrolled(0, 400, 100000);
+
+    // A page flip after a pause: a jump within a long time is slow
+    predictor.scrolled(0, -800, 2100000);
+    EXPECT_DOUBLE_EQ(600, predictor.getVelocity());
+
+    Rectangle<double> area = predictor.predict(VISIBLE);
+    EXPECT_DOUBLE_EQ(400, area.y);
+}
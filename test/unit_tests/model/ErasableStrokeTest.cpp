@@ -0,0 +1,44 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "model/Stroke.h"
+#include "model/eraser/ErasableStroke.h"
+#include "util/Range.h"
+
+TEST(ErasableStroke, testEraseSplitStroke) {
+    Stroke stroke;
+    stroke.addPoint(Point(100, 100));
+    stroke.addPoint(Point(300, 100));
+    ErasableStroke erasable(&stroke);
+
+    // Splits the stroke in the middle
+    std::unique_ptr<Range> range(erasable.erase(200, 100, 5));
+    ASSERT_NE(nullptr, range);
+    EXPECT_EQ(2U, erasable.getStroke(&stroke).size());
+
+    // The part which was split off can be erased as well
+    range.reset(erasable.erase(280, 100, 5));
+    ASSERT_NE(nullptr, range);
+    EXPECT_LE(range->getX(), 275);
+    EXPECT_GE(range->getX2(), 285);
+
+    auto strokes = erasable.getStroke(&stroke);
+    ASSERT_EQ(3U, strokes.size());
+    EXPECT_DOUBLE_EQ(100, strokes[0]->getPoint(0).x);
+    EXPECT_GT(strokes[1]->getPoint(0).x, 200);
+    EXPECT_LT(strokes[1]->getPoint(1).x, 280);
+    EXPECT_DOUBLE_EQ(300, strokes[2]->getPoint(1).x);
+}
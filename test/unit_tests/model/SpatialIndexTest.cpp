@@ -0,0 +1,129 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "model/Layer.h"
+
+/**
+ * Element with a fixed bounding box
+ */
+class BoxElement: public Element {
+public:
+    BoxElement(double x, double y, double width, double height): Element(ELEMENT_IMAGE) {
+        this->x = x;
+        this->y = y;
+        this->width = width;
+        this->height = height;
+        this->sizeCalculated = true;
+    }
+
+    void scale(double x0, double y0, double fx, double fy, double rotation, bool restoreLineWidth) override {
+        this->width *= fx;
+        this->height *= fy;
+        boundsChanged();
+    }
+
+    void rotate(double x0, double y0, double th) override {}
+
+    Element* clone() override { return new BoxElement(this->x, this->y, this->width, this->height); }
+
+protected:
+    void calcSize() const override {}
+};
+
+TEST(SpatialIndex, testQueryArea) {
+    Layer layer;
+    auto* a = new BoxElement(10, 10, 20, 20);
+    auto* b = new BoxElement(500, 500, 20, 20);
+    auto* c = new BoxElement(0, 0, 2000, 2000);
+    layer.addElement(a);
+    layer.addElement(b);
+    layer.addElement(c);
+
+    EXPECT_EQ(std::vector<Element*>({a, c}), layer.getElementsInArea({0, 0, 50, 50}));
+    EXPECT_EQ(std::vector<Element*>({b, c}), layer.getElementsInArea({490, 490, 50, 50}));
+    EXPECT_EQ(std::vector<Element*>({a, b, c}), layer.getElementsInArea({-100, -100, 1000, 1000}));
+}
+
+TEST(SpatialIndex, testLayerOrder) {
+    Layer layer;
+    auto* a = new BoxElement(10, 10, 20, 20);
+    auto* b = new BoxElement(15, 15, 20, 20);
+    auto* c = new BoxElement(20, 20, 20, 20);
+    layer.addElement(a);
+    layer.addElement(c);
+    layer.insertElement(b, 1);
+
+    EXPECT_EQ(layer.getElements(), layer.getElementsInArea({0, 0, 100, 100}));
+
+    // Repeated inserts at the same position exhaust the gap between the order keys
+    for (int i = 0; i < 100; i++) {
+        auto* e = new BoxElement(12, 12, 5, 5);
+        layer.insertElement(e, 1);
+    }
+    EXPECT_EQ(layer.getElements(), layer.getElementsInArea({0, 0, 100, 100}));
+
+    layer.removeElement(b, true);
+    EXPECT_EQ(layer.getElements(), layer.getElementsInArea({0, 0, 100, 100}));
+}
+
+TEST(SpatialIndex, testElementMoved) {
+    Layer layer;
+    auto* a = new BoxElement(10, 10, 20, 20);
+    layer.addElement(a);
+
+    a->move(1000, 1000);
+    EXPECT_TRUE(layer.getElementsInArea({0, 0, 50, 50}).empty());
+    EXPECT_EQ(std::vector<Element*>({a}), layer.getElementsInArea({1000, 1000, 50, 50}));
+
+    a->scale(0, 0, 10, 10, 0, false);
+    EXPECT_EQ(std::vector<Element*>({a}), layer.getElementsInArea({1150, 1150, 10, 10}));
+}
+
+TEST(SpatialIndex, testElementOnTwoLayers) {
+    Layer lower;
+    Layer upper;
+    auto* a = new BoxElement(10, 10, 20, 20);
+    upper.addElement(a);
+    lower.addElement(a);
+
+    a->move(1000, 1000);
+    EXPECT_EQ(std::vector<Element*>({a}), upper.getElementsInArea({1000, 1000, 50, 50}));
+    EXPECT_EQ(std::vector<Element*>({a}), lower.getElementsInArea({1000, 1000, 50, 50}));
+
+    lower.removeElement(a, false);
+    EXPECT_TRUE(lower.getElementsInArea({1000, 1000, 50, 50}).empty());
+
+    a->move(-1000, -1000);
+    EXPECT_EQ(std::vector<Element*>({a}), upper.getElementsInArea({0, 0, 50, 50}));
+}
+
+TEST(SpatialIndex, testCopiedElement) {
+    Layer layer;
+    auto* a = new BoxElement(10, 10, 20, 20);
+    layer.addElement(a);
+
+    {
+        // A copy is not part of the layer
+        BoxElement copy(*a);
+        copy.move(1000, 1000);
+        EXPECT_TRUE(layer.getElementsInArea({1000, 1000, 50, 50}).empty());
+    }
+    EXPECT_EQ(std::vector<Element*>({a}), layer.getElementsInArea({0, 0, 50, 50}));
+
+    // An element which is assigned to stays part of the layer, at its new position
+    *a = BoxElement(500, 500, 20, 20);
+    EXPECT_TRUE(layer.getElementsInArea({0, 0, 50, 50}).empty());
+    EXPECT_EQ(std::vector<Element*>({a}), layer.getElementsInArea({490, 490, 50, 50}));
+}
@@ -0,0 +1,170 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "util/GeometryKernels.h"
+
+namespace geometry = xoj::util::geometry;
+
+/**
+ * Points on a spiral, odd counts to also test the remainders of the vectorized loops
+ */
+static void makeSpiral(size_t count, std::vector<double>& xs, std::vector<double>& ys) {
+    xs.clear();
+    ys.clear();
+    for (size_t i = 0; i < count; i++) {
+        double t = static_cast<double>(i) * 0.3;
+        xs.push_back(100 + t * std::cos(t));
+        ys.push_back(200 + t * std::sin(t));
+    }
+}
+
+TEST(UtilGeometryKernels, testBoundsAndMax) {
+    std::vector<double> xs, ys;
+    for (size_t count: {1U, 2U, 3U, 5U, 8U, 13U, 101U}) {
+        makeSpiral(count, xs, ys);
+
+        double minX = xs[0], maxX = xs[0], minY = ys[0], maxY = ys[0];
+        for (size_t i = 0; i < count; i++) {
+            minX = std::min(minX, xs[i]);
+            maxX = std::max(maxX, xs[i]);
+            minY = std::min(minY, ys[i]);
+            maxY = std::max(maxY, ys[i]);
+        }
+
+        auto b = geometry::bounds(xs.data(), ys.data(), count);
+        EXPECT_EQ(minX, b.minX);
+        EXPECT_EQ(maxX, b.maxX);
+        EXPECT_EQ(minY, b.minY);
+        EXPECT_EQ(maxY, b.maxY);
+
+        EXPECT_EQ(maxX, geometry::maxValue(xs.data(), count, 0.0));
+        EXPECT_EQ(1000.0, geometry::maxValue(xs.data(), count, 1000.0));
+    }
+}
+
+TEST(UtilGeometryKernels, testFindPointInRect) {
+    std::vector<double> xs, ys;
+    makeSpiral(57, xs, ys);
+
+    for (size_t expected: {0U, 1U, 3U, 4U, 7U, 56U}) {
+        double x = xs[expected];
+        double y = ys[expected];
+        EXPECT_EQ(expected, geometry::findPointInRect(xs.data(), ys.data(), xs.size(), x - 0.01, y - 0.01, x + 0.01,
+                                                      y + 0.01));
+    }
+
+    EXPECT_EQ(xs.size(), geometry::findPointInRect(xs.data(), ys.data(), xs.size(), 0, 0, 1, 1));
+    EXPECT_EQ(0U, geometry::findPointInRect(xs.data(), ys.data(), 0, 0, 0, 1, 1));
+}
+
+TEST(UtilGeometryKernels, testFindHitMatchesScalar) {
+    std::vector<double> xs, ys;
+    makeSpiral(37, xs, ys);
+    const size_t count = xs.size();
+
+    for (double halfSize: {0.05, 0.5, 2.0}) {
+        for (double x = 85; x <= 115; x += 0.7) {
+            for (double y = 185; y <= 215; y += 0.7) {
+                size_t expected = count;
+                for (size_t i = 0; i < count; i++) {
+                    bool inRect = xs[i] >= x - halfSize && ys[i] >= y - halfSize && xs[i] <= x + halfSize &&
+                                  ys[i] <= y + halfSize;
+                    if (inRect ||
+                        (i > 0 && geometry::segmentHit(xs[i - 1], ys[i - 1], xs[i], ys[i], x, y, halfSize, nullptr))) {
+                        expected = i;
+                        break;
+                    }
+                }
+                ASSERT_EQ(expected, geometry::findHit(xs.data(), ys.data(), count, x, y, halfSize));
+            }
+        }
+    }
+}
+
+TEST(UtilGeometryKernels, testSegmentHit) {
+    double distance = -1;
+    // Horizontal segment, eraser in the middle of it
+    EXPECT_TRUE(geometry::segmentHit(0, 0, 10, 0, 5, 0.5, 1, &distance));
+    EXPECT_LT(distance, 5.1);
+
+    // Too far from the line
+    EXPECT_FALSE(geometry::segmentHit(0, 0, 10, 0, 5, 1.5, 1, nullptr));
+
+    // On the line, but far behind the end of the segment
+    EXPECT_FALSE(geometry::segmentHit(0, 0, 10, 0, 20, 0, 1, nullptr));
+
+    // Segments shorter than the eraser are only hit by their end points
+    EXPECT_FALSE(geometry::segmentHit(0, 0, 0.5, 0, 0.25, 0, 1, nullptr));
+}
+
+TEST(UtilGeometryKernels, testTransform) {
+    std::vector<double> xs, ys;
+    makeSpiral(11, xs, ys);
+    auto origX = xs;
+    auto origY = ys;
+
+    geometry::transform(xs.data(), ys.data(), xs.size(), 0, 1, -1, 0, 3, 4);
+    for (size_t i = 0; i < xs.size(); i++) {
+        EXPECT_DOUBLE_EQ(-origY[i] + 3, xs[i]);
+        EXPECT_DOUBLE_EQ(origX[i] + 4, ys[i]);
+    }
+
+    geometry::translate(xs.data(), ys.data(), xs.size(), -3, -4);
+    for (size_t i = 0; i < xs.size(); i++) {
+        EXPECT_DOUBLE_EQ(-origY[i], xs[i]);
+        EXPECT_DOUBLE_EQ(origX[i], ys[i]);
+    }
+}
+
+TEST(UtilGeometryKernels, testSimplify) {
+    // Dense points on a line with a corner
+    std::vector<double> xs, ys;
+    for (int i = 0; i <= 100; i++) {
+        xs.push_back(i * 0.1);
+        ys.push_back(0);
+    }
+    for (int i = 1; i <= 100; i++) {
+        xs.push_back(10);
+        ys.push_back(i * 0.1);
+    }
+
+    std::vector<size_t> kept = geometry::simplify(xs.data(), ys.data(), xs.size(), 0.5);
+    ASSERT_EQ(3U, kept.size());
+    EXPECT_EQ(0U, kept[0]);
+    EXPECT_EQ(100U, kept[1]);
+    EXPECT_EQ(200U, kept[2]);
+
+    // Every dropped point is close to the simplified polyline
+    makeSpiral(501, xs, ys);
+    kept = geometry::simplify(xs.data(), ys.data(), xs.size(), 0.25);
+    EXPECT_LT(kept.size(), xs.size());
+    EXPECT_EQ(0U, kept.front());
+    EXPECT_EQ(xs.size() - 1, kept.back());
+    for (size_t k = 0; k + 1 < kept.size(); k++) {
+        for (size_t i = kept[k] + 1; i < kept[k + 1]; i++) {
+            double dx = xs[kept[k + 1]] - xs[kept[k]];
+            double dy = ys[kept[k + 1]] - ys[kept[k]];
+            double t = std::clamp(((xs[i] - xs[kept[k]]) * dx + (ys[i] - ys[kept[k]]) * dy) / (dx * dx + dy * dy),
+                                  0.0, 1.0);
+            double distance = std::hypot(xs[kept[k]] + t * dx - xs[i], ys[kept[k]] + t * dy - ys[i]);
+            EXPECT_LE(distance, 0.5);
+        }
+    }
+
+    EXPECT_EQ(1U, geometry::simplify(xs.data(), ys.data(), 1, 1).size());
+    EXPECT_TRUE(geometry::simplify(xs.data(), ys.data(), 0, 1).empty());
+}
@@ -0,0 +1,70 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <algorithm>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <zlib.h>
+
+#include "util/GzUtil.h"
+#include "util/OutputStream.h"
+#include "util/PathUtil.h"
+
+static auto readGzFile(const fs::path& file) -> std::string {
+    gzFile fp = GzUtil::openPath(file, "r");
+    EXPECT_NE(nullptr, fp);
+
+    std::string content;
+    char buffer[4096];
+    int len = 0;
+    while ((len = gzread(fp, buffer, sizeof(buffer))) > 0) { content.append(buffer, static_cast<size_t>(len)); }
+    gzclose(fp);
+    return content;
+}
+
+TEST(GzOutputStream, testMultipleBlocks) {
+    // Several compression blocks, written in small fragments
+    std::string expected;
+    for (int i = 0; expected.size() < 5 * 1024 * 1024; i++) {
+        expected += std::to_string(i * 0.37);
+        expected += i % 10 ? " " : "\n";
+    }
+
+    auto file = Util::getTmpDirSubfolder() / "GzOutputStreamTest.gz";
+    GzOutputStream out(file, Z_BEST_SPEED);
+    ASSERT_TRUE(out.getLastError().empty());
+    for (size_t pos = 0; pos < expected.size(); pos += 100) {
+        out.write(expected.data() + pos, static_cast<int>(std::min<size_t>(100, expected.size() - pos)));
+    }
+    out.close();
+
+    EXPECT_TRUE(out.getLastError().empty());
+    EXPECT_EQ(expected, readGzFile(file));
+}
+
+TEST(GzOutputStream, testEmpty) {
+    auto file = Util::getTmpDirSubfolder() / "GzOutputStreamTestEmpty.gz";
+    {
+        GzOutputStream out(file);
+        ASSERT_TRUE(out.getLastError().empty());
+    }
+
+    // Still a valid gzip file
+    gzFile fp = GzUtil::openPath(file, "r");
+    ASSERT_NE(nullptr, fp);
+    char buffer[16];
+    EXPECT_EQ(0, gzread(fp, buffer, sizeof(buffer)));
+    int err = Z_OK;
+    gzerror(fp, &err);
+    EXPECT_EQ(Z_OK, err);
+    gzclose(fp);
+}
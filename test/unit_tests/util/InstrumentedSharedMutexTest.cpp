@@ -0,0 +1,62 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <chrono>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "util/InstrumentedSharedMutex.h"
+
+TEST(InstrumentedSharedMutex, testSharedReaders) {
+    InstrumentedSharedMutex mutex;
+
+    // Several readers at the same time, no contention
+    std::shared_lock<InstrumentedSharedMutex> reader1(mutex);
+    std::shared_lock<InstrumentedSharedMutex> reader2(mutex);
+    EXPECT_FALSE(mutex.try_lock());
+    reader1.unlock();
+    reader2.unlock();
+
+    {
+        std::unique_lock<InstrumentedSharedMutex> writer(mutex);
+        EXPECT_FALSE(mutex.try_lock_shared());
+    }
+
+    LockStatistics stats = mutex.getStatistics();
+    EXPECT_EQ(2U, stats.sharedLocks);
+    EXPECT_EQ(1U, stats.exclusiveLocks);
+    EXPECT_EQ(0U, stats.sharedContended);
+    EXPECT_EQ(0U, stats.exclusiveContended);
+}
+
+TEST(InstrumentedSharedMutex, testContention) {
+    InstrumentedSharedMutex mutex;
+
+    mutex.lock();
+    std::thread reader([&]() {
+        mutex.lock_shared();
+        mutex.unlock_shared();
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    mutex.unlock();
+    reader.join();
+
+    LockStatistics stats = mutex.getStatistics();
+    EXPECT_EQ(1U, stats.sharedLocks);
+    EXPECT_EQ(1U, stats.sharedContended);
+    EXPECT_GT(stats.sharedWaitNs, 0U);
+
+    mutex.resetStatistics();
+    EXPECT_EQ(0U, mutex.getStatistics().sharedLocks);
+}
@@ -0,0 +1,56 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "util/NumberParser.h"
+
+using xoj::util::parseDoubles;
+
+static auto parse(const char* text, std::vector<double>& out) -> size_t {
+    const char* end = text + std::strlen(text);
+    return static_cast<size_t>(parseDoubles(text, end, out) - text);
+}
+
+TEST(UtilNumberParser, testNumbers) {
+    std::vector<double> values;
+    EXPECT_EQ(25U, parse(" 1 -2.5\n+3e2\t0.125 1E-3  ", values));
+    ASSERT_EQ(5U, values.size());
+    EXPECT_DOUBLE_EQ(1, values[0]);
+    EXPECT_DOUBLE_EQ(-2.5, values[1]);
+    EXPECT_DOUBLE_EQ(300, values[2]);
+    EXPECT_DOUBLE_EQ(0.125, values[3]);
+    EXPECT_DOUBLE_EQ(0.001, values[4]);
+}
+
+TEST(UtilNumberParser, testStopsAtText) {
+    std::vector<double> values;
+    EXPECT_EQ(4U, parse("1 2 x 3", values));
+    ASSERT_EQ(2U, values.size());
+    EXPECT_DOUBLE_EQ(2, values[1]);
+}
+
+TEST(UtilNumberParser, testOutOfRange) {
+    // Parsed like strtod: huge values are infinite, tiny values denormal or 0
+    std::vector<double> values;
+    EXPECT_EQ(37U, parse("1e400 -1e400 4.9e-324 1e-400 2.5e-310", values));
+    ASSERT_EQ(5U, values.size());
+    EXPECT_EQ(HUGE_VAL, values[0]);
+    EXPECT_EQ(-HUGE_VAL, values[1]);
+    EXPECT_DOUBLE_EQ(4.9e-324, values[2]);
+    EXPECT_GT(values[2], 0);
+    EXPECT_EQ(0, values[3]);
+    EXPECT_DOUBLE_EQ(2.5e-310, values[4]);
+}
@@ -0,0 +1,81 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <cstdint>
+
+#include <cairo.h>
+#include <gtest/gtest.h>
+
+#include "view/background/BackgroundTileCache.h"
+
+namespace {
+auto alphaAt(cairo_surface_t* surface, int x, int y) -> uint32_t {
+    cairo_surface_flush(surface);
+    auto* row = reinterpret_cast<uint32_t*>(cairo_image_surface_get_data(surface) +
+                                            y * cairo_image_surface_get_stride(surface));
+    return row[x] >> 24;
+}
+}  // namespace
+
+TEST(BackgroundTileCache, testTileScale) {
+    cairo_surface_t* image = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 10, 10);
+    cairo_t* cr = cairo_create(image);
+    cairo_scale(cr, 2, 2);
+    EXPECT_DOUBLE_EQ(2, BackgroundTileCache::tileScale(cr));
+
+    cairo_rotate(cr, 1);
+    EXPECT_EQ(0, BackgroundTileCache::tileScale(cr));
+    cairo_destroy(cr);
+    cairo_surface_destroy(image);
+
+    // Vector output is not rasterized
+    cairo_surface_t* recording = cairo_recording_surface_create(CAIRO_CONTENT_COLOR_ALPHA, nullptr);
+    cr = cairo_create(recording);
+    EXPECT_EQ(0, BackgroundTileCache::tileScale(cr));
+    cairo_destroy(cr);
+    cairo_surface_destroy(recording);
+}
+
+TEST(BackgroundTileCache, testRepeatedLines) {
+    BackgroundTileCache::Key key;
+    key.name = "test-lines";
+    key.periodX = 10;
+    key.periodY = 10;
+    key.lineWidth = 2;
+    key.scale = 1;
+
+    int draws = 0;
+    auto draw = [&draws](cairo_t* tile) {
+        draws++;
+        cairo_set_source_rgb(tile, 0, 0, 0);
+        cairo_set_line_width(tile, 2);
+        cairo_move_to(tile, -10, 5);
+        cairo_line_to(tile, 20, 5);
+        cairo_stroke(tile);
+    };
+
+    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 20, 60);
+    cairo_t* cr = cairo_create(surface);
+    BackgroundTileCache::getInstance().paint(cr, key, 0, 10, 20, 40, draw);
+
+    // The tile has at least MIN_TILE_PIXELS, it contains several periods
+    EXPECT_EQ(4, draws);
+
+    for (int y: {14, 15, 24, 25, 34, 35, 44, 45}) { EXPECT_EQ(255U, alphaAt(surface, 7, y)) << "y = " << y; }
+    for (int y: {5, 10, 12, 17, 20, 50, 55}) { EXPECT_EQ(0U, alphaAt(surface, 7, y)) << "y = " << y; }
+
+    // The tile is reused
+    BackgroundTileCache::getInstance().paint(cr, key, 0, 10, 20, 40, draw);
+    EXPECT_EQ(4, draws);
+
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface);
+}
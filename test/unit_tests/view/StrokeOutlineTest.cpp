@@ -0,0 +1,84 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <vector>
+
+#include <cairo.h>
+#include <gtest/gtest.h>
+
+#include "view/StrokeOutline.h"
+
+namespace {
+/**
+ * Calls check with a context containing the outline as current path
+ */
+template <typename Check>
+void withOutline(const std::vector<cairo_path_data_t>& data, Check check) {
+    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_A8, 1, 1);
+    cairo_t* cr = cairo_create(surface);
+    cairo_path_t path{CAIRO_STATUS_SUCCESS, const_cast<cairo_path_data_t*>(data.data()), static_cast<int>(data.size())};
+    cairo_set_fill_rule(cr, CAIRO_FILL_RULE_WINDING);
+    cairo_append_path(cr, &path);
+    check(cr);
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface);
+}
+}  // namespace
+
+TEST(StrokeOutline, testVariableWidth) {
+    // Right, then down, the first segment is thinner
+    double xs[] = {0, 10, 10};
+    double ys[] = {0, 0, 10};
+    double widths[] = {2, 4, 4};
+    std::vector<cairo_path_data_t> data;
+    StrokeOutline::build(xs, ys, widths, 3, StrokeCapStyle::ROUND, nullptr, 0, data);
+
+    withOutline(data, [](cairo_t* cr) {
+        EXPECT_TRUE(cairo_in_fill(cr, 5, 0.9));
+        EXPECT_FALSE(cairo_in_fill(cr, 5, 1.1));
+        EXPECT_TRUE(cairo_in_fill(cr, 11.9, 5));
+        EXPECT_FALSE(cairo_in_fill(cr, 12.1, 5));
+        // Round join at the outer corner and round caps
+        EXPECT_TRUE(cairo_in_fill(cr, 11.3, -1.3));
+        EXPECT_FALSE(cairo_in_fill(cr, 11.6, -1.6));
+        EXPECT_TRUE(cairo_in_fill(cr, -0.9, 0));
+        EXPECT_TRUE(cairo_in_fill(cr, 10, 11.9));
+    });
+}
+
+TEST(StrokeOutline, testDashes) {
+    double xs[] = {0, 10};
+    double ys[] = {0, 0};
+    double widths[] = {2, 2};
+    double dashes[] = {3, 2};
+    std::vector<cairo_path_data_t> data;
+    StrokeOutline::build(xs, ys, widths, 2, StrokeCapStyle::BUTT, dashes, 2, data);
+
+    withOutline(data, [](cairo_t* cr) {
+        EXPECT_TRUE(cairo_in_fill(cr, 1, 0));
+        EXPECT_FALSE(cairo_in_fill(cr, 4, 0));
+        EXPECT_TRUE(cairo_in_fill(cr, 6, 0));
+        EXPECT_FALSE(cairo_in_fill(cr, 9, 0));
+    });
+}
+
+TEST(StrokeOutline, testDot) {
+    double xs[] = {5, 5};
+    double ys[] = {5, 5};
+    double widths[] = {2, 2};
+    std::vector<cairo_path_data_t> data;
+    StrokeOutline::build(xs, ys, widths, 2, StrokeCapStyle::ROUND, nullptr, 0, data);
+
+    withOutline(data, [](cairo_t* cr) {
+        EXPECT_TRUE(cairo_in_fill(cr, 5.5, 5.5));
+        EXPECT_FALSE(cairo_in_fill(cr, 5.9, 5.9));
+    });
+}
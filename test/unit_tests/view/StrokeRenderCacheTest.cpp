@@ -0,0 +1,66 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <memory>
+
+#include <cairo.h>
+#include <gtest/gtest.h>
+
+#include "model/Stroke.h"
+#include "view/StrokeRenderCache.h"
+
+TEST(StrokeRenderCache, testPath) {
+    Stroke s;
+    s.addPoint(Point(1, 2));
+    s.addPoint(Point(3, 4));
+    s.addPoint(Point(5, 6));
+
+    std::shared_ptr<const StrokeRenderCache> cache = StrokeRenderCache::get(&s);
+    EXPECT_EQ(cache, StrokeRenderCache::get(&s));
+
+    // Appending the cached path gives the same path as drawing the points one by one
+    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_A8, 1, 1);
+    cairo_t* cr = cairo_create(surface);
+    cairo_append_path(cr, cache->getPath());
+    cairo_path_t* path = cairo_copy_path(cr);
+    ASSERT_EQ(6, path->num_data);
+    EXPECT_EQ(CAIRO_PATH_MOVE_TO, path->data[0].header.type);
+    EXPECT_EQ(CAIRO_PATH_LINE_TO, path->data[4].header.type);
+    EXPECT_DOUBLE_EQ(5, path->data[5].point.x);
+    EXPECT_DOUBLE_EQ(6, path->data[5].point.y);
+    cairo_path_destroy(path);
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface);
+
+    // Changes of the geometry drop the cache
+    s.move(1, 1);
+    EXPECT_EQ(nullptr, s.getRenderCache());
+    EXPECT_DOUBLE_EQ(6, StrokeRenderCache::get(&s)->getPath()->data[5].point.x);
+}
+
+TEST(StrokeRenderCache, testLevelOfDetail) {
+    // A straight line with a point every 0.1
+    Stroke s;
+    for (int i = 0; i <= 1000; i++) { s.addPoint(Point(i * 0.1, 5)); }
+
+    std::shared_ptr<const StrokeRenderCache> cache = StrokeRenderCache::get(&s);
+    EXPECT_EQ(2 * 1001, cache->getPath()->num_data);
+    EXPECT_EQ(cache->getPath(), cache->getPath(StrokeRenderCache::LOD_MAX_SCALE));
+
+    // Zoomed out only the end points are needed
+    const cairo_path_t* lod = cache->getPath(0.1);
+    ASSERT_EQ(4, lod->num_data);
+    EXPECT_DOUBLE_EQ(0, lod->data[1].point.x);
+    EXPECT_DOUBLE_EQ(100, lod->data[3].point.x);
+
+    // Scales in the same bucket share the simplified path
+    EXPECT_EQ(lod, cache->getPath(0.09));
+}
@@ -0,0 +1,48 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include "model/Text.h"
+#include "view/TextLayoutCache.h"
+
+TEST(TextLayoutCache, testInvalidation) {
+    Text t;
+    t.setText("Hello");
+
+    // The size is measured once, when the text is set
+    std::shared_ptr<const TextLayoutCache> cache = t.getLayoutCache();
+    ASSERT_TRUE(cache);
+    EXPECT_EQ(cache, TextLayoutCache::get(&t));
+
+    double width = 0;
+    double height = 0;
+    cache->getSize(width, height);
+    EXPECT_DOUBLE_EQ(t.getElementWidth(), width);
+    EXPECT_DOUBLE_EQ(t.getElementHeight(), height);
+
+    t.setText("Hello World");
+    EXPECT_NE(cache, TextLayoutCache::get(&t));
+    cache = TextLayoutCache::get(&t);
+
+    // A font changed in place is detected
+    t.getFont().setSize(30);
+    std::shared_ptr<const TextLayoutCache> larger = TextLayoutCache::get(&t);
+    EXPECT_NE(cache, larger);
+
+    double largerWidth = 0;
+    double largerHeight = 0;
+    larger->getSize(largerWidth, largerHeight);
+    cache->getSize(width, height);
+    EXPECT_GT(largerHeight, height);
+}